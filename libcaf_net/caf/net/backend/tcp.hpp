@@ -25,6 +25,7 @@
 #include "caf/error.hpp"
 #include "caf/expected.hpp"
 #include "caf/net/basp/application.hpp"
+#include "caf/net/basp/worker_pool.hpp"
 #include "caf/net/fwd.hpp"
 #include "caf/net/make_endpoint_manager.hpp"
 #include "caf/net/middleman.hpp"
@@ -75,8 +76,8 @@ public:
     using transport_type = stream_transport<basp::application>;
     if (auto err = nonblocking(socket_handle, true))
       return err;
-    auto mpx = mm_.mpx();
-    basp::application app{proxies_};
+    auto mpx = mm_.next_mpx();
+    basp::application app{proxies_, &workers_};
     auto mgr = make_endpoint_manager(
       mpx, mm_.system(), transport_type{socket_handle, std::move(app)});
     if (auto err = mgr->init()) {
@@ -104,6 +105,10 @@ private:
 
   proxy_registry proxies_;
 
+  /// Deserializes messages for all connections. Must go out of scope before
+  /// `proxies_`, because busy workers may still access the registry.
+  basp::worker_pool workers_;
+
   uint16_t listening_port_;
 
   std::mutex lock_;
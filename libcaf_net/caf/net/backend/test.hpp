@@ -21,6 +21,7 @@
 #include <map>
 
 #include "caf/detail/net_export.hpp"
+#include "caf/net/basp/worker_pool.hpp"
 #include "caf/net/endpoint_manager.hpp"
 #include "caf/net/fwd.hpp"
 #include "caf/net/middleman_backend.hpp"
@@ -78,6 +79,10 @@ private:
   std::map<node_id, peer_entry> peers_;
 
   proxy_registry proxies_;
+
+  /// Deserializes messages for all connections. Must go out of scope before
+  /// `proxies_`, because busy workers may still access the registry.
+  basp::worker_pool workers_;
 };
 
 } // namespace caf::net::backend
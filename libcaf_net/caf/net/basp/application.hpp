@@ -26,28 +26,33 @@
 #include <vector>
 
 #include "caf/actor_addr.hpp"
+#include "caf/actor_clock.hpp"
 #include "caf/actor_system.hpp"
 #include "caf/actor_system_config.hpp"
 #include "caf/byte.hpp"
 #include "caf/callback.hpp"
 #include "caf/defaults.hpp"
 #include "caf/detail/net_export.hpp"
-#include "caf/detail/worker_hub.hpp"
 #include "caf/error.hpp"
 #include "caf/fwd.hpp"
+#include "caf/logger.hpp"
 #include "caf/net/basp/connection_state.hpp"
 #include "caf/net/basp/constants.hpp"
 #include "caf/net/basp/header.hpp"
 #include "caf/net/basp/message_queue.hpp"
 #include "caf/net/basp/message_type.hpp"
 #include "caf/net/basp/worker.hpp"
+#include "caf/net/basp/worker_pool.hpp"
+#include "caf/net/defaults.hpp"
 #include "caf/net/endpoint_manager.hpp"
+#include "caf/net/network_socket.hpp"
 #include "caf/net/packet_writer.hpp"
 #include "caf/net/receive_policy.hpp"
 #include "caf/node_id.hpp"
 #include "caf/proxy_registry.hpp"
 #include "caf/response_promise.hpp"
 #include "caf/scoped_execution_unit.hpp"
+#include "caf/timespan.hpp"
 #include "caf/unit.hpp"
 
 namespace caf::net::basp {
@@ -59,13 +64,98 @@ public:
 
   using byte_span = span<const byte>;
 
-  using hub_type = detail::worker_hub<worker>;
-
   struct test_tag {};
 
+  /// Summarizes payload compression on this connection.
+  struct compression_stats {
+    /// Number of messages sent in compressed form.
+    size_t compressed_messages = 0;
+
+    /// Sum of the original payload sizes of all compressed messages.
+    size_t uncompressed_bytes = 0;
+
+    /// Sum of the compressed payload sizes of all compressed messages.
+    size_t compressed_bytes = 0;
+
+    /// Time spent compressing, including payloads that did not shrink.
+    timespan compression_time{0};
+
+    /// Number of received messages in compressed form.
+    size_t decompressed_messages = 0;
+
+    /// Time spent decompressing.
+    timespan decompression_time{0};
+
+    /// Returns the ratio between compressed and original sizes.
+    double ratio() const noexcept {
+      return uncompressed_bytes > 0 ? static_cast<double>(compressed_bytes)
+                                        / uncompressed_bytes
+                                    : 1.0;
+    }
+  };
+
+  /// Summarizes how this connection dispatches received actor messages.
+  struct dispatch_stats {
+    /// Number of messages deserialized on the I/O thread.
+    size_t inline_messages = 0;
+
+    /// Sum of the payload sizes of all messages deserialized on the I/O
+    /// thread.
+    size_t inline_bytes = 0;
+
+    /// Time spent deserializing messages on the I/O thread.
+    timespan inline_time{0};
+
+    /// Number of messages above the inline threshold that we deserialized on
+    /// the I/O thread, because the worker pool was exhausted.
+    size_t fallback_messages = 0;
+
+    /// Number of messages passed to a BASP worker.
+    size_t offloaded_messages = 0;
+
+    /// Sum of the payload sizes of all messages passed to a BASP worker.
+    size_t offloaded_bytes = 0;
+  };
+
+  /// Summarizes heartbeats and round-trip times on this connection.
+  struct heartbeat_stats {
+    /// Number of heartbeats sent to the peer.
+    size_t sent_heartbeats = 0;
+
+    /// Number of answers to our heartbeats.
+    size_t received_replies = 0;
+
+    /// Round-trip time of the last answered heartbeat.
+    timespan last_rtt{0};
+
+    /// Smoothed round-trip time.
+    timespan smoothed_rtt{0};
+
+    /// Smoothed mean deviation of the round-trip time.
+    timespan rtt_variance{0};
+  };
+
+  // -- constants --------------------------------------------------------------
+
+  /// Lower bound for the inline threshold when adapting it to the measured
+  /// deserialization time. Keeps small messages on the I/O thread, which
+  /// also keeps the measurements coming.
+  static constexpr size_t min_inline_threshold = 64;
+
+  /// Number of new actors that we send as inline definitions while the
+  /// interning table is full before scanning it for terminated actors again.
+  static constexpr size_t interned_purge_interval = 256;
+
+  /// Type tag of the timeout for sending heartbeats.
+  static constexpr const char* heartbeat_timeout_tag = "basp.heartbeat";
+
   // -- constructors, destructors, and assignment operators --------------------
 
-  explicit application(proxy_registry& proxies);
+  /// Constructs a BASP application that dispatches received messages to
+  /// `workers`. Creates a worker pool for this connection alone when passing
+  /// `nullptr`.
+  explicit application(proxy_registry& proxies,
+                       worker_pool* workers = nullptr);
 
   // -- static utility functions -----------------------------------------------
 
@@ -80,20 +170,33 @@ public:
   error init(Parent& parent) {
     // Initialize member variables.
     system_ = &parent.system();
+    max_batch_size_ = get_or(system_->config(), "middleman.basp-max-batch-size",
+                             defaults::middleman::basp_max_batch_size);
+    compression_threshold_ = get_or(
+      system_->config(), "middleman.basp-compression-threshold",
+      defaults::middleman::basp_compression_threshold);
+    max_inline_threshold_ = get_or(system_->config(),
+                                   "middleman.basp-inline-threshold",
+                                   defaults::middleman::basp_inline_threshold);
+    inline_threshold_ = max_inline_threshold_;
+    inline_budget_ = get_or(system_->config(), "middleman.basp-inline-budget",
+                            defaults::middleman::basp_inline_budget);
+    heartbeat_interval_ = get_or(system_->config(),
+                                 "middleman.heartbeat-interval",
+                                 defaults::middleman::heartbeat_interval);
+    connection_timeout_ = get_or(system_->config(),
+                                 "middleman.connection-timeout",
+                                 defaults::middleman::connection_timeout);
     executor_.system_ptr(system_);
     executor_.proxy_registry_ptr(&proxies_);
     // TODO: use `if constexpr` when switching to C++17.
     // Allow unit tests to run the application without endpoint manager.
     if (!std::is_base_of<test_tag, Parent>::value)
       manager_ = &parent.manager();
-    size_t workers;
-    if (auto workers_cfg = get_if<size_t>(&system_->config(),
-                                          "middleman.workers"))
-      workers = *workers_cfg;
-    else
-      workers = std::min(3u, std::thread::hardware_concurrency() / 4u) + 1;
-    for (size_t i = 0; i < workers; ++i)
-      hub_->add_new_worker(*queue_, proxies_);
+    if (workers_ == nullptr) {
+      own_workers_ = std::make_unique<worker_pool>(*system_);
+      workers_ = own_workers_.get();
+    }
     // Write handshake.
     auto hdr = parent.next_header_buffer();
     auto payload = parent.next_payload_buffer();
@@ -114,13 +217,44 @@ public:
   error handle_data(Parent& parent, byte_span bytes) {
     static_assert(std::is_base_of<packet_writer, Parent>::value,
                   "parent must implement packet_writer");
+    got_input_ = true;
     size_t next_read_size = header_size;
     if (auto err = handle(next_read_size, parent, bytes))
       return err;
+    // Start sending heartbeats after the handshake. We can't schedule the
+    // first timeout in `init`, because it may run outside of the multiplexer.
+    if (!heartbeats_started_ && state_ == connection_state::await_header
+        && heartbeat_interval_ > timespan{0}) {
+      heartbeats_started_ = true;
+      last_input_ = actor_clock::clock_type::now();
+      parent.set_timeout(last_input_ + heartbeat_interval_,
+                         heartbeat_timeout_tag);
+    }
     parent.transport().configure_read(receive_policy::exactly(next_read_size));
     return none;
   }
 
+  /// Like `handle_data`, but allows the application to take ownership of
+  /// `bytes`. Passes the payload of actor messages to a worker without
+  /// copying it.
+  template <class Parent>
+  error handle_owned_data(Parent& parent, byte_buffer& bytes) {
+    static_assert(std::is_base_of<packet_writer, Parent>::value,
+                  "parent must implement packet_writer");
+    if (state_ != connection_state::await_payload
+        || (hdr_.type != message_type::actor_message
+            && hdr_.type != message_type::interned_actor_message))
+      return handle_data(parent, byte_span{bytes});
+    if (bytes.size() != hdr_.payload_len)
+      return ec::unexpected_number_of_bytes;
+    got_input_ = true;
+    state_ = connection_state::await_header;
+    if (auto err = handle_actor_message(parent, hdr_, bytes, &bytes))
+      return err;
+    parent.transport().configure_read(receive_policy::exactly(header_size));
+    return none;
+  }
+
   void resolve(packet_writer& writer, string_view path, const actor& listener);
 
   static void new_proxy(packet_writer& writer, actor_id id);
@@ -128,10 +262,24 @@ public:
   void local_actor_down(packet_writer& writer, actor_id id, error reason);
 
   template <class Parent>
-  void timeout(Parent&, const std::string&, uint64_t) {
-    // nop
+  void timeout(Parent& parent, const std::string& tag, uint64_t) {
+    if (tag != heartbeat_timeout_tag)
+      return;
+    auto now = actor_clock::clock_type::now();
+    if (auto err = heartbeat(parent, now)) {
+      CAF_LOG_WARNING("close connection to" << peer_id_ << ":" << err);
+      // The next read on the socket fails, which removes the connection.
+      shutdown(parent.transport().handle());
+      return;
+    }
+    parent.set_timeout(now + heartbeat_interval_, heartbeat_timeout_tag);
   }
 
+  /// Sends a heartbeat with the timestamp `now` to the peer.
+  /// @returns `ec::connection_timeout` if the peer answers heartbeats but did
+  ///          not send any data for longer than the configured timeout.
+  error heartbeat(packet_writer& writer, actor_clock::time_point now);
+
   void handle_error(sec) {
     // nop
   }
@@ -150,6 +298,45 @@ public:
     return *system_;
   }
 
+  /// Returns the capabilities that this node announces in its handshake.
+  uint64_t local_capabilities() const noexcept;
+
+  /// Returns the capabilities that both nodes support. Only valid after
+  /// receiving the handshake of the peer.
+  uint64_t capabilities() const noexcept {
+    return capabilities_;
+  }
+
+  const compression_stats& compression_statistics() const noexcept {
+    return compression_stats_;
+  }
+
+  const dispatch_stats& dispatch_statistics() const noexcept {
+    return dispatch_stats_;
+  }
+
+  const heartbeat_stats& heartbeat_statistics() const noexcept {
+    return heartbeat_stats_;
+  }
+
+  /// Returns the smoothed round-trip time to the peer or 0 if the peer did
+  /// not answer any heartbeat yet.
+  timespan smoothed_rtt() const noexcept {
+    return heartbeat_stats_.smoothed_rtt;
+  }
+
+  /// Returns the current maximum payload size for deserializing actor
+  /// messages on the I/O thread.
+  size_t inline_threshold() const noexcept {
+    return inline_threshold_;
+  }
+
+  // -- dispatching of incoming messages ---------------------------------------
+
+  /// Updates the statistics and the inline threshold after deserializing a
+  /// message of `size` bytes on the I/O thread in `elapsed` time.
+  void record_inline_dispatch(size_t size, timespan elapsed);
+
 private:
   // -- handling of incoming messages ------------------------------------------
 
@@ -159,8 +346,32 @@ private:
 
   error handle_handshake(packet_writer& writer, header hdr, byte_span payload);
 
+  /// Dispatches an actor message to a worker. If `owner` is not null, it
+  /// contains `payload` and the worker takes ownership of the buffer.
   error handle_actor_message(packet_writer& writer, header hdr,
-                             byte_span payload);
+                             byte_span payload, byte_buffer* owner = nullptr);
+
+  error handle_actor_message_batch(packet_writer& writer, header hdr,
+                                   byte_span payload);
+
+  /// Reads the source and destination actor IDs from the routing information
+  /// of an `actor_message` for picking its ordering key. Skips the node ID of
+  /// the sender without deserializing it if the sender runs on our peer.
+  error read_actor_ids(byte_span payload, actor_id& src_id, actor_id& dst_id);
+
+  /// Reads the reference to the sender of an `interned_actor_message`.
+  error read_interned_source(binary_deserializer& source,
+                             strong_actor_ptr& src);
+
+  error handle_compressed_message(packet_writer& writer, header hdr,
+                                  byte_span payload);
+
+  /// Answers heartbeats of the peer and measures the round-trip time of our
+  /// own heartbeats.
+  error handle_heartbeat(packet_writer& writer, header hdr);
+
+  /// Updates the round-trip time estimates as described in RFC 6298.
+  void record_rtt(timespan rtt);
 
   error handle_resolve_request(packet_writer& writer, header rec_hdr,
                                byte_span received);
@@ -177,6 +388,45 @@ private:
   /// Writes the handshake payload to `buf_`.
   error generate_handshake(byte_buffer& buf);
 
+  // -- writing of outgoing messages -------------------------------------------
+
+  /// Serializes the routing information and the content of `msg`.
+  error serialize(binary_serializer& sink,
+                  const endpoint_manager_queue::message& msg);
+
+  /// Writes a reference to `src`, defining it first if necessary. Stores the
+  /// reference of a new definition in `new_ref` without interning `src`,
+  /// because the remainder of the message may still fail to serialize.
+  error write_interned_source(binary_serializer& sink,
+                              const strong_actor_ptr& src, uint32_t& new_ref);
+
+  /// Returns the next free reference for interning an actor or 0 if the table
+  /// is full. Frees the references of terminated actors when running out of
+  /// references.
+  uint32_t next_interned_ref();
+
+  /// Assigns `ref` to `src` after successfully sending its definition.
+  void intern(const strong_actor_ptr& src, uint32_t ref);
+
+  /// Returns whether we send actor messages as `interned_actor_message`.
+  bool interning() const noexcept {
+    return (capabilities_ & interning_capability) != 0;
+  }
+
+  /// Packs `first`, `second` and further messages from the queue of the
+  /// endpoint manager into a single `actor_message_batch` frame. Skips
+  /// messages without receiver.
+  /// @returns the first serialization error after writing all other
+  ///          messages, `none` otherwise.
+  error write_batch(packet_writer& writer,
+                    endpoint_manager_queue::message_ptr first,
+                    endpoint_manager_queue::message_ptr second);
+
+  /// Writes an actor message or batch, compressing `payload` if enabled and
+  /// worthwhile.
+  void write_actor_frame(packet_writer& writer, header hdr,
+                         byte_buffer& payload);
+
   // -- member variables -------------------------------------------------------
 
   /// Stores a pointer to the parent actor system.
@@ -191,6 +441,75 @@ private:
   /// Stores the ID of our peer.
   node_id peer_id_;
 
+  /// Stores `peer_id_` in serialized form.
+  byte_buffer peer_id_bytes_;
+
+  /// Stores the capabilities that both nodes support.
+  uint64_t capabilities_ = 0;
+
+  /// Configures how many bytes we pack into a single batch frame at most.
+  size_t max_batch_size_ = defaults::middleman::basp_max_batch_size;
+
+  /// Configures the minimum payload size for compressing actor messages.
+  size_t compression_threshold_
+    = defaults::middleman::basp_compression_threshold;
+
+  /// Collects statistics on payload compression.
+  compression_stats compression_stats_;
+
+  /// Configures the maximum payload size for deserializing actor messages on
+  /// the I/O thread.
+  size_t max_inline_threshold_ = defaults::middleman::basp_inline_threshold;
+
+  /// Stores the current maximum payload size for deserializing actor
+  /// messages on the I/O thread.
+  size_t inline_threshold_ = defaults::middleman::basp_inline_threshold;
+
+  /// Configures the target time for deserializing on the I/O thread.
+  timespan inline_budget_ = defaults::middleman::basp_inline_budget;
+
+  /// Smoothed deserialization time per byte in nanoseconds.
+  double inline_cost_ = 0;
+
+  /// Collects statistics on dispatching received actor messages.
+  dispatch_stats dispatch_stats_;
+
+  /// Configures the interval for sending heartbeats.
+  timespan heartbeat_interval_ = defaults::middleman::heartbeat_interval;
+
+  /// Configures after how much time without input we close the connection.
+  timespan connection_timeout_ = defaults::middleman::connection_timeout;
+
+  /// Stores whether we have scheduled the first heartbeat.
+  bool heartbeats_started_ = false;
+
+  /// Stores whether we received any data since the last heartbeat.
+  bool got_input_ = false;
+
+  /// Stores the time of the first heartbeat after receiving data.
+  actor_clock::time_point last_input_;
+
+  /// Collects statistics on heartbeats and round-trip times.
+  heartbeat_stats heartbeat_stats_;
+
+  /// Maps actors that we have sent to our peer to their reference.
+  std::unordered_map<actor_addr, uint32_t> interned_ids_;
+
+  /// Stores references of terminated actors for reuse.
+  std::vector<uint32_t> free_interned_refs_;
+
+  /// Stores the highest reference that we have assigned so far.
+  uint32_t max_interned_ref_ = 0;
+
+  /// Counts down the inline definitions until the next scan for terminated
+  /// actors while the interning table is full.
+  size_t interned_purge_countdown_ = 0;
+
+  /// Stores the actors that our peer has sent to us. Reference `n` maps to
+  /// the element at index `n - 1`. Holds weak references only to avoid
+  /// keeping proxies of terminated actors alive.
+  std::vector<actor_addr> interned_actors_;
+
   /// Tracks which local actors our peer monitors.
   std::unordered_set<actor_addr> monitored_actors_; // TODO: this is unused
 
@@ -210,9 +529,15 @@ private:
   /// serializers and deserializer.
   scoped_execution_unit executor_;
 
-  std::unique_ptr<message_queue> queue_;
+  /// Establishes strict ordering of received messages. Busy workers keep the
+  /// queue alive after closing the connection.
+  std::shared_ptr<message_queue> queue_;
+
+  /// Points to the pool for deserializing messages asynchronously.
+  worker_pool* workers_;
 
-  std::unique_ptr<hub_type> hub_;
+  /// Owns `workers_` if no shared pool was passed to the constructor.
+  std::unique_ptr<worker_pool> own_workers_;
 };
 
 } // namespace caf::net::basp
@@ -31,7 +31,8 @@ class CAF_NET_EXPORT application_factory {
 public:
   using application_type = basp::application;
 
-  application_factory(proxy_registry& proxies) : proxies_(proxies) {
+  application_factory(proxy_registry& proxies, worker_pool* workers = nullptr)
+    : proxies_(proxies), workers_(workers) {
     // nop
   }
 
@@ -41,11 +42,13 @@ public:
   }
 
   application_type make() const {
-    return application_type{proxies_};
+    return application_type{proxies_, workers_};
   }
 
 private:
   proxy_registry& proxies_;
+
+  worker_pool* workers_;
 };
 
 } // namespace caf::net::basp
@@ -32,6 +32,39 @@ constexpr uint64_t version = 1;
 /// Size of a BASP header in serialized form.
 constexpr size_t header_size = 13;
 
+/// Size of the prefix for each message in an `actor_message_batch` frame,
+/// i.e., the payload size (4 bytes) plus the message ID (8 bytes).
+constexpr size_t batch_entry_header_size = 12;
+
+/// Capability bit for announcing support for `actor_message_batch` frames in
+/// the handshake. Nodes use a capability only if both nodes announce it.
+constexpr uint64_t batch_capability = 0x01;
+
+/// Capability bit for announcing support for `compressed_message` frames in
+/// the handshake.
+constexpr uint64_t compression_capability = 0x02;
+
+/// Capability bit for announcing support for `interned_actor_message` frames
+/// in the handshake.
+constexpr uint64_t interning_capability = 0x04;
+
+/// Capability bit for announcing that a node answers heartbeats that carry a
+/// timestamp. Nodes only close idle connections to peers with this
+/// capability, since other nodes never answer heartbeats.
+constexpr uint64_t heartbeat_capability = 0x08;
+
+/// Marks a heartbeat as the answer to a heartbeat of the peer. The remaining
+/// bits of the operation data echo the timestamp of the original heartbeat.
+constexpr uint64_t heartbeat_reply_flag = 0x8000000000000000;
+
+/// Marks a reference to an interned actor as a definition, i.e., the
+/// reference is followed by the node ID and actor ID of the actor. A
+/// definition with index 0 transmits an actor without interning it.
+constexpr uint32_t interned_definition_flag = 0x80000000;
+
+/// Maximum number of interned actors per connection and direction.
+constexpr uint32_t max_interned_actors = 4096;
+
 /// @}
 
 } // namespace caf::net::basp
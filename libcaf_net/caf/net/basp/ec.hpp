@@ -42,6 +42,7 @@ enum class ec : uint8_t {
   invalid_payload,
   invalid_scheme,
   invalid_locator,
+  connection_timeout,
 };
 
 /// @relates ec
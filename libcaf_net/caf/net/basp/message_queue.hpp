@@ -18,20 +18,36 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <mutex>
 #include <vector>
 
 #include "caf/actor_control_block.hpp"
+#include "caf/config.hpp"
 #include "caf/fwd.hpp"
 #include "caf/mailbox_element.hpp"
 
 namespace caf::net::basp {
 
-/// Enforces strict order of message delivery, i.e., deliver messages in the
-/// same order as if they were deserialized by a single thread.
+/// Enforces strict order of message delivery per sender and receiver, i.e.,
+/// deliver messages between two actors in the same order as if they were
+/// deserialized by a single thread. The queue maps each pair of actors to one
+/// of `num_shards` shards. Messages in different shards never wait for each
+/// other.
 class message_queue {
 public:
+  // -- constants --------------------------------------------------------------
+
+  /// Number of bits in a message ID that select the shard.
+  static constexpr int shard_bits = 4;
+
+  /// Number of independently ordered shards.
+  static constexpr size_t num_shards = size_t{1} << shard_bits;
+
+  /// Position of the shard bits in a message ID.
+  static constexpr int shard_shift = 64 - shard_bits;
+
   // -- member types -----------------------------------------------------------
 
   /// Request for sending a message to an actor at a later time.
@@ -41,10 +57,45 @@ public:
     mailbox_element_ptr content;
   };
 
+  /// Orders all messages with ordering keys that map to this shard. Each
+  /// shard occupies its own cache line to avoid false sharing between
+  /// workers.
+  struct alignas(CAF_CACHE_LINE_SIZE) shard {
+    /// Protects all other properties.
+    std::mutex lock;
+
+    /// The next available ascending ID. The counter is large enough to
+    /// overflow after roughly 36,000 years if we dispatch a message every
+    /// microsecond.
+    uint64_t next_id;
+
+    /// The next ID that we can ship.
+    uint64_t next_undelivered;
+
+    /// Keeps messages in sorted order in case a message other than
+    /// `next_undelivered` gets ready first.
+    std::vector<actor_msg> pending;
+  };
+
   // -- constructors, destructors, and assignment operators --------------------
 
   message_queue();
 
+  // -- static utility functions -----------------------------------------------
+
+  /// Returns the ordering key for messages from `src` to `dst`.
+  static uint64_t ordering_key(actor_id src, actor_id dst) noexcept {
+    // Actor IDs are small, consecutive numbers. Hence, we spread them across
+    // the high bits that select the shard.
+    constexpr uint64_t factor = 0x9E3779B97F4A7C15ull;
+    return ((src * factor) ^ dst) * factor;
+  }
+
+  /// Returns the index of the shard for `id`.
+  static size_t shard_index(uint64_t id) noexcept {
+    return static_cast<size_t>(id >> shard_shift);
+  }
+
   // -- mutators ---------------------------------------------------------------
 
   /// Adds a new message to the queue or deliver it immediately if possible.
@@ -54,24 +105,13 @@ public:
   /// Marks given ID as dropped, effectively skipping it without effect.
   void drop(execution_unit* ctx, uint64_t id);
 
-  /// Returns the next ascending ID.
-  uint64_t new_id();
+  /// Returns the next ascending ID for messages with given ordering key.
+  uint64_t new_id(uint64_t key = 0);
 
   // -- member variables -------------------------------------------------------
 
-  /// Protects all other properties.
-  std::mutex lock;
-
-  /// The next available ascending ID. The counter is large enough to overflow
-  /// after roughly 600 years if we dispatch a message every microsecond.
-  uint64_t next_id;
-
-  /// The next ID that we can ship.
-  uint64_t next_undelivered;
-
-  /// Keeps messages in sorted order in case a message other than
-  /// `next_undelivered` gets ready first.
-  std::vector<actor_msg> pending;
+  /// Stores the state for each shard.
+  std::array<shard, num_shards> shards;
 };
 
 } // namespace caf::net::basp
@@ -62,10 +62,35 @@ enum class message_type : uint8_t {
   down_message = 5,
 
   /// Used to generate periodic traffic between two nodes in order to detect
-  /// disconnects.
+  /// disconnects. A nonzero operation data carries the send time of the
+  /// heartbeat in nanoseconds. The receiver echoes it back with
+  /// `heartbeat_reply_flag` set, which allows the sender to measure the
+  /// round-trip time.
   ///
   /// ![](heartbeat.png)
   heartbeat = 6,
+
+  /// Transmits multiple actor-to-actor messages in a single frame. The
+  /// operation data stores the number of messages. Each message in the
+  /// payload starts with its size (4 bytes) and its message ID (8 bytes),
+  /// followed by the payload of a regular `actor_message`. Only sent to nodes
+  /// that announce `batch_capability` in their handshake.
+  actor_message_batch = 7,
+
+  /// Wraps another message with a compressed payload. The payload starts
+  /// with the header of the wrapped message, where the payload length denotes
+  /// the uncompressed size, followed by the compressed payload of the wrapped
+  /// message. Only sent to nodes that announce `compression_capability` in
+  /// their handshake.
+  compressed_message = 8,
+
+  /// Transmits an actor-to-actor message like `actor_message`, but replaces
+  /// the node ID and actor ID of the sender with a 4-byte reference into a
+  /// per-connection table. References with `interned_definition_flag` add
+  /// an entry to the table and carry node ID and actor ID once. Only sent to
+  /// nodes that announce `interning_capability` in their handshake. Batches
+  /// contain messages in this format if both nodes support interning.
+  interned_actor_message = 9,
 };
 
 /// @relates message_type
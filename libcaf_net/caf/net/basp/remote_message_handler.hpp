@@ -31,6 +31,7 @@
 #include "caf/message.hpp"
 #include "caf/message_id.hpp"
 #include "caf/net/basp/header.hpp"
+#include "caf/net/basp/message_type.hpp"
 #include "caf/node_id.hpp"
 
 namespace caf::net::basp {
@@ -53,22 +54,36 @@ public:
     std::vector<strong_actor_ptr> fwd_stack;
     message content;
     binary_deserializer source{ctx, payload};
-    if (auto err = source(src_node, src_id, dst_id, fwd_stack, content)) {
+    // Interned messages omit the sender, which the application resolves
+    // before dispatching the message to us.
+    auto interned = hdr.type == message_type::interned_actor_message;
+    auto err = interned
+                 ? source(dst_id, fwd_stack, content)
+                 : source(src_node, src_id, dst_id, fwd_stack, content);
+    // Dropped messages must still release their ID. Otherwise, all
+    // following messages with the same ordering key would wait forever.
+    if (err) {
       CAF_LOG_ERROR("could not deserialize payload: " << CAF_ARG(err));
+      dref.queue_->drop(ctx, dref.msg_id_);
       return;
     }
     // Sanity checks.
-    if (dst_id == 0)
+    if (dst_id == 0) {
+      dref.queue_->drop(ctx, dref.msg_id_);
       return;
+    }
     // Try to fetch the receiver.
     auto dst_hdl = registry.get(dst_id);
     if (dst_hdl == nullptr) {
       CAF_LOG_DEBUG("no actor found for given ID, drop message");
+      dref.queue_->drop(ctx, dref.msg_id_);
       return;
     }
     // Try to fetch the sender.
     strong_actor_ptr src_hdl;
-    if (src_node != none && src_id != 0)
+    if (interned)
+      src_hdl = std::move(dref.src_);
+    else if (src_node != none && src_id != 0)
       src_hdl = proxies.get_or_put(src_node, src_id);
     // Ship the message.
     auto ptr = make_mailbox_element(std::move(src_hdl),
@@ -20,12 +20,12 @@
 
 #include <atomic>
 #include <cstdint>
+#include <memory>
 
 #include "caf/byte_buffer.hpp"
 #include "caf/config.hpp"
 #include "caf/detail/abstract_worker.hpp"
 #include "caf/detail/net_export.hpp"
-#include "caf/detail/worker_hub.hpp"
 #include "caf/fwd.hpp"
 #include "caf/net/basp/header.hpp"
 #include "caf/net/basp/message_queue.hpp"
@@ -33,6 +33,7 @@
 #include "caf/net/fwd.hpp"
 #include "caf/node_id.hpp"
 #include "caf/resumable.hpp"
+#include "caf/span.hpp"
 
 namespace caf::net::basp {
 
@@ -50,19 +51,32 @@ public:
 
   using scheduler_type = scheduler::abstract_coordinator;
 
-  using hub_type = detail::worker_hub<worker>;
+  using message_queue_ptr = std::shared_ptr<message_queue>;
 
   // -- constructors, destructors, and assignment operators --------------------
 
-  /// Only the ::worker_hub has access to the construtor.
-  worker(hub_type& hub, message_queue& queue, proxy_registry& proxies);
+  /// Only the ::worker_pool has access to the construtor.
+  worker(worker_pool& pool, actor_system& sys);
 
   ~worker() override;
 
   // -- management -------------------------------------------------------------
 
-  void launch(const node_id& last_hop, const basp::header& hdr,
-              span<const byte> payload);
+  /// Deserializes `payload` asynchronously and delivers the message via
+  /// `queue`. For `interned_actor_message`, `src` is the already resolved
+  /// sender of the message. The worker delivers the message in order with
+  /// all messages that have the same `ordering_key`.
+  void launch(message_queue_ptr queue, proxy_registry& proxies,
+              const node_id& last_hop, const basp::header& hdr,
+              span<const byte> payload, strong_actor_ptr src = nullptr,
+              uint64_t ordering_key = 0);
+
+  /// Deserializes the payload asynchronously without copying it. The payload
+  /// starts at `offset` and spans the remainder of `buf`.
+  void launch(message_queue_ptr queue, proxy_registry& proxies,
+              const node_id& last_hop, const basp::header& hdr,
+              byte_buffer&& buf, size_t offset, strong_actor_ptr src = nullptr,
+              uint64_t ordering_key = 0);
 
   // -- implementation of resumable --------------------------------------------
 
@@ -73,22 +87,15 @@ private:
 
   /// Stores how many bytes the "first half" of this object requires.
   static constexpr size_t pointer_members_size
-    = sizeof(hub_type*) + sizeof(message_queue*) + sizeof(proxy_registry*)
-      + sizeof(actor_system*);
+    = sizeof(worker_pool*) + sizeof(actor_system*);
 
   static_assert(CAF_CACHE_LINE_SIZE > pointer_members_size,
                 "invalid cache line size");
 
   // -- member variables -------------------------------------------------------
 
-  /// Points to our home hub.
-  hub_type* hub_;
-
-  /// Points to the queue for establishing strict ordering.
-  message_queue* queue_;
-
-  /// Points to our proxy registry / factory.
-  proxy_registry* proxies_;
+  /// Points to our home pool.
+  worker_pool* pool_;
 
   /// Points to the parent system.
   actor_system* system_;
@@ -96,6 +103,12 @@ private:
   /// Prevents false sharing when writing to `next`.
   char pad_[CAF_CACHE_LINE_SIZE - pointer_members_size];
 
+  /// Points to the queue of the connection for establishing strict ordering.
+  message_queue_ptr queue_;
+
+  /// Points to our proxy registry / factory.
+  proxy_registry* proxies_;
+
   /// ID for local ordering.
   uint64_t msg_id_;
 
@@ -106,8 +119,14 @@ private:
   /// routed_message.
   header hdr_;
 
-  /// Contains whatever this worker deserializes next.
-  byte_buffer payload_;
+  /// Owns the memory for `payload_`.
+  byte_buffer buf_;
+
+  /// Points to whatever this worker deserializes next.
+  span<const byte> payload_;
+
+  /// Stores the sender of an `interned_actor_message`.
+  strong_actor_ptr src_;
 };
 
 } // namespace caf::net::basp
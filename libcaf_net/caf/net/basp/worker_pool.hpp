@@ -0,0 +1,164 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "caf/detail/net_export.hpp"
+#include "caf/fwd.hpp"
+#include "caf/net/fwd.hpp"
+#include "caf/timespan.hpp"
+
+namespace caf::net::basp {
+
+/// A node-wide pool of BASP workers that all connections share. The pool
+/// creates workers on demand up to a configurable maximum. It destroys the
+/// workers that stayed idle during an entire trim interval, keeping at least
+/// the configured minimum. The pool has no timer of its own and only trims
+/// when acquiring or returning a worker after the interval has passed. Hence,
+/// a pool without any traffic keeps its workers until the next call to `trim`.
+class CAF_NET_EXPORT worker_pool {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using clock_type = std::chrono::steady_clock;
+
+  /// Summarizes the state and the history of the pool.
+  struct stats {
+    /// Number of workers, including busy workers.
+    size_t size = 0;
+
+    /// Number of idle workers.
+    size_t idle = 0;
+
+    /// Number of workers that the pool has created so far.
+    size_t created = 0;
+
+    /// Number of workers that the pool has destroyed after a trim interval.
+    size_t destroyed = 0;
+
+    /// Number of calls to `pop` that returned `nullptr`, because all workers
+    /// were busy and the pool already reached its maximum size. Callers
+    /// deserialize on their own thread in this case.
+    size_t exhausted = 0;
+  };
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  worker_pool(actor_system& sys, size_t min_workers, size_t max_workers,
+              timespan trim_interval);
+
+  /// Reads the options `middleman.min-workers`, `middleman.max-workers` and
+  /// `middleman.worker-trim-interval`. The maximum defaults to the number of
+  /// hardware threads. Setting `middleman.workers` fixes the size instead.
+  explicit worker_pool(actor_system& sys);
+
+  worker_pool(const worker_pool&) = delete;
+
+  worker_pool& operator=(const worker_pool&) = delete;
+
+  /// Waits until all workers became idle and destroys them.
+  ~worker_pool();
+
+  // -- properties -------------------------------------------------------------
+
+  size_t min_workers() const noexcept {
+    return min_workers_;
+  }
+
+  size_t max_workers() const noexcept {
+    return max_workers_;
+  }
+
+  /// Returns a snapshot of the pool statistics.
+  stats statistics() const;
+
+  // -- mutators ---------------------------------------------------------------
+
+  /// Returns an idle worker, creating a new one if necessary. Returns
+  /// `nullptr` if all `max_workers()` workers are busy.
+  worker* pop();
+
+  /// Returns `ptr` to the pool after it finished its job.
+  void push(worker* ptr);
+
+  /// Destroys idle workers that no caller needed since the last trim. The
+  /// pool calls this function automatically from `pop` and `push` once the
+  /// trim interval has passed.
+  void trim(clock_type::time_point now);
+
+private:
+  // -- utility functions ------------------------------------------------------
+
+  /// Calls `trim_impl` if the trim interval has passed.
+  /// @pre `mtx_` is locked
+  void trim_if_due();
+
+  /// Implements `trim`.
+  /// @pre `mtx_` is locked
+  void trim_impl(clock_type::time_point now);
+
+  // -- member variables -------------------------------------------------------
+
+  /// Points to the parent system.
+  actor_system* sys_;
+
+  /// Configures how many workers the pool keeps at least.
+  size_t min_workers_;
+
+  /// Configures how many workers the pool creates at most.
+  size_t max_workers_;
+
+  /// Configures how often the pool destroys surplus workers.
+  timespan trim_interval_;
+
+  /// Protects all following member variables.
+  mutable std::mutex mtx_;
+
+  /// Signals the destructor when a worker becomes idle.
+  std::condition_variable idle_cv_;
+
+  /// Stores all idle workers. Using the container as a stack keeps recently
+  /// used workers (and their memory) hot.
+  std::vector<worker*> idle_;
+
+  /// Stores the number of workers, including busy workers.
+  size_t size_ = 0;
+
+  /// Smallest number of idle workers since the last trim.
+  size_t min_idle_ = 0;
+
+  /// Point in time for the next trim.
+  clock_type::time_point next_trim_;
+
+  /// Counts created workers.
+  size_t created_ = 0;
+
+  /// Counts destroyed workers.
+  size_t destroyed_ = 0;
+
+  /// Counts calls to `pop` without result.
+  size_t exhausted_ = 0;
+};
+
+} // namespace caf::net::basp
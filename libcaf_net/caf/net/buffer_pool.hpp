@@ -0,0 +1,167 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "caf/byte_buffer.hpp"
+#include "caf/detail/net_export.hpp"
+
+namespace caf::net {
+
+/// A process-wide pool for byte buffers. The pool sorts buffers into size
+/// classes by their capacity, where each class holds buffers with a capacity
+/// of at least `min_class_size << index` bytes. Each thread caches a few
+/// buffers per class in front of the shared, mutex-protected free lists.
+///
+/// The pool never holds more than `limit()` bytes. Releasing a buffer beyond
+/// that limit or a buffer larger than the largest size class frees it instead.
+class CAF_NET_EXPORT buffer_pool {
+public:
+  // -- member types -----------------------------------------------------------
+
+  /// Summarizes the memory usage of the pool.
+  struct stats {
+    /// Number of calls to `acquire`.
+    size_t acquired;
+
+    /// Number of calls to `acquire` that returned a pooled buffer.
+    size_t hits;
+
+    /// Number of buffers that went back into the pool.
+    size_t released;
+
+    /// Number of released buffers that the pool freed instead.
+    size_t discarded;
+
+    /// Sum of the capacities of all pooled buffers.
+    size_t pooled_bytes;
+  };
+
+  // -- constants --------------------------------------------------------------
+
+  /// Number of size classes.
+  static constexpr size_t num_size_classes = 16;
+
+  /// Capacity of buffers in the smallest size class.
+  static constexpr size_t min_class_size = 256;
+
+  /// Capacity of buffers in the largest size class.
+  static constexpr size_t max_class_size = min_class_size
+                                           << (num_size_classes - 1);
+
+  /// Maximum number of buffers per size class in each thread-local cache.
+  static constexpr size_t thread_cache_size = 8;
+
+  /// Denotes an invalid size class.
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  buffer_pool(const buffer_pool&) = delete;
+
+  buffer_pool& operator=(const buffer_pool&) = delete;
+
+  ~buffer_pool();
+
+  /// Returns the process-wide pool.
+  static buffer_pool& instance();
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the maximum number of bytes that the pool holds at any time.
+  size_t limit() const noexcept {
+    return limit_.load(std::memory_order_relaxed);
+  }
+
+  /// Sets the maximum number of bytes that the pool holds at any time.
+  void limit(size_t new_limit) noexcept {
+    limit_.store(new_limit, std::memory_order_relaxed);
+  }
+
+  /// Returns a snapshot of the pool statistics.
+  stats statistics() const noexcept;
+
+  // -- buffer management ------------------------------------------------------
+
+  /// Returns an empty buffer with a capacity of at least `size_hint` bytes.
+  byte_buffer acquire(size_t size_hint = 0);
+
+  /// Returns `buf` to the pool.
+  void release(byte_buffer buf);
+
+  /// Frees all buffers in the shared free lists and in the cache of the
+  /// calling thread.
+  void clear();
+
+  // -- utility functions ------------------------------------------------------
+
+  /// Returns the smallest size class with buffers that can hold `size` bytes
+  /// or `npos` if `size` exceeds the largest size class.
+  static size_t class_for_acquire(size_t size) noexcept;
+
+  /// Returns the largest size class for a buffer with given capacity or
+  /// `npos` if the capacity is too small or too large for the pool.
+  static size_t class_for_release(size_t capacity) noexcept;
+
+private:
+  // -- member types -----------------------------------------------------------
+
+  using buffer_list = std::vector<byte_buffer>;
+
+  struct shared_list {
+    std::mutex mtx;
+    buffer_list buffers;
+  };
+
+  struct thread_cache;
+
+  friend struct thread_cache;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  buffer_pool();
+
+  // -- utility functions ------------------------------------------------------
+
+  /// Returns the cache of the calling thread.
+  std::array<buffer_list, num_size_classes>& local_lists();
+
+  // -- member variables -------------------------------------------------------
+
+  std::atomic<size_t> limit_;
+
+  std::atomic<size_t> acquired_;
+
+  std::atomic<size_t> hits_;
+
+  std::atomic<size_t> released_;
+
+  std::atomic<size_t> discarded_;
+
+  std::atomic<size_t> pooled_bytes_;
+
+  std::array<shared_list, num_size_classes> shared_;
+};
+
+} // namespace caf::net
@@ -0,0 +1,45 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include "caf/byte_buffer.hpp"
+#include "caf/detail/net_export.hpp"
+#include "caf/error.hpp"
+#include "caf/span.hpp"
+
+namespace caf::net {
+
+/// Compresses `input` with a fast LZ77-style codec that produces blocks in the
+/// LZ4 block format and appends the result to `output`.
+/// @relates decompress
+CAF_NET_EXPORT void compress(span<const byte> input, byte_buffer& output);
+
+/// Decompresses a block produced by `compress` into `output`, replacing its
+/// previous content.
+/// @param input The compressed block.
+/// @param decompressed_size The exact size of the original input.
+/// @param output Stores the decompressed bytes.
+/// @returns An error if `input` is malformed or does not decompress to
+///          exactly `decompressed_size` bytes.
+CAF_NET_EXPORT error decompress(span<const byte> input,
+                                size_t decompressed_size, byte_buffer& output);
+
+} // namespace caf::net
@@ -18,7 +18,8 @@
 
 #pragma once
 
-#include <deque>
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 #include "caf/byte_buffer.hpp"
@@ -26,12 +27,16 @@
 #include "caf/fwd.hpp"
 #include "caf/ip_endpoint.hpp"
 #include "caf/logger.hpp"
+#include "caf/net/defaults.hpp"
 #include "caf/net/endpoint_manager.hpp"
 #include "caf/net/fwd.hpp"
+#include "caf/net/packet_queue.hpp"
 #include "caf/net/transport_base.hpp"
 #include "caf/net/transport_worker_dispatcher.hpp"
 #include "caf/net/udp_datagram_socket.hpp"
 #include "caf/sec.hpp"
+#include "caf/span.hpp"
+#include "caf/variant.hpp"
 
 namespace caf::net {
 
@@ -59,8 +64,6 @@ public:
 
   using super = datagram_transport_base<factory_type>;
 
-  using buffer_cache_type = typename super::buffer_cache_type;
-
   // -- constructors, destructors, and assignment operators --------------------
 
   datagram_transport(udp_datagram_socket handle, factory_type factory)
@@ -74,6 +77,15 @@ public:
     CAF_LOG_TRACE("");
     if (auto err = super::init(manager))
       return err;
+    auto& cfg = this->system().config();
+    auto batch_size = get_or(cfg, "middleman.datagram-batch-size",
+                             defaults::middleman::datagram_batch_size);
+    batch_size_ = std::min(std::max(batch_size, size_t{1}),
+                           max_datagram_batch_size);
+    gso_ = get_or(cfg, "middleman.udp-gso", defaults::middleman::udp_gso);
+    if (get_or(cfg, "middleman.udp-gro", defaults::middleman::udp_gro))
+      if (auto err = gro(this->handle_, true))
+        CAF_LOG_WARNING("unable to enable UDP_GRO:" << err);
     prepare_next_read();
     return none;
   }
@@ -81,17 +93,17 @@ public:
   bool handle_read_event(endpoint_manager&) override {
     CAF_LOG_TRACE(CAF_ARG(this->handle_.id));
     for (size_t reads = 0; reads < this->max_consecutive_reads_; ++reads) {
-      auto ret = read(this->handle_, this->read_buf_);
-      if (auto res = get_if<std::pair<size_t, ip_endpoint>>(&ret)) {
-        auto& [num_bytes, ep] = *res;
-        CAF_LOG_DEBUG("received " << num_bytes << " bytes");
-        this->read_buf_.resize(num_bytes);
-        if (auto err = this->next_layer_.handle_data(*this, this->read_buf_,
-                                                     std::move(ep))) {
-          CAF_LOG_ERROR("handle_data failed: " << err);
-          return false;
-        }
-        prepare_next_read();
+      auto ret = read(this->handle_, make_span(read_spans_),
+                      make_span(read_infos_));
+      if (auto num_datagrams = get_if<size_t>(&ret)) {
+        CAF_LOG_DEBUG("received " << *num_datagrams << " datagrams");
+        for (size_t i = 0; i < *num_datagrams; ++i)
+          if (!handle_received(read_bufs_[i].data(), read_infos_[i]))
+            return false;
+        // Receiving fewer datagrams than we have buffers for means that the
+        // socket has no more data for us.
+        if (*num_datagrams < read_spans_.size())
+          break;
       } else {
         auto err = get<sec>(ret);
         if (err == sec::unavailable_or_would_block) {
@@ -109,18 +121,92 @@ public:
   bool handle_write_event(endpoint_manager& manager) override {
     CAF_LOG_TRACE(CAF_ARG2("handle", this->handle_.id)
                   << CAF_ARG2("queue-size", packet_queue_.size()));
-    auto fetch_next_message = [&] {
-      if (auto msg = manager.next_message()) {
-        this->next_layer_.write_message(*this, std::move(msg));
-        return true;
-      }
-      return false;
-    };
-    do {
+    for (;;) {
+      fetch_messages(manager);
+      if (packet_queue_.empty())
+        return false;
       if (auto err = write_some())
         return err == sec::unavailable_or_would_block;
-    } while (fetch_next_message());
-    return !packet_queue_.empty();
+    }
+  }
+
+  // -- completion-based I/O ---------------------------------------------------
+
+  /// Returns the buffer for the next datagram. Used by multiplexer backends
+  /// that read on behalf of the transport.
+  span<byte> read_buffer(endpoint_manager&) {
+    return read_spans_.front();
+  }
+
+  /// Processes a datagram that arrived in the buffer from `read_buffer`.
+  /// @returns `false` if the transport stops reading, `true` otherwise.
+  bool handle_datagram_completion(endpoint_manager&,
+                                  variant<received_datagram, sec> result) {
+    if (auto info = get_if<received_datagram>(&result)) {
+      CAF_LOG_DEBUG(CAF_ARG(this->handle_.id) << CAF_ARG2("len", info->size));
+      return handle_received(read_bufs_.front().data(), *info);
+    }
+    auto err = get<sec>(result);
+    if (err == sec::unavailable_or_would_block)
+      return true;
+    CAF_LOG_DEBUG("read failed" << CAF_ARG(err));
+    this->next_layer_.handle_error(err);
+    return false;
+  }
+
+  /// Returns the buffers of the next datagram after serializing pending
+  /// messages. Used by multiplexer backends that write on behalf of the
+  /// transport.
+  /// @returns an empty span if the packet queue is empty.
+  span<const span<const byte>> write_buffers(endpoint_manager& manager) {
+    CAF_LOG_TRACE(CAF_ARG2("handle", this->handle_.id)
+                  << CAF_ARG2("queue-size", packet_queue_.size()));
+    fetch_messages(manager);
+    write_spans_.clear();
+    if (!packet_queue_.empty())
+      for (auto ptr : packet_queue_.front().buffer_ptrs())
+        write_spans_.emplace_back(ptr->data(), ptr->size());
+    return span<const span<const byte>>{write_spans_};
+  }
+
+  /// Returns the receiver of the buffers from `write_buffers`.
+  ip_endpoint write_destination(endpoint_manager&) {
+    CAF_ASSERT(!packet_queue_.empty());
+    return packet_queue_.front().id();
+  }
+
+  /// Processes the result of a write of the buffers from `write_buffers`.
+  /// @returns `false` if the transport stops writing, `true` otherwise.
+  bool handle_write_completion(endpoint_manager&,
+                               variant<size_t, sec> result) {
+    if (auto num_bytes = get_if<size_t>(&result)) {
+      CAF_LOG_DEBUG(CAF_ARG(this->handle_.id) << CAF_ARG(*num_bytes));
+      pop_front();
+      return true;
+    }
+    auto err = get<sec>(result);
+    if (err == sec::unavailable_or_would_block)
+      return true;
+    CAF_LOG_ERROR("write failed" << CAF_ARG(err));
+    this->next_layer_.handle_error(err);
+    return false;
+  }
+
+  // -- properties -------------------------------------------------------------
+
+  /// Counts the system calls for sending datagrams.
+  struct write_statistics {
+    /// Number of batched writes, each sending up to `batch_size_` datagrams.
+    size_t batched_writes = 0;
+
+    /// Number of segmented writes, each sending a run of equally sized
+    /// datagrams to one endpoint with `UDP_SEGMENT`.
+    size_t segmented_writes = 0;
+  };
+
+  /// Returns how many system calls the transport made for sending datagrams.
+  const write_statistics& write_stats() const noexcept {
+    return write_stats_;
   }
 
   // TODO: remove this function. `resolve` should add workers when needed.
@@ -134,70 +220,119 @@ public:
   void write_packet(id_type id, span<byte_buffer*> buffers) override {
     CAF_LOG_TRACE("");
     CAF_ASSERT(!buffers.empty());
-    if (packet_queue_.empty())
-      this->manager().register_writing();
+    auto was_empty = packet_queue_.empty();
     // By convention, the first buffer is a header buffer. Every other buffer is
     // a payload buffer.
-    packet_queue_.emplace_back(id, buffers);
+    if (!packet_queue_.push_back(std::move(id), buffers)) {
+      CAF_LOG_ERROR("drop packet with too many buffers"
+                    << CAF_ARG2("buffers", buffers.size()));
+      return;
+    }
+    if (was_empty)
+      this->manager().register_writing();
   }
 
-  /// Helper struct for managing outgoing packets
-  struct packet {
-    id_type id;
-    buffer_cache_type bytes;
-    size_t size;
+private:
+  // -- utility functions ------------------------------------------------------
 
-    packet(id_type id, span<byte_buffer*> bufs) : id(id) {
-      size = 0;
-      for (auto buf : bufs) {
-        size += buf->size();
-        bytes.emplace_back(std::move(*buf));
-      }
+  void prepare_next_read() {
+    read_bufs_.resize(batch_size_);
+    read_spans_.clear();
+    for (auto& buf : read_bufs_) {
+      buf.resize(max_datagram_size);
+      read_spans_.emplace_back(buf);
     }
+    read_infos_.resize(batch_size_);
+  }
 
-    std::vector<byte_buffer*> get_buffer_ptrs() {
-      std::vector<byte_buffer*> ptrs;
-      for (auto& buf : bytes)
-        ptrs.emplace_back(&buf);
-      return ptrs;
+  /// Serializes pending messages until the packet queue holds a full batch or
+  /// the manager has no more messages.
+  void fetch_messages(endpoint_manager& manager) {
+    while (packet_queue_.size() < batch_size_) {
+      auto msg = manager.next_message();
+      if (!msg)
+        return;
+      this->next_layer_.write_message(*this, std::move(msg));
     }
-  };
+  }
 
-private:
-  // -- utility functions ------------------------------------------------------
+  /// Passes a received buffer to the next layer, splitting buffers that the
+  /// kernel coalesced with UDP_GRO back into the original datagrams.
+  bool handle_received(byte* pos, const received_datagram& info) {
+    auto segment_size = info.segment_size > 0 ? info.segment_size : info.size;
+    auto remaining = info.size;
+    do {
+      auto n = std::min(segment_size, remaining);
+      if (auto err = this->next_layer_.handle_data(*this, make_span(pos, n),
+                                                   info.ep)) {
+        CAF_LOG_ERROR("handle_data failed: " << err);
+        return false;
+      }
+      pos += n;
+      remaining -= n;
+    } while (remaining > 0);
+    return true;
+  }
 
-  void prepare_next_read() {
-    this->read_buf_.resize(max_datagram_size);
+  /// Drops the first packet and returns its buffers to the buffer pool. By
+  /// convention, the first buffer is a header buffer.
+  void pop_front() {
+    auto bufs = packet_queue_.front().buffers();
+    for (size_t i = 0; i < bufs.size(); ++i)
+      this->recycle(bufs[i], i == 0);
+    packet_queue_.pop_front();
   }
 
   error write_some() {
-    // Helper function to sort empty buffers back into the right caches.
-    auto recycle = [&]() {
-      auto& front = packet_queue_.front();
-      auto& bufs = front.bytes;
-      auto it = bufs.begin();
-      if (this->header_bufs_.size() < this->header_bufs_.capacity()) {
-        it->clear();
-        this->header_bufs_.emplace_back(std::move(*it++));
+    // Write as many packets as possible, passing up to batch_size_ packets to
+    // a single write call.
+    while (!packet_queue_.empty()) {
+      if (gso_) {
+        if (auto run = segmented_run_length(); run > 1) {
+          auto segment_size = packet_queue_.front().size();
+          segmented_bufs_.clear();
+          for (size_t i = 0; i < run; ++i) {
+            auto ptrs = packet_queue_[i].buffer_ptrs();
+            segmented_bufs_.insert(segmented_bufs_.end(), ptrs.begin(),
+                                   ptrs.end());
+          }
+          auto write_ret = write_segmented(this->handle_,
+                                           make_span(segmented_bufs_),
+                                           segment_size,
+                                           packet_queue_.front().id());
+          if (auto num_bytes = get_if<size_t>(&write_ret)) {
+            CAF_LOG_DEBUG(CAF_ARG(this->handle_.id)
+                          << CAF_ARG(*num_bytes) << CAF_ARG(run));
+            ++write_stats_.segmented_writes;
+            for (size_t i = 0; i < run; ++i)
+              pop_front();
+            continue;
+          }
+          auto err = get<sec>(write_ret);
+          if (err == sec::unavailable_or_would_block)
+            return err;
+          // The kernel or the network card may not support segmentation
+          // offload. Fall back to regular writes, which report the error in
+          // case the socket itself has failed.
+          CAF_LOG_WARNING("segmented write failed, disable UDP_SEGMENT:"
+                          << CAF_ARG(err));
+          gso_ = false;
+        }
       }
-      for (; it != bufs.end()
-             && this->payload_bufs_.size() < this->payload_bufs_.capacity();
-           ++it) {
-        it->clear();
-        this->payload_bufs_.emplace_back(std::move(*it));
+      write_batch_.clear();
+      auto n = std::min(packet_queue_.size(), batch_size_);
+      for (size_t i = 0; i < n; ++i) {
+        auto& pkt = packet_queue_[i];
+        write_batch_.emplace_back(
+          outgoing_datagram{pkt.buffer_ptrs(), pkt.id()});
       }
-      packet_queue_.pop_front();
-    };
-    // Write as many bytes as possible.
-    while (!packet_queue_.empty()) {
-      auto& packet = packet_queue_.front();
-      auto ptrs = packet.get_buffer_ptrs();
-      auto write_ret = write(this->handle_, ptrs, packet.id);
-      if (auto num_bytes = get_if<size_t>(&write_ret)) {
-        CAF_LOG_DEBUG(CAF_ARG(this->handle_.id) << CAF_ARG(*num_bytes));
-        CAF_LOG_WARNING_IF(*num_bytes < packet.size,
-                           "packet was not sent completely");
-        recycle();
+      auto write_ret = write(this->handle_,
+                             span<const outgoing_datagram>{write_batch_});
+      if (auto num_datagrams = get_if<size_t>(&write_ret)) {
+        CAF_LOG_DEBUG(CAF_ARG(this->handle_.id) << CAF_ARG(*num_datagrams));
+        ++write_stats_.batched_writes;
+        for (size_t i = 0; i < *num_datagrams; ++i)
+          pop_front();
       } else {
         auto err = get<sec>(write_ret);
         if (err != sec::unavailable_or_would_block) {
@@ -210,7 +345,61 @@ private:
     return none;
   }
 
-  std::deque<packet> packet_queue_;
+  /// Returns how many packets at the front of the queue are eligible for a
+  /// single segmented write. All packets must go to the same endpoint and
+  /// have the same size, except for the last one which may be shorter.
+  size_t segmented_run_length() {
+    auto& first = packet_queue_.front();
+    auto segment_size = first.size();
+    if (segment_size == 0
+        || segment_size > std::numeric_limits<uint16_t>::max())
+      return 1;
+    size_t result = 0;
+    size_t total = 0;
+    for (size_t i = 0; i < packet_queue_.size(); ++i) {
+      auto& pkt = packet_queue_[i];
+      if (result == max_datagram_segments || pkt.id() != first.id()
+          || pkt.size() > segment_size
+          || total + pkt.size() > max_segmented_write_size)
+        break;
+      ++result;
+      total += pkt.size();
+      if (pkt.size() < segment_size)
+        break;
+    }
+    return result;
+  }
+
+  packet_queue<id_type> packet_queue_;
+
+  /// Maximum number of datagrams per read or write call.
+  size_t batch_size_ = 1;
+
+  /// Stores one receive buffer per datagram in a batch.
+  std::vector<byte_buffer> read_bufs_;
+
+  /// Points to the buffers in `read_bufs_`.
+  std::vector<span<byte>> read_spans_;
+
+  /// Stores size, sender and segment size of each received datagram in a
+  /// batch.
+  std::vector<received_datagram> read_infos_;
+
+  /// Describes the packets for the next write call.
+  std::vector<outgoing_datagram> write_batch_;
+
+  /// Points to the buffers of the datagram from `write_buffers`.
+  std::vector<span<const byte>> write_spans_;
+
+  /// Configures whether we send runs of equally sized packets to the same
+  /// endpoint with a single segmented write.
+  bool gso_ = false;
+
+  /// Points to the buffers for the next segmented write.
+  std::vector<byte_buffer*> segmented_bufs_;
+
+  /// Counts the system calls for sending datagrams.
+  write_statistics write_stats_;
 };
 
 } // namespace caf::net
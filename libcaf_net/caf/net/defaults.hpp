@@ -22,18 +22,92 @@
 #include <cstdint>
 
 #include "caf/detail/net_export.hpp"
+#include "caf/timespan.hpp"
 
 // -- hard-coded default values for various CAF options ------------------------
 
 namespace caf::defaults::middleman {
 
-/// Maximum number of cached buffers for sending payloads.
-CAF_NET_EXPORT extern const size_t max_payload_buffers;
+/// Maximum number of payload bytes in a BASP frame that packs multiple actor
+/// messages. A value of 0 disables batching.
+CAF_NET_EXPORT extern const size_t basp_max_batch_size;
 
-/// Maximum number of cached buffers for sending headers.
-CAF_NET_EXPORT extern const size_t max_header_buffers;
+/// Minimum payload size for compressing actor messages on BASP connections.
+/// The default of 0 disables compression.
+CAF_NET_EXPORT extern const size_t basp_compression_threshold;
+
+/// Maximum payload size of actor messages that BASP deserializes on the I/O
+/// thread instead of scheduling a worker.
+CAF_NET_EXPORT extern const size_t basp_inline_threshold;
+
+/// Target time for deserializing a single actor message on the I/O thread. A
+/// nonzero value lets BASP lower the inline threshold based on the measured
+/// deserialization time per byte.
+CAF_NET_EXPORT extern const timespan basp_inline_budget;
+
+/// Time without any incoming data after which BASP closes the connection to a
+/// peer. Only applies if heartbeats are enabled.
+CAF_NET_EXPORT extern const timespan connection_timeout;
+
+/// Maximum number of datagrams that a datagram transport receives or sends
+/// with a single system call.
+CAF_NET_EXPORT extern const size_t datagram_batch_size;
+
+/// Configures whether datagram transports send runs of packets to the same
+/// endpoint as a single segmented write (`UDP_SEGMENT`, Linux only).
+CAF_NET_EXPORT extern const bool udp_gso;
+
+/// Configures whether datagram transports let the kernel coalesce incoming
+/// datagrams (`UDP_GRO`, Linux only).
+CAF_NET_EXPORT extern const bool udp_gro;
+
+/// Maximum number of bytes in the process-wide buffer pool.
+CAF_NET_EXPORT extern const size_t buffer_pool_limit;
+
+/// Interval for sending heartbeats on BASP connections. A value of 0 disables
+/// heartbeats.
+CAF_NET_EXPORT extern const timespan heartbeat_interval;
 
 /// Port to listen on for tcp.
 CAF_NET_EXPORT extern const uint16_t tcp_port;
 
+/// Number of multiplexers (and thus I/O threads) for socket I/O.
+CAF_NET_EXPORT extern const size_t multiplexer_threads;
+
+/// Minimum number of BASP workers in the node-wide worker pool.
+CAF_NET_EXPORT extern const size_t min_workers;
+
+/// Initial size of the receive buffer for stream transports. Stream transports
+/// deliver as many complete messages per read as fit into this buffer.
+CAF_NET_EXPORT extern const size_t stream_read_buffer_size;
+
+/// Maximum size of the receive buffer for stream transports. The buffer
+/// doubles whenever a read fills it completely until reaching this size.
+CAF_NET_EXPORT extern const size_t stream_read_buffer_max_size;
+
+/// Minimum payload size for receiving a message into a separate buffer that
+/// stream transports hand over to the application without copying. A value
+/// of 0 disables the handoff.
+CAF_NET_EXPORT extern const size_t stream_handoff_threshold;
+
+/// Number of queued bytes in the write queue of a stream transport at which
+/// it stops serializing more messages and signals overload to senders.
+CAF_NET_EXPORT extern const size_t write_queue_high_watermark;
+
+/// Number of queued bytes in the write queue of a stream transport at which
+/// it clears the overload signal again.
+CAF_NET_EXPORT extern const size_t write_queue_low_watermark;
+
+/// Time without incoming data after which a datagram transport drops the
+/// worker for a remote endpoint. A value of 0 disables eviction.
+CAF_NET_EXPORT extern const timespan worker_idle_timeout;
+
+/// Interval for destroying BASP workers that stayed idle for the entire
+/// interval. A value of 0 disables shrinking the worker pool.
+CAF_NET_EXPORT extern const timespan worker_trim_interval;
+
+/// Minimum payload size for sending with `MSG_ZEROCOPY` on stream transports.
+/// The default of 0 disables zero-copy writes.
+CAF_NET_EXPORT extern const size_t zerocopy_threshold;
+
 } // namespace caf::defaults::middleman
@@ -18,7 +18,10 @@
 
 #pragma once
 
+#include <functional>
+
 #include "caf/logger.hpp"
+#include "caf/net/fwd.hpp"
 #include "caf/net/make_endpoint_manager.hpp"
 #include "caf/net/socket.hpp"
 #include "caf/net/stream_socket.hpp"
@@ -40,10 +43,18 @@ public:
 
   using application_type = typename Factory::application_type;
 
+  /// Picks the multiplexer for an accepted connection.
+  using multiplexer_selector = std::function<multiplexer_ptr()>;
+
   // -- constructors, destructors, and assignment operators --------------------
 
-  explicit doorman(net::tcp_accept_socket acceptor, factory_type factory)
-    : acceptor_(acceptor), factory_(std::move(factory)) {
+  /// @param select Picks the multiplexer for each accepted connection. The
+  ///               doorman uses its own multiplexer if `select` is empty.
+  explicit doorman(net::tcp_accept_socket acceptor, factory_type factory,
+                   multiplexer_selector select = {})
+    : acceptor_(acceptor),
+      factory_(std::move(factory)),
+      select_(std::move(select)) {
     // nop
   }
 
@@ -70,9 +81,9 @@ public:
       CAF_LOG_ERROR("accept failed:" << x.error());
       return false;
     }
-    auto mpx = parent.multiplexer();
+    auto mpx = select_ ? select_() : parent.multiplexer();
     if (!mpx) {
-      CAF_LOG_DEBUG("unable to get multiplexer from parent");
+      CAF_LOG_DEBUG("unable to get multiplexer for the new connection");
       return false;
     }
     auto child = make_endpoint_manager(
@@ -125,6 +136,8 @@ private:
   net::tcp_accept_socket acceptor_;
 
   factory_type factory_;
+
+  multiplexer_selector select_;
 };
 
 } // namespace caf::net
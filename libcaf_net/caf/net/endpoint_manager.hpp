@@ -18,9 +18,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <string>
 
 #include "caf/actor.hpp"
 #include "caf/actor_clock.hpp"
@@ -31,6 +33,7 @@
 #include "caf/intrusive/singly_linked.hpp"
 #include "caf/mailbox_element.hpp"
 #include "caf/net/endpoint_manager_queue.hpp"
+#include "caf/net/overload_policy.hpp"
 #include "caf/net/socket_manager.hpp"
 #include "caf/variant.hpp"
 
@@ -43,6 +46,8 @@ public:
 
   using super = socket_manager;
 
+  using overload_policy = net::overload_policy;
+
   // -- constructors, destructors, and assignment operators --------------------
 
   endpoint_manager(socket handle, const multiplexer_ptr& parent,
@@ -58,6 +63,44 @@ public:
 
   endpoint_manager_queue::message_ptr next_message();
 
+  /// Returns whether the transport has queued more bytes than its high
+  /// watermark and did not drain its queue below the low watermark since.
+  bool overloaded() const noexcept {
+    return overloaded_.load(std::memory_order_relaxed);
+  }
+
+  /// Sets the overload state of this manager.
+  /// @pre must be called from the thread of the multiplexer
+  void overloaded(bool value) noexcept;
+
+  /// Returns how this manager treats new messages while overloaded.
+  overload_policy policy() const noexcept {
+    return policy_;
+  }
+
+  /// Sets how this manager treats new messages while overloaded.
+  void policy(overload_policy value) noexcept {
+    policy_ = value;
+  }
+
+  /// Returns the number of messages that this manager dropped while
+  /// overloaded.
+  size_t dropped_messages() const noexcept {
+    return dropped_messages_.load(std::memory_order_relaxed);
+  }
+
+  // -- timeout management -----------------------------------------------------
+
+  /// Schedules a timeout on the multiplexer of this manager. Once the timeout
+  /// expires, the multiplexer calls `handle_timeout` with `type` and the
+  /// returned ID.
+  /// @pre must be called from the thread of the multiplexer
+  uint64_t set_timeout(actor_clock::time_point tp, std::string type);
+
+  /// Cancels a pending timeout.
+  /// @pre must be called from the thread of the multiplexer
+  void cancel_timeout(uint64_t id);
+
   // -- event management -------------------------------------------------------
 
   /// Resolves a path to a remote actor.
@@ -86,8 +129,14 @@ protected:
   /// Stores control events and outbound messages.
   endpoint_manager_queue::type queue_;
 
-  /// Stores a proxy for interacting with the actor clock.
-  actor timeout_proxy_;
+  /// Signals senders that the transport has too many bytes queued.
+  std::atomic<bool> overloaded_;
+
+  /// Configures how to treat new messages while overloaded.
+  overload_policy policy_;
+
+  /// Counts messages that the manager dropped while overloaded.
+  std::atomic<size_t> dropped_messages_;
 };
 
 using endpoint_manager_ptr = intrusive_ptr<endpoint_manager>;
@@ -18,14 +18,37 @@
 
 #pragma once
 
+#include <type_traits>
+#include <utility>
+
 #include "caf/abstract_actor.hpp"
 #include "caf/actor_cast.hpp"
 #include "caf/actor_system.hpp"
 #include "caf/detail/overload.hpp"
 #include "caf/net/endpoint_manager.hpp"
+#include "caf/span.hpp"
+#include "caf/variant.hpp"
 
 namespace caf::net {
 
+/// Checks whether `Transport` supports completion-based I/O.
+template <class Transport, class = void>
+struct has_completion_io : std::false_type {};
+
+template <class Transport>
+struct has_completion_io<
+  Transport, std::void_t<decltype(std::declval<Transport&>().read_buffer(
+               std::declval<endpoint_manager&>()))>> : std::true_type {};
+
+/// Checks whether `Transport` reads and writes datagrams via completions.
+template <class Transport, class = void>
+struct has_datagram_io : std::false_type {};
+
+template <class Transport>
+struct has_datagram_io<
+  Transport, std::void_t<decltype(std::declval<Transport&>().write_destination(
+               std::declval<endpoint_manager&>()))>> : std::true_type {};
+
 template <class Transport>
 class endpoint_manager_impl : public endpoint_manager {
 public:
@@ -37,6 +60,14 @@ public:
 
   using application_type = typename transport_type::application_type;
 
+  // -- constants --------------------------------------------------------------
+
+  /// Signals whether the transport reads and writes via completions.
+  static constexpr bool completion_io = has_completion_io<Transport>::value;
+
+  /// Signals whether the completions of the transport carry addresses.
+  static constexpr bool datagram_io = has_datagram_io<Transport>::value;
+
   // -- constructors, destructors, and assignment operators --------------------
 
   endpoint_manager_impl(const multiplexer_ptr& parent, actor_system& sys,
@@ -64,11 +95,9 @@ public:
   template <class... Ts>
   uint64_t
   set_timeout(actor_clock::time_point tp, std::string type, Ts&&... xs) {
-    auto act = actor_cast<abstract_actor*>(timeout_proxy_);
-    CAF_ASSERT(act != nullptr);
-    sys_.clock().set_multi_timeout(tp, act, std::move(type), next_timeout_id_);
-    transport_.set_timeout(next_timeout_id_, std::forward<Ts>(xs)...);
-    return next_timeout_id_++;
+    auto id = super::set_timeout(tp, std::move(type));
+    transport_.set_timeout(id, std::forward<Ts>(xs)...);
+    return id;
   }
 
   // -- interface functions ----------------------------------------------------
@@ -83,30 +112,7 @@ public:
   }
 
   bool handle_write_event() override {
-    if (!this->queue_.blocked()) {
-      this->queue_.fetch_more();
-      auto& q = std::get<0>(this->queue_.queue().queues());
-      do {
-        q.inc_deficit(q.total_task_size());
-        for (auto ptr = q.next(); ptr != nullptr; ptr = q.next()) {
-          auto f = detail::make_overload(
-            [&](endpoint_manager_queue::event::resolve_request& x) {
-              transport_.resolve(*this, x.locator, x.listener);
-            },
-            [&](endpoint_manager_queue::event::new_proxy& x) {
-              transport_.new_proxy(*this, x.peer, x.id);
-            },
-            [&](endpoint_manager_queue::event::local_actor_down& x) {
-              transport_.local_actor_down(*this, x.observing_peer, x.id,
-                                          std::move(x.reason));
-            },
-            [&](endpoint_manager_queue::event::timeout& x) {
-              transport_.timeout(*this, x.type, x.id);
-            });
-          visit(f, ptr->value);
-        }
-      } while (!q.empty());
-    }
+    handle_queued_events();
     if (!transport_.handle_write_event(*this)) {
       if (this->queue_.blocked())
         return false;
@@ -119,11 +125,116 @@ public:
     transport_.handle_error(code);
   }
 
+  void handle_timeout(std::string type, uint64_t id) override {
+    transport_.timeout(*this, std::move(type), id);
+  }
+
+  bool handle_error_queue_event() override {
+    return handle_error_queue_event_impl(transport_, 0);
+  }
+
+  bool supports_completions() const noexcept override {
+    return completion_io;
+  }
+
+  span<byte> read_buffer() override {
+    if constexpr (completion_io)
+      return transport_.read_buffer(*this);
+    else
+      return {};
+  }
+
+  bool handle_read_completion(variant<size_t, sec> result) override {
+    if constexpr (completion_io && !datagram_io)
+      return transport_.handle_read_completion(*this, result);
+    else
+      return false;
+  }
+
+  span<const span<const byte>> write_buffers() override {
+    if constexpr (completion_io) {
+      for (;;) {
+        handle_queued_events();
+        auto result = transport_.write_buffers(*this);
+        if (!result.empty() || this->queue_.blocked()
+            || (this->queue_.empty() && this->queue_.try_block()))
+          return result;
+      }
+    } else {
+      return {};
+    }
+  }
+
+  bool handle_write_completion(variant<size_t, sec> result) override {
+    if constexpr (completion_io)
+      return transport_.handle_write_completion(*this, result);
+    else
+      return false;
+  }
+
+  bool uses_datagrams() const noexcept override {
+    return datagram_io;
+  }
+
+  bool
+  handle_datagram_completion(variant<received_datagram, sec> result) override {
+    if constexpr (datagram_io)
+      return transport_.handle_datagram_completion(*this, result);
+    else
+      return false;
+  }
+
+  ip_endpoint write_destination() override {
+    if constexpr (datagram_io)
+      return transport_.write_destination(*this);
+    else
+      return {};
+  }
+
 private:
-  transport_type transport_;
+  // -- utility functions ------------------------------------------------------
+
+  /// Runs all pending resolve requests, proxy announcements, and down
+  /// notifications from the event queue.
+  void handle_queued_events() {
+    if (this->queue_.blocked())
+      return;
+    this->queue_.fetch_more();
+    auto& q = std::get<0>(this->queue_.queue().queues());
+    do {
+      q.inc_deficit(q.total_task_size());
+      for (auto ptr = q.next(); ptr != nullptr; ptr = q.next()) {
+        auto f = detail::make_overload(
+          [&](endpoint_manager_queue::event::resolve_request& x) {
+            transport_.resolve(*this, x.locator, x.listener);
+          },
+          [&](endpoint_manager_queue::event::new_proxy& x) {
+            transport_.new_proxy(*this, x.peer, x.id);
+          },
+          [&](endpoint_manager_queue::event::local_actor_down& x) {
+            transport_.local_actor_down(*this, x.observing_peer, x.id,
+                                        std::move(x.reason));
+          });
+        visit(f, ptr->value);
+      }
+    } while (!q.empty());
+  }
+
+  // Forwards the event to transports that read from the error queue.
+  template <class T>
+  auto handle_error_queue_event_impl(T& x, int)
+    -> decltype(x.handle_error_queue_event(std::declval<endpoint_manager&>())) {
+    return x.handle_error_queue_event(*this);
+  }
+
+  template <class T>
+  bool handle_error_queue_event_impl(T&, long) {
+    return false;
+  }
 
-  /// Stores the id for the next timeout.
-  uint64_t next_timeout_id_;
+  // -- member variables -------------------------------------------------------
+
+  transport_type transport_;
 };
 
 } // namespace caf::net
@@ -76,25 +76,18 @@ public:
       error reason;
     };
 
-    struct timeout {
-      std::string type;
-      uint64_t id;
-    };
-
     event(uri locator, actor listener);
 
     event(node_id peer, actor_id proxy_id);
 
     event(node_id observing_peer, actor_id local_actor_id, error reason);
 
-    event(std::string type, uint64_t id);
-
     ~event() override;
 
     size_t task_size() const noexcept override;
 
     /// Holds the event data.
-    variant<resolve_request, new_proxy, local_actor_down, timeout> value;
+    variant<resolve_request, new_proxy, local_actor_down> value;
   };
 
   using event_ptr = std::unique_ptr<event>;
@@ -42,6 +42,7 @@ enum class ec : uint8_t;
 
 // -- classes ------------------------------------------------------------------
 
+class buffer_pool;
 class endpoint_manager;
 class middleman;
 class middleman_backend;
@@ -73,6 +74,9 @@ namespace caf::net::basp {
 
 enum class ec : uint8_t;
 
+class worker;
+class worker_pool;
+
 } // namespace caf::net::basp
 
 CAF_BEGIN_TYPE_ID_BLOCK(net_module, detail::net_module_begin)
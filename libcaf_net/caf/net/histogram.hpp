@@ -0,0 +1,99 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "caf/detail/net_export.hpp"
+
+namespace caf::net {
+
+/// A histogram with exponentially growing buckets that allows one thread to
+/// record values while other threads read the current state. Bucket 0 counts
+/// the value 0 and bucket `i > 0` counts values in `[2^(i-1), 2^i)`. The last
+/// bucket also counts all larger values.
+class CAF_NET_EXPORT histogram {
+public:
+  // -- constants --------------------------------------------------------------
+
+  /// Number of buckets. Sufficient for covering up to ~9 minutes when
+  /// recording durations in nanoseconds.
+  static constexpr size_t num_buckets = 40;
+
+  // -- member types -----------------------------------------------------------
+
+  /// A copy of the histogram state. Since readers do not synchronize with the
+  /// writer, the fields may be slightly out of sync with each other.
+  struct snapshot {
+    std::array<uint64_t, num_buckets> buckets;
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+
+    /// Returns the arithmetic mean of all recorded values.
+    double mean() const noexcept;
+
+    /// Returns an upper bound for the value at quantile `q`, e.g., 0.99 for
+    /// the 99th percentile.
+    /// @pre `0 <= q && q <= 1`
+    uint64_t quantile(double q) const noexcept;
+  };
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  histogram() noexcept;
+
+  histogram(const histogram&) = delete;
+
+  histogram& operator=(const histogram&) = delete;
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the bucket for `value`.
+  static size_t bucket_of(uint64_t value) noexcept;
+
+  /// Returns the exclusive upper bound of given bucket.
+  static uint64_t upper_bound(size_t bucket) noexcept;
+
+  /// Returns the current state of the histogram.
+  /// @thread-safe
+  snapshot read() const noexcept;
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Records a single value.
+  /// @note only one thread may record values at the same time.
+  void record(uint64_t value) noexcept;
+
+  /// Resets all counters. Each counter drops to zero atomically, but readers
+  /// may still observe a mix of old and zeroed counters.
+  /// @note only the thread that records values may reset the histogram.
+  void reset() noexcept;
+
+private:
+  std::array<std::atomic<uint64_t>, num_buckets> buckets_;
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_;
+  std::atomic<uint64_t> max_;
+};
+
+} // namespace caf::net
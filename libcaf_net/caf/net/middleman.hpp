@@ -18,10 +18,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <set>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "caf/actor_system.hpp"
 #include "caf/detail/net_export.hpp"
@@ -43,6 +45,8 @@ public:
 
   using middleman_backend_list = std::vector<middleman_backend_ptr>;
 
+  using multiplexer_list = std::vector<multiplexer_ptr>;
+
   // -- static utility functions -----------------------------------------------
 
   static void init_global_meta_objects();
@@ -125,10 +129,21 @@ public:
     return sys_.config();
   }
 
+  /// Returns the first multiplexer of the pool. This multiplexer always
+  /// exists and runs the listening sockets of all backends.
   const multiplexer_ptr& mpx() const noexcept {
-    return mpx_;
+    return mpxs_.front();
+  }
+
+  /// Returns all multiplexers of the pool.
+  const multiplexer_list& mpxs() const noexcept {
+    return mpxs_;
   }
 
+  /// Selects the multiplexer for a new socket manager by iterating the pool in
+  /// round-robin order.
+  const multiplexer_ptr& next_mpx() noexcept;
+
   middleman_backend* backend(string_view scheme) const noexcept;
 
   expected<uint16_t> port(string_view scheme) const;
@@ -155,14 +170,18 @@ private:
   /// Points to the parent system.
   actor_system& sys_;
 
-  /// Stores the global socket I/O multiplexer.
-  multiplexer_ptr mpx_;
+  /// Stores the socket I/O multiplexers. Each multiplexer runs in its own
+  /// thread unless the user enabled manual multiplexing.
+  multiplexer_list mpxs_;
+
+  /// Points to the next multiplexer for `next_mpx`.
+  std::atomic<size_t> next_mpx_;
 
   /// Stores all available backends for managing peers.
   middleman_backend_list backends_;
 
-  /// Runs the multiplexer's event loop
-  std::thread mpx_thread_;
+  /// Runs the event loops of the multiplexers.
+  std::vector<std::thread> mpx_threads_;
 };
 
 } // namespace caf::net
@@ -18,21 +18,39 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "caf/actor_clock.hpp"
 #include "caf/detail/net_export.hpp"
+#include "caf/intrusive/lifo_inbox.hpp"
+#include "caf/intrusive/singly_linked.hpp"
 #include "caf/net/fwd.hpp"
+#include "caf/net/histogram.hpp"
 #include "caf/net/operation.hpp"
+#include "caf/net/overload_policy.hpp"
 #include "caf/net/pipe_socket.hpp"
 #include "caf/net/socket.hpp"
+#include "caf/net/socket_manager.hpp"
+#include "caf/net/timer_wheel.hpp"
+#include "caf/net/uring.hpp"
 #include "caf/ref_counted.hpp"
+#include "caf/timespan.hpp"
 
 extern "C" {
 
 struct pollfd;
 
+#ifdef CAF_LINUX
+struct epoll_event;
+#endif // CAF_LINUX
+
 } // extern "C"
 
 namespace caf::net {
@@ -47,10 +65,91 @@ public:
 
   using manager_list = std::vector<socket_manager_ptr>;
 
+  /// Selects the system call for waiting on socket events.
+  enum class backend_type {
+    /// Uses `poll` (`WSAPoll` on Windows). Available on all platforms, but
+    /// scans the entire pollset on each iteration.
+    poll,
+    /// Uses `epoll` and only touches sockets that actually became ready.
+    /// Available on Linux only.
+    epoll,
+    /// Uses `io_uring`. Reads and writes of managers that support
+    /// completion-based I/O run in the kernel, while all other managers only
+    /// wait for readiness. Available on Linux only and falls back to `poll` if
+    /// the kernel doesn't support `io_uring`.
+    io_uring,
+  };
+
+  /// Enumerates all pollset updates that other threads may request.
+  enum class opcode : uint8_t {
+    register_reading,
+    register_writing,
+    close_pipe,
+    shutdown,
+  };
+
+  /// Carries a pollset update from another thread to the multiplexer.
+  struct command : intrusive::singly_linked<command> {
+    command(opcode x, socket_manager_ptr y) : op(x), mgr(std::move(y)) {
+      // nop
+    }
+
+    opcode op;
+
+    socket_manager_ptr mgr;
+  };
+
+  /// Configures the lock-free command queue.
+  struct command_policy {
+    using mapped_type = command;
+
+    using task_size_type = size_t;
+
+    using deleter_type = std::default_delete<command>;
+
+    using unique_pointer = std::unique_ptr<command, deleter_type>;
+  };
+
+  /// Stores pending pollset updates from other threads.
+  using command_queue = intrusive::lifo_inbox<command_policy>;
+
+  /// Collects runtime statistics of the event loop while metrics are enabled.
+  /// Other threads may read the histograms at any time.
+  struct event_loop_metrics {
+    /// Nanoseconds spent waiting in `poll`, `epoll_wait`, or
+    /// `io_uring_enter`.
+    histogram poll_wait;
+
+    /// Number of ready sockets per call to `poll` or `epoll_wait` or number
+    /// of completions per call to `io_uring_enter`.
+    histogram ready_events;
+
+    /// Nanoseconds spent in a single call to `handle_read_event`.
+    histogram read_handler;
+
+    /// Nanoseconds spent in a single call to `handle_write_event`.
+    histogram write_handler;
+
+    /// Number of calls to `register_reading` or `register_writing` from
+    /// threads other than the multiplexer thread.
+    std::atomic<size_t> cross_thread_registrations{0};
+  };
+
+  // -- constants --------------------------------------------------------------
+
+  /// The backend that a default-constructed multiplexer uses.
+#ifdef CAF_LINUX
+  static constexpr backend_type default_backend = backend_type::epoll;
+#else
+  static constexpr backend_type default_backend = backend_type::poll;
+#endif
+
   // -- constructors, destructors, and assignment operators --------------------
 
   multiplexer();
 
+  explicit multiplexer(backend_type backend);
+
   ~multiplexer();
 
   error init();
@@ -60,9 +159,84 @@ public:
   /// Returns the number of currently active socket managers.
   size_t num_socket_managers() const noexcept;
 
-  /// Returns the index of `mgr` in the pollset or `-1`.
+  /// Returns the index of `mgr` in the pollset or `-1`. Runs in constant time.
   ptrdiff_t index_of(const socket_manager_ptr& mgr);
 
+  /// Returns the system call this multiplexer uses for polling.
+  backend_type backend() const noexcept {
+    return backend_;
+  }
+
+  /// Returns the number of pending timeouts.
+  size_t num_timeouts() const noexcept {
+    return timers_.size();
+  }
+
+  /// Returns how long `run` spins with non-blocking polls before blocking.
+  timespan busy_poll_budget() const noexcept {
+    return busy_poll_budget_;
+  }
+
+  /// Sets how long `run` spins with non-blocking polls before blocking. A
+  /// budget of zero disables busy polling.
+  /// @pre `run` is not running yet
+  void busy_poll_budget(timespan x) noexcept {
+    busy_poll_budget_ = x;
+  }
+
+  /// Returns how often `run` found ready sockets while spinning.
+  /// @thread-safe
+  size_t busy_poll_hits() const noexcept {
+    return busy_poll_hits_.load(std::memory_order_relaxed);
+  }
+
+  /// Returns how often `run` exhausted its busy poll budget and fell back to
+  /// a blocking poll.
+  /// @thread-safe
+  size_t busy_poll_misses() const noexcept {
+    return busy_poll_misses_.load(std::memory_order_relaxed);
+  }
+
+  /// Returns whether the multiplexer records metrics.
+  bool metrics_enabled() const noexcept {
+    return metrics_enabled_.load(std::memory_order_relaxed);
+  }
+
+  /// Enables or disables recording of metrics.
+  void metrics_enabled(bool x) noexcept {
+    metrics_enabled_.store(x, std::memory_order_relaxed);
+  }
+
+  /// Returns the overload policy for new endpoint managers.
+  overload_policy default_overload_policy() const noexcept {
+    return default_overload_policy_;
+  }
+
+  /// Sets the overload policy for new endpoint managers.
+  /// @pre `run` is not running yet
+  void default_overload_policy(overload_policy x) noexcept {
+    default_overload_policy_ = x;
+  }
+
+  /// Returns the metrics of the event loop.
+  /// @thread-safe
+  const event_loop_metrics& metrics() const noexcept {
+    return metrics_;
+  }
+
+  // -- timeout management -----------------------------------------------------
+
+  /// Schedules a timeout that calls `mgr->handle_timeout(type, id)` at `tp`,
+  /// where `id` is the return value of this function.
+  /// @pre `std::this_thread::get_id() == tid_`
+  uint64_t set_timeout(actor_clock::time_point tp, socket_manager_ptr mgr,
+                       std::string type);
+
+  /// Cancels the timeout with given ID.
+  /// @returns `true` if the timeout was still pending, `false` otherwise.
+  /// @pre `std::this_thread::get_id() == tid_`
+  bool cancel_timeout(uint64_t id);
+
   // -- thread-safe signaling --------------------------------------------------
 
   /// Registers `mgr` for read events.
@@ -78,6 +252,11 @@ public:
   /// @thread-safe
   void close_pipe();
 
+  /// Runs all pending pollset updates from other threads.
+  /// @returns `false` if the command queue has been closed, `true` otherwise.
+  /// @private
+  bool handle_commands();
+
   // -- control flow -----------------------------------------------------------
 
   /// Polls I/O activity once and runs all socket event handlers that become
@@ -100,30 +279,188 @@ protected:
   /// Handles an I/O event on given manager.
   short handle(const socket_manager_ptr& mgr, short events, short revents);
 
+  /// Calls `mgr->handle_read_event()` and updates the metrics if enabled.
+  bool call_read_handler(const socket_manager_ptr& mgr);
+
+  /// Calls `mgr->handle_write_event()` and updates the metrics if enabled.
+  bool call_write_handler(const socket_manager_ptr& mgr);
+
+  /// Records the time spent waiting for events plus the number of events.
+  void record_poll(std::chrono::steady_clock::time_point start, int presult);
+
   /// Adds a new socket manager to the pollset.
   void add(socket_manager_ptr mgr);
 
-  /// Deletes a known socket manager from the pollset.
+  /// Deletes a known socket manager from the pollset by moving the last entry
+  /// into its slot. Invalidates the index of the last entry.
   void del(ptrdiff_t index);
 
-  /// Writes `opcode` and pointer to `mgr` the the pipe for handling an event
-  /// later via the pollset updater.
-  void write_to_pipe(uint8_t opcode, const socket_manager_ptr& mgr);
+  /// Updates the event bitmask for the socket manager at `index`.
+  void set_events(ptrdiff_t index, short events);
+
+  /// Returns the timeout argument for the next call to `poll` or
+  /// `epoll_wait`.
+  int poll_timeout(bool blocking);
+
+  /// Polls without blocking until either some socket becomes ready or the
+  /// busy poll budget runs out.
+  /// @returns `true` if at least one event occurred, `false` otherwise.
+  bool busy_poll();
+
+  /// Dispatches all expired timeouts to their socket managers.
+  /// @returns `true` if at least one timeout expired, `false` otherwise.
+  bool handle_timeouts();
+
+#ifdef CAF_LINUX
+  /// Implements `poll_once` for the epoll backend.
+  bool epoll_once(bool blocking);
+
+  /// Implements `poll_once` for the io_uring backend.
+  bool uring_once(bool blocking);
+
+  /// Schedules the manager at `index` for submitting new operations before
+  /// the next call to `io_uring_enter`.
+  void uring_mark_dirty(ptrdiff_t index);
+
+  /// Submits all operations that dirty managers require for their current
+  /// event mask and cancels operations they no longer need.
+  void uring_arm_dirty();
+
+  /// Submits or cancels operations for the manager at `index`.
+  void uring_arm(ptrdiff_t index);
+
+  /// Dispatches a single completion to its socket manager.
+  void uring_dispatch(const uring::completion& cqe);
+#endif // CAF_LINUX
+
+  /// Enqueues a pollset update for handling it later via the pollset updater.
+  /// Wakes up the multiplexer if the queue transitions from empty.
+  void push_command(opcode op, const socket_manager_ptr& mgr);
+
+  /// Wakes up the pollset updater by writing to the pipe.
+  void wakeup();
 
   // -- member variables -------------------------------------------------------
 
-  /// Bookkeeping data for managed sockets.
+  /// Selects the system call for polling.
+  backend_type backend_;
+
+  /// Bookkeeping data for managed sockets. Only used by the poll backend.
   pollfd_list pollset_;
 
+#ifdef CAF_LINUX
+  /// Refers to the kernel-side event table. Only used by the epoll backend.
+  int epoll_fd_;
+
+  /// Receives the results of `epoll_wait`.
+  std::vector<epoll_event> events_;
+
+  /// Keeps ready managers alive while dispatching events, since handlers may
+  /// remove other managers from the pollset.
+  std::vector<std::pair<socket_manager_ptr, short>> ready_;
+
+  /// Pins a socket manager and the arguments of its operation until the
+  /// kernel reports the completion.
+  struct uring_op {
+    socket_manager_ptr mgr;
+
+    /// Either `read` or `write` for completion-based I/O or `none` for a
+    /// readiness poll.
+    operation kind;
+
+    /// Stores the message header and I/O vectors of a write or a datagram
+    /// read.
+    uring::msg_args_ptr args;
+  };
+
+  /// Stores the pending operations of a socket manager. Only used by the
+  /// io_uring backend.
+  struct uring_state {
+    /// ID of the pending readiness poll or 0.
+    uint64_t poll_op = 0;
+
+    /// Event mask of the pending readiness poll.
+    short poll_events = 0;
+
+    /// ID of the pending read or 0.
+    uint64_t read_op = 0;
+
+    /// Signals that we have submitted a cancellation for `read_op`.
+    bool read_cancel_pending = false;
+
+    /// ID of the pending write or 0.
+    uint64_t write_op = 0;
+
+    /// Signals that the manager is in `uring_dirty_`.
+    bool dirty = false;
+  };
+
+  /// Maps operation IDs to their pending operations. Only used by the io_uring
+  /// backend. Must outlive `ring_`, because the kernel may access the buffers
+  /// of pending operations until closing the ring.
+  std::unordered_map<uint64_t, uring_op> uring_ops_;
+
+  /// Stores the pending operations per manager in the same order as
+  /// `managers_`. Only used by the io_uring backend.
+  std::vector<uring_state> uring_states_;
+
+  /// Lists managers that need new operations before the next submission.
+  std::vector<socket_manager_ptr> uring_dirty_;
+
+  /// Receives completions from the ring.
+  std::vector<uring::completion> completions_;
+
+  /// Stores the ID for the next operation. The IDs 0 and UINT64_MAX mark
+  /// timeouts and cancellations, respectively.
+  uint64_t next_uring_op_ = 1;
+
+  /// Submits operations to the kernel. Only used by the io_uring backend.
+  uring ring_;
+#endif // CAF_LINUX
+
   /// Maps sockets to their owning managers by storing the managers in the same
   /// order as their sockets appear in `pollset_`.
   manager_list managers_;
 
+  /// Maps managers to their position in `managers_` (and `pollset_`).
+  std::unordered_map<socket_manager*, size_t> indexes_;
+
+  /// Points to the pollset updater while it remains in the pollset.
+  socket_manager* updater_ = nullptr;
+
+  /// Schedules timeouts for the socket managers.
+  timer_wheel timers_;
+
+  /// Buffers expired timeouts while dispatching them.
+  timer_wheel::expired_list expired_;
+
+  /// Configures how long `run` spins before blocking.
+  timespan busy_poll_budget_{0};
+
+  /// Counts successful busy poll phases.
+  std::atomic<size_t> busy_poll_hits_{0};
+
+  /// Counts busy poll phases that ended in a blocking poll.
+  std::atomic<size_t> busy_poll_misses_{0};
+
+  /// Configures whether the multiplexer updates `metrics_`.
+  std::atomic<bool> metrics_enabled_{false};
+
+  /// Stores runtime statistics of the event loop.
+  event_loop_metrics metrics_;
+
+  /// Configures how new endpoint managers treat messages while overloaded.
+  overload_policy default_overload_policy_ = overload_policy::notify;
+
   /// Stores the ID of the thread this multiplexer is running in. Set when
   /// calling `init()`.
   std::thread::id tid_;
 
-  /// Used for pushing updates to the multiplexer's thread.
+  /// Stores pollset updates from other threads. The multiplexer drains this
+  /// queue in batches whenever the pollset updater becomes ready.
+  command_queue commands_;
+
+  /// Used for waking up the multiplexer's thread.
   pipe_socket write_handle_;
 
   /// Guards `write_handle_`.
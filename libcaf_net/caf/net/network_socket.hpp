@@ -55,6 +55,12 @@ expected<size_t> CAF_NET_EXPORT send_buffer_size(network_socket x);
 /// @relates network_socket
 error CAF_NET_EXPORT send_buffer_size(network_socket x, size_t capacity);
 
+/// Sets the approximate time in microseconds to busy poll on a blocking
+/// receive for `x` when there is no data (`SO_BUSY_POLL`). Passing 0 disables
+/// busy polling for `x`. Only available on Linux.
+/// @relates network_socket
+error CAF_NET_EXPORT busy_poll(network_socket x, size_t usec);
+
 /// Returns the locally assigned port of `x`.
 /// @relates network_socket
 expected<uint16_t> CAF_NET_EXPORT local_port(network_socket x);
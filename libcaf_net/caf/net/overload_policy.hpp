@@ -0,0 +1,38 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+#pragma once
+
+namespace caf::net {
+
+/// Configures how an endpoint manager treats new messages while its transport
+/// is overloaded.
+enum class overload_policy {
+  /// Enqueues all messages, regardless of the backlog. Leaves the memory
+  /// usage unbounded if the peer consumes data slower than actors produce it.
+  none,
+  /// Silently drops new messages.
+  drop,
+  /// Drops new messages and responds to requests with an error.
+  error,
+  /// Drops new messages and sends an error to each sender, including
+  /// senders of asynchronous messages. Senders should install an error
+  /// handler to back off instead of terminating. The default.
+  notify,
+};
+
+} // namespace caf::net
@@ -0,0 +1,184 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "caf/byte_buffer.hpp"
+#include "caf/config.hpp"
+#include "caf/span.hpp"
+
+namespace caf::net {
+
+/// A FIFO queue for outgoing datagrams. The queue stores packets in a ring of
+/// slots with room for up to `max_buffers` buffers each. Pushing a packet
+/// swaps the buffers into a slot and popping a packet leaves the (moved-from)
+/// buffers in place. Hence, the queue only allocates memory when growing
+/// beyond its current capacity and never while traffic is in a steady state.
+template <class Id>
+class packet_queue {
+public:
+  // -- constants --------------------------------------------------------------
+
+  /// Maximum number of buffers per packet. Matches `max_datagram_buffers`.
+  static constexpr size_t max_buffers = 10;
+
+  /// Number of slots after the first push.
+  static constexpr size_t initial_capacity = 16;
+
+  // -- member types -----------------------------------------------------------
+
+  /// Stores a single outgoing packet.
+  class packet {
+  public:
+    friend class packet_queue;
+
+    packet() = default;
+
+    packet(const packet&) = delete;
+
+    packet& operator=(const packet&) = delete;
+
+    /// Returns the destination of this packet.
+    const Id& id() const noexcept {
+      return id_;
+    }
+
+    /// Returns the number of bytes in this packet.
+    size_t size() const noexcept {
+      return size_;
+    }
+
+    /// Returns the buffers of this packet.
+    span<byte_buffer> buffers() noexcept {
+      return make_span(bufs_.data(), num_bufs_);
+    }
+
+    /// Returns pointers to the buffers of this packet for passing them to
+    /// `write`.
+    span<byte_buffer*> buffer_ptrs() noexcept {
+      return make_span(ptrs_.data(), num_bufs_);
+    }
+
+  private:
+    void assign(Id id, span<byte_buffer*> bufs) {
+      CAF_ASSERT(bufs.size() <= max_buffers);
+      id_ = std::move(id);
+      num_bufs_ = bufs.size();
+      size_ = 0;
+      for (size_t i = 0; i < num_bufs_; ++i) {
+        size_ += bufs[i]->size();
+        bufs_[i].swap(*bufs[i]);
+        ptrs_[i] = &bufs_[i];
+      }
+    }
+
+    void take(packet& other) {
+      id_ = std::move(other.id_);
+      num_bufs_ = other.num_bufs_;
+      size_ = other.size_;
+      for (size_t i = 0; i < num_bufs_; ++i) {
+        bufs_[i].swap(other.bufs_[i]);
+        ptrs_[i] = &bufs_[i];
+      }
+      other.reset();
+    }
+
+    void reset() {
+      for (size_t i = 0; i < num_bufs_; ++i)
+        bufs_[i].clear();
+      num_bufs_ = 0;
+      size_ = 0;
+    }
+
+    Id id_;
+    std::array<byte_buffer, max_buffers> bufs_;
+    std::array<byte_buffer*, max_buffers> ptrs_;
+    size_t num_bufs_ = 0;
+    size_t size_ = 0;
+  };
+
+  // -- properties -------------------------------------------------------------
+
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  /// Returns the number of packets this queue can store without allocating.
+  size_t capacity() const noexcept {
+    return slots_.size();
+  }
+
+  packet& front() noexcept {
+    CAF_ASSERT(!empty());
+    return slots_[first_];
+  }
+
+  /// Returns the packet at position `index`, starting at the front.
+  packet& operator[](size_t index) noexcept {
+    CAF_ASSERT(index < size_);
+    return slots_[(first_ + index) % slots_.size()];
+  }
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Appends a packet to the queue, taking the content of `bufs`.
+  /// @returns `false` if `bufs` contains more than `max_buffers` buffers, in
+  ///          which case the queue remains unchanged, `true` otherwise.
+  bool push_back(Id id, span<byte_buffer*> bufs) {
+    if (bufs.size() > max_buffers)
+      return false;
+    if (size_ == slots_.size())
+      grow();
+    slots_[(first_ + size_) % slots_.size()].assign(std::move(id), bufs);
+    ++size_;
+    return true;
+  }
+
+  /// Drops the first packet. Callers take ownership of the buffers by moving
+  /// them out of `front().buffers()` first.
+  void pop_front() {
+    CAF_ASSERT(!empty());
+    slots_[first_].reset();
+    first_ = (first_ + 1) % slots_.size();
+    --size_;
+  }
+
+private:
+  void grow() {
+    std::vector<packet> slots(slots_.empty() ? initial_capacity
+                                             : slots_.size() * 2);
+    for (size_t i = 0; i < size_; ++i)
+      slots[i].take((*this)[i]);
+    slots_.swap(slots);
+    first_ = 0;
+  }
+
+  std::vector<packet> slots_;
+  size_t first_ = 0;
+  size_t size_ = 0;
+};
+
+} // namespace caf::net
@@ -20,7 +20,9 @@
 
 #include "caf/net/packet_writer.hpp"
 
+#include "caf/actor_clock.hpp"
 #include "caf/byte_buffer.hpp"
+#include "caf/net/endpoint_manager.hpp"
 #include "caf/span.hpp"
 
 namespace caf::net {
@@ -67,13 +69,16 @@ public:
 
   // -- member functions -------------------------------------------------------
 
-  void cancel_timeout(std::string tag, uint64_t id) {
-    parent_.cancel_timeout(std::move(tag), id);
+  void cancel_timeout(uint64_t id) {
+    manager().cancel_timeout(id);
   }
 
   template <class... Ts>
-  uint64_t set_timeout(timestamp tout, std::string tag, Ts&&... xs) {
-    return parent_.set_timeout(tout, std::move(tag), std::forward<Ts>(xs)...);
+  uint64_t
+  set_timeout(actor_clock::time_point tout, std::string tag, Ts&&... xs) {
+    auto id = manager().set_timeout(tout, std::move(tag));
+    parent_.set_timeout(id, object_.id(), std::forward<Ts>(xs)...);
+    return id;
   }
 
 protected:
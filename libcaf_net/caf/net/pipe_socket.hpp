@@ -41,6 +41,13 @@ struct CAF_NET_EXPORT pipe_socket : socket {
 /// @relates pipe_socket
 expected<std::pair<pipe_socket, pipe_socket>> CAF_NET_EXPORT make_pipe();
 
+/// Creates two handles for waking up a thread that waits for read events on
+/// the first handle. Writing any 8-byte value to the second handle makes the
+/// first handle readable. Uses a single `eventfd` on Linux and falls back to
+/// `make_pipe` on other platforms.
+/// @relates pipe_socket
+expected<std::pair<pipe_socket, pipe_socket>> CAF_NET_EXPORT make_wakeup_pipe();
+
 /// Transmits data from `x` to its peer.
 /// @param x Connected endpoint.
 /// @param buf Memory region for reading the message to send.
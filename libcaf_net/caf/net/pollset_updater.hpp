@@ -20,7 +20,6 @@
 
 #include <array>
 #include <cstdint>
-#include <mutex>
 
 #include "caf/byte.hpp"
 #include "caf/net/pipe_socket.hpp"
@@ -28,13 +27,15 @@
 
 namespace caf::net {
 
+/// Drains the wakeup pipe of a multiplexer and then runs all pending commands
+/// from its command queue.
 class pollset_updater : public socket_manager {
 public:
   // -- member types -----------------------------------------------------------
 
   using super = socket_manager;
 
-  using msg_buf = std::array<byte, sizeof(intptr_t) + 1>;
+  using msg_buf = std::array<byte, 64>;
 
   // -- constructors, destructors, and assignment operators --------------------
 
@@ -59,7 +60,6 @@ public:
 
 private:
   msg_buf buf_;
-  size_t buf_size_;
 };
 
 } // namespace caf::net
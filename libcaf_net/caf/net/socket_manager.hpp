@@ -18,19 +18,45 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <string>
+
 #include "caf/detail/net_export.hpp"
 #include "caf/error.hpp"
 #include "caf/fwd.hpp"
 #include "caf/net/fwd.hpp"
 #include "caf/net/operation.hpp"
 #include "caf/net/socket.hpp"
+#include "caf/net/udp_datagram_socket.hpp"
 #include "caf/ref_counted.hpp"
+#include "caf/span.hpp"
+#include "caf/variant.hpp"
 
 namespace caf::net {
 
 /// Manages the lifetime of a single socket and handles any I/O events on it.
 class CAF_NET_EXPORT socket_manager : public ref_counted {
 public:
+  // -- member types -----------------------------------------------------------
+
+  /// Accumulates how often and how long the multiplexer ran the event
+  /// handlers of this manager. Only updated while the multiplexer has metrics
+  /// enabled.
+  struct handler_stats {
+    /// Number of calls to `handle_read_event`.
+    std::atomic<uint64_t> read_events{0};
+
+    /// Nanoseconds spent in `handle_read_event`.
+    std::atomic<uint64_t> read_time{0};
+
+    /// Number of calls to `handle_write_event`.
+    std::atomic<uint64_t> write_events{0};
+
+    /// Nanoseconds spent in `handle_write_event`.
+    std::atomic<uint64_t> write_time{0};
+  };
+
   // -- constructors, destructors, and assignment operators --------------------
 
   /// @pre `parent != nullptr`
@@ -55,6 +81,16 @@ public:
     return parent_.lock();
   }
 
+  /// Returns the event handler statistics for this manager.
+  handler_stats& stats() noexcept {
+    return stats_;
+  }
+
+  /// Returns the event handler statistics for this manager.
+  const handler_stats& stats() const noexcept {
+    return stats_;
+  }
+
   /// Returns registered operations (read, write, or both).
   operation mask() const noexcept {
     return mask_;
@@ -88,6 +124,72 @@ public:
   /// @param code The error code as reported by the operating system.
   virtual void handle_error(sec code) = 0;
 
+  // -- virtual member functions -----------------------------------------------
+
+  /// Called when a timeout scheduled via `multiplexer::set_timeout` expires.
+  /// The default implementation does nothing.
+  /// @param type The type tag of the timeout.
+  /// @param id The ID of the timeout.
+  virtual void handle_timeout(std::string type, uint64_t id);
+
+  /// Called when the multiplexer reports an error condition on the socket
+  /// that might only signal pending messages in the error queue, e.g.,
+  /// completion notifications for zero-copy writes. The default implementation
+  /// returns `false`.
+  /// @returns `true` if the manager consumed the error queue and the socket
+  ///          remains usable, `false` if the multiplexer should treat the
+  ///          event as an error.
+  virtual bool handle_error_queue_event();
+
+  // -- completion-based I/O ---------------------------------------------------
+
+  /// Queries whether this manager supports completion-based I/O. Multiplexer
+  /// backends such as io_uring submit the actual reads and writes on behalf of
+  /// such managers instead of only waiting for readiness. The default
+  /// implementation returns `false`.
+  virtual bool supports_completions() const noexcept;
+
+  /// Returns the buffer for the next read operation. The buffer must remain
+  /// valid until the multiplexer calls `handle_read_completion`. The default
+  /// implementation returns an empty span.
+  virtual span<byte> read_buffer();
+
+  /// Called after a read operation on the buffer from `read_buffer` completed.
+  /// @returns `false` if the manager no longer wants to read, `true`
+  ///          otherwise.
+  virtual bool handle_read_completion(variant<size_t, sec> result);
+
+  /// Returns the buffers for the next write operation. The buffers must remain
+  /// valid until the multiplexer calls `handle_write_completion`. An empty
+  /// result signals that the manager has nothing to write. The default
+  /// implementation returns an empty span.
+  virtual span<const span<const byte>> write_buffers();
+
+  /// Called after a write operation on the buffers from `write_buffers`
+  /// completed.
+  /// @returns `false` if the manager no longer wants to write, `true`
+  ///          otherwise.
+  virtual bool handle_write_completion(variant<size_t, sec> result);
+
+  /// Queries whether this manager reads and writes datagrams on an
+  /// unconnected socket. The multiplexer then reports each received datagram
+  /// via `handle_datagram_completion` and sends the buffers from
+  /// `write_buffers` as one datagram to `write_destination`. The default
+  /// implementation returns `false`.
+  virtual bool uses_datagrams() const noexcept;
+
+  /// Called instead of `handle_read_completion` after receiving a datagram
+  /// into the buffer from `read_buffer`.
+  /// @returns `false` if the manager no longer wants to read, `true`
+  ///          otherwise.
+  virtual bool
+  handle_datagram_completion(variant<received_datagram, sec> result);
+
+  /// Returns the receiver of the buffers from the last call to
+  /// `write_buffers`. The default implementation returns a default-constructed
+  /// endpoint.
+  virtual ip_endpoint write_destination();
+
 protected:
   // -- member variables -------------------------------------------------------
 
@@ -96,6 +198,8 @@ protected:
   operation mask_;
 
   weak_multiplexer_ptr parent_;
+
+  handler_stats stats_;
 };
 
 using socket_manager_ptr = intrusive_ptr<socket_manager>;
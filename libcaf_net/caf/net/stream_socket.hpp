@@ -74,6 +74,50 @@ variant<size_t, sec> CAF_NET_EXPORT write(stream_socket x,
 variant<size_t, sec> CAF_NET_EXPORT
 write(stream_socket x, std::initializer_list<span<const byte>> bufs);
 
+/// Maximum number of buffers that a single call to `write` with a list of
+/// buffers transmits. Corresponds to `IOV_MAX` on POSIX systems.
+/// @relates stream_socket
+CAF_NET_EXPORT extern const size_t max_write_buffers;
+
+/// Transmits data from `x` to its peer with a single gather write.
+/// @param x Connected endpoint.
+/// @param bufs Points to the message to send, scattered across any number of
+///             buffers. Only considers the first `max_write_buffers` buffers.
+/// @returns The number of written bytes on success, otherwise an error code.
+/// @relates stream_socket
+/// @post either the result is a `sec` or a positive (non-zero) integer
+variant<size_t, sec> CAF_NET_EXPORT write(stream_socket x,
+                                          span<const span<const byte>> bufs);
+
+/// Enables or disables zero-copy transmission via `MSG_ZEROCOPY` on `x`.
+/// Requires Linux 4.14 or later.
+/// @relates stream_socket
+error CAF_NET_EXPORT zerocopy(stream_socket x, bool new_value);
+
+/// Transmits data from `x` to its peer without copying the data into the
+/// kernel. The caller must keep `buf` alive and unmodified until the kernel
+/// reports completion of this call via `read_zerocopy_completions`. Each
+/// successful call increments a per-socket sequence number, starting at 0.
+/// Returns `sec::feature_disabled` if the kernel currently cannot pin any more
+/// pages (`ENOBUFS`), in which case callers may fall back to `write`.
+/// @param x Connected endpoint with zero-copy transmission enabled.
+/// @param buf Points to the message to send.
+/// @returns The number of written bytes on success, otherwise an error code.
+/// @relates stream_socket
+/// @post either the result is a `sec` or a positive (non-zero) integer
+variant<size_t, sec> CAF_NET_EXPORT write_zerocopy(stream_socket x,
+                                                   span<const byte> buf);
+
+/// Drains the error queue of `x` and stores the highest sequence number of
+/// all completed zero-copy writes in `last_completed`. Sets `copied` to `true`
+/// if the kernel reported that it fell back to copying the data for any of
+/// the completed writes.
+/// @returns The number of received completion notifications on success (0 if
+///          the error queue was empty), otherwise an error code.
+/// @relates stream_socket
+variant<size_t, sec> CAF_NET_EXPORT read_zerocopy_completions(
+  stream_socket x, uint32_t& last_completed, bool& copied);
+
 /// Converts the result from I/O operation on a ::stream_socket to either an
 /// error code or a non-zero positive integer.
 /// @relates stream_socket
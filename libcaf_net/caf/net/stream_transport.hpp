@@ -18,11 +18,16 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <deque>
+#include <vector>
 
 #include "caf/byte_buffer.hpp"
 #include "caf/fwd.hpp"
 #include "caf/logger.hpp"
+#include "caf/net/buffer_pool.hpp"
+#include "caf/net/defaults.hpp"
 #include "caf/net/endpoint_manager.hpp"
 #include "caf/net/fwd.hpp"
 #include "caf/net/receive_policy.hpp"
@@ -31,6 +36,7 @@
 #include "caf/net/transport_worker.hpp"
 #include "caf/sec.hpp"
 #include "caf/span.hpp"
+#include "caf/variant.hpp"
 
 namespace caf::net {
 
@@ -55,13 +61,30 @@ public:
 
   using write_queue_type = std::deque<std::pair<bool, byte_buffer>>;
 
+  // -- constants --------------------------------------------------------------
+
+  /// Number of bytes that the transport serializes at most before trying to
+  /// write to the socket.
+  static constexpr size_t write_chunk_size = 64 * 1024;
+
   // -- constructors, destructors, and assignment operators --------------------
 
   stream_transport(stream_socket handle, application_type application)
     : super(handle, std::move(application)),
       written_(0),
-      read_threshold_(1024),
-      collected_(0),
+      queued_bytes_(0),
+      high_watermark_(defaults::middleman::write_queue_high_watermark),
+      low_watermark_(defaults::middleman::write_queue_low_watermark),
+      zerocopy_threshold_(0),
+      zerocopy_seq_(0),
+      front_zerocopy_(false),
+      handoff_threshold_(0),
+      handoff_size_(0),
+      handoff_active_(false),
+      read_into_handoff_(false),
+      read_buf_max_size_(defaults::middleman::stream_read_buffer_max_size),
+      read_begin_(0),
+      read_end_(0),
       max_(1024),
       rd_flag_(net::receive_policy_flag::exactly) {
     CAF_ASSERT(handle != invalid_socket);
@@ -71,26 +94,51 @@ public:
 
   // -- member functions -------------------------------------------------------
 
+  error init(endpoint_manager& parent) override {
+    auto& cfg = this->system().config();
+    auto size = get_or(cfg, "middleman.stream-read-buffer-size",
+                       defaults::middleman::stream_read_buffer_size);
+    read_buf_max_size_ = std::max(
+      size, get_or(cfg, "middleman.stream-read-buffer-max-size",
+                   defaults::middleman::stream_read_buffer_max_size));
+    this->read_buf_.resize(std::max(size, max_));
+    high_watermark_ = std::max(
+      size_t{1}, get_or(cfg, "middleman.write-queue-high-watermark",
+                        defaults::middleman::write_queue_high_watermark));
+    low_watermark_ = std::min(
+      high_watermark_, get_or(cfg, "middleman.write-queue-low-watermark",
+                              defaults::middleman::write_queue_low_watermark));
+    if constexpr (worker_type::accepts_owned_data)
+      handoff_threshold_ = get_or(cfg, "middleman.stream-handoff-threshold",
+                                  defaults::middleman::stream_handoff_threshold);
+    zerocopy_threshold_ = get_or(cfg, "middleman.zerocopy-threshold",
+                                 defaults::middleman::zerocopy_threshold);
+    if (zerocopy_threshold_ > 0) {
+      if (auto err = zerocopy(this->handle(), true)) {
+        CAF_LOG_WARNING("unable to enable zero-copy writes:" << err);
+        zerocopy_threshold_ = 0;
+      }
+    }
+    return super::init(parent);
+  }
+
   bool handle_read_event(endpoint_manager&) override {
     CAF_LOG_TRACE(CAF_ARG2("handle", this->handle().id));
     for (size_t reads = 0; reads < this->max_consecutive_reads_; ++reads) {
-      auto buf = this->read_buf_.data() + this->collected_;
-      size_t len = this->read_threshold_ - this->collected_;
-      CAF_LOG_DEBUG(CAF_ARG2("missing", len));
-      auto ret = read(this->handle_, make_span(buf, len));
+      auto buf = next_read_buffer();
+      CAF_LOG_DEBUG(CAF_ARG2("free", buf.size())
+                    << CAF_ARG2("into_handoff", read_into_handoff_));
+      auto ret = read(this->handle_, buf);
       // Update state.
       if (auto num_bytes = get_if<size_t>(&ret)) {
-        CAF_LOG_DEBUG(CAF_ARG(len)
+        CAF_LOG_DEBUG(CAF_ARG2("len", buf.size())
                       << CAF_ARG(this->handle_.id) << CAF_ARG(*num_bytes));
-        this->collected_ += *num_bytes;
-        if (this->collected_ >= this->read_threshold_) {
-          if (auto err = this->next_layer_.handle_data(
-                *this, make_span(this->read_buf_))) {
-            CAF_LOG_ERROR("handle_data failed: " << CAF_ARG(err));
-            return false;
-          }
-          this->prepare_next_read();
-        }
+        if (!handle_received(*num_bytes))
+          return false;
+        // A short read means that the socket buffer is empty. Trying again
+        // would only cost us another syscall that fails with EAGAIN.
+        if (*num_bytes < buf.size())
+          break;
       } else {
         auto err = get<sec>(ret);
         if (err == sec::unavailable_or_would_block) {
@@ -108,36 +156,52 @@ public:
   bool handle_write_event(endpoint_manager& manager) override {
     CAF_LOG_TRACE(CAF_ARG2("handle", this->handle_.id)
                   << CAF_ARG2("queue-size", write_queue_.size()));
+    if (!zerocopy_pending_.empty())
+      read_zerocopy_completions();
     auto drain_write_queue = [this]() -> error_code<sec> {
-      // Helper function to sort empty buffers back into the right caches.
-      auto recycle = [this]() {
-        auto& front = this->write_queue_.front();
-        auto& is_header = front.first;
-        auto& buf = front.second;
-        written_ = 0;
-        buf.clear();
-        if (is_header) {
-          if (this->header_bufs_.size() < this->header_bufs_.capacity())
-            this->header_bufs_.emplace_back(std::move(buf));
-        } else if (this->payload_bufs_.size()
-                   < this->payload_bufs_.capacity()) {
-          this->payload_bufs_.emplace_back(std::move(buf));
-        }
-        write_queue_.pop_front();
-      };
-      // Write buffers from the write_queue_ for as long as possible.
+      // Write buffers from the write_queue_ for as long as possible, passing
+      // as many buffers as possible to a single gather write. Large payloads
+      // go out individually with a zero-copy write if enabled.
       while (!write_queue_.empty()) {
-        auto& buf = write_queue_.front().second;
-        CAF_ASSERT(!buf.empty());
-        auto data = buf.data() + written_;
-        auto len = buf.size() - written_;
-        auto write_ret = write(this->handle(), make_span(data, len));
+        variant<size_t, sec> write_ret;
+        size_t total = 0;
+        if (use_zerocopy(write_queue_.front())) {
+          auto& buf = write_queue_.front().second;
+          auto data = make_span(buf.data() + written_, buf.size() - written_);
+          total = data.size();
+          write_ret = write_zerocopy(this->handle(), data);
+          if (holds_alternative<size_t>(write_ret)) {
+            ++zerocopy_seq_;
+            front_zerocopy_ = true;
+          } else if (get<sec>(write_ret) == sec::feature_disabled) {
+            // The kernel can't pin any more pages right now.
+            write_ret = write(this->handle(), data);
+          }
+        } else {
+          write_batch_.clear();
+          for (auto& entry : write_queue_) {
+            if (write_batch_.size() == max_write_buffers
+                || (!write_batch_.empty() && use_zerocopy(entry)))
+              break;
+            auto& buf = entry.second;
+            CAF_ASSERT(!buf.empty());
+            auto offset = write_batch_.empty() ? written_ : size_t{0};
+            write_batch_.emplace_back(buf.data() + offset,
+                                      buf.size() - offset);
+            total += buf.size() - offset;
+          }
+          write_ret = write(this->handle(),
+                            span<const span<const byte>>{write_batch_});
+        }
         if (auto num_bytes = get_if<size_t>(&write_ret)) {
-          CAF_LOG_DEBUG(CAF_ARG(this->handle_.id) << CAF_ARG(*num_bytes));
-          written_ += *num_bytes;
-          if (written_ >= buf.size()) {
-            recycle();
-            written_ = 0;
+          CAF_LOG_DEBUG(CAF_ARG(this->handle_.id)
+                        << CAF_ARG(*num_bytes)
+                        << CAF_ARG2("buffers", write_batch_.size()));
+          consume_written(*num_bytes);
+          if (*num_bytes < total) {
+            // A short write means that the socket buffer is full. Wait for
+            // the next write event instead of provoking an EAGAIN.
+            return sec::unavailable_or_would_block;
           }
         } else {
           auto err = get<sec>(write_ret);
@@ -150,19 +214,22 @@ public:
       }
       return none;
     };
-    auto fetch_next_message = [&] {
-      if (auto msg = manager.next_message()) {
-        this->next_layer_.write_message(*this, std::move(msg));
-        return true;
+    // Alternate between serializing a chunk of pending messages and writing
+    // it, so that the first bytes hit the wire early while still sending
+    // multiple messages at once.
+    for (;;) {
+      fetch_write_chunk(manager);
+      if (write_queue_.empty()) {
+        update_overload_state();
+        return false;
       }
-      return false;
-    };
-    do {
-      if (auto err = drain_write_queue())
+      if (auto err = drain_write_queue()) {
+        if (err == sec::unavailable_or_would_block)
+          fetch_until_high_watermark(manager);
+        update_overload_state();
         return err == sec::unavailable_or_would_block;
-    } while (fetch_next_message());
-    CAF_ASSERT(write_queue_.empty());
-    return false;
+      }
+    }
   }
 
   void write_packet(id_type, span<byte_buffer*> buffers) override {
@@ -172,49 +239,388 @@ public:
       this->manager().register_writing();
     // By convention, the first buffer is a header buffer. Every other buffer is
     // a payload buffer.
+    for (auto buf : buffers)
+      queued_bytes_ += buf->size();
     auto i = buffers.begin();
     this->write_queue_.emplace_back(true, std::move(*(*i++)));
     while (i != buffers.end())
       this->write_queue_.emplace_back(false, std::move(*(*i++)));
   }
 
+  /// Returns the number of bytes in the write queue.
+  size_t queued_bytes() const noexcept {
+    return queued_bytes_;
+  }
+
+  /// Consumes completion notifications for zero-copy writes.
+  /// @returns `false` if the error queue contained no notification or the
+  ///          transport never expects one, `true` otherwise.
+  bool handle_error_queue_event(endpoint_manager&) {
+    // Writes from before disabling zero-copy may still report completion.
+    auto expect_notifications = zerocopy_threshold_ > 0 || front_zerocopy_
+                                || !zerocopy_pending_.empty();
+    return expect_notifications && read_zerocopy_completions() > 0;
+  }
+
+  /// Returns whether the transport uses zero-copy writes for large payloads.
+  bool zerocopy_enabled() const noexcept {
+    return zerocopy_threshold_ > 0;
+  }
+
+  /// Returns the number of written buffers that wait for the kernel to
+  /// report completion of their zero-copy write.
+  size_t zerocopy_pending() const noexcept {
+    return zerocopy_pending_.size();
+  }
+
   void configure_read(receive_policy::config cfg) override {
+    // Takes effect for the next message in the receive buffer. Since we never
+    // shrink the buffer, this function usually doesn't allocate.
     rd_flag_ = cfg.first;
     max_ = cfg.second;
-    prepare_next_read();
+  }
+
+  // -- completion-based I/O ---------------------------------------------------
+
+  /// Returns the buffer for the next read. Used by multiplexer backends that
+  /// read on behalf of the transport.
+  span<byte> read_buffer(endpoint_manager&) {
+    return next_read_buffer();
+  }
+
+  /// Processes the result of a read into the buffer from `read_buffer`.
+  /// @returns `false` if the transport stops reading, `true` otherwise.
+  bool handle_read_completion(endpoint_manager&, variant<size_t, sec> result) {
+    if (auto num_bytes = get_if<size_t>(&result)) {
+      CAF_LOG_DEBUG(CAF_ARG(this->handle_.id) << CAF_ARG(*num_bytes));
+      return handle_received(*num_bytes);
+    }
+    auto err = get<sec>(result);
+    if (err == sec::unavailable_or_would_block)
+      return true;
+    CAF_LOG_DEBUG("read failed" << CAF_ARG(err));
+    this->next_layer_.handle_error(err);
+    return false;
+  }
+
+  /// Returns the buffers for the next write after serializing a chunk of
+  /// pending messages. Used by multiplexer backends that write on behalf of
+  /// the transport. Never uses zero-copy writes.
+  /// @returns an empty span if the write queue is empty.
+  span<const span<const byte>> write_buffers(endpoint_manager& manager) {
+    CAF_LOG_TRACE(CAF_ARG2("handle", this->handle_.id)
+                  << CAF_ARG2("queue-size", write_queue_.size()));
+    fetch_write_chunk(manager);
+    write_batch_.clear();
+    for (auto& entry : write_queue_) {
+      if (write_batch_.size() == max_write_buffers)
+        break;
+      auto& buf = entry.second;
+      auto offset = write_batch_.empty() ? written_ : size_t{0};
+      write_batch_.emplace_back(buf.data() + offset, buf.size() - offset);
+    }
+    update_overload_state();
+    return span<const span<const byte>>{write_batch_};
+  }
+
+  /// Processes the result of a write of the buffers from `write_buffers`.
+  /// @returns `false` if the transport stops writing, `true` otherwise.
+  bool handle_write_completion(endpoint_manager& manager,
+                               variant<size_t, sec> result) {
+    if (auto num_bytes = get_if<size_t>(&result)) {
+      CAF_LOG_DEBUG(CAF_ARG(this->handle_.id) << CAF_ARG(*num_bytes));
+      size_t total = 0;
+      for (auto& buf : write_batch_)
+        total += buf.size();
+      write_batch_.clear();
+      consume_written(*num_bytes);
+      // A short write means that the socket buffer is full.
+      if (*num_bytes < total)
+        fetch_until_high_watermark(manager);
+      update_overload_state();
+      return true;
+    }
+    auto err = get<sec>(result);
+    if (err == sec::unavailable_or_would_block)
+      return true;
+    CAF_LOG_DEBUG("send failed" << CAF_ARG(err));
+    this->next_layer_.handle_error(err);
+    return false;
   }
 
 private:
   // -- utility functions ------------------------------------------------------
 
-  void prepare_next_read() {
-    collected_ = 0;
+  /// Serializes pending messages until the write queue holds enough data for
+  /// a single gather write.
+  void fetch_write_chunk(endpoint_manager& manager) {
+    auto limit = std::min(write_chunk_size, high_watermark_);
+    while (queued_bytes_ < limit && write_queue_.size() < max_write_buffers
+           && fetch_next_message(manager))
+      ; // nop
+  }
+
+  /// Serializes pending messages until reaching the high watermark. Called
+  /// while the socket blocks to make the backlog visible to the overload
+  /// detection. Any further message remains in the queue of the manager.
+  void fetch_until_high_watermark(endpoint_manager& manager) {
+    while (queued_bytes_ < high_watermark_ && fetch_next_message(manager))
+      ; // nop
+  }
+
+  /// Passes the next message from the queue of `manager` to the application
+  /// for serializing it into the write queue.
+  /// @returns `false` if the queue had no message, `true` otherwise.
+  bool fetch_next_message(endpoint_manager& manager) {
+    if (auto msg = manager.next_message()) {
+      this->next_layer_.write_message(*this, std::move(msg));
+      return true;
+    }
+    return false;
+  }
+
+  /// Removes the fully written buffer at the front of the write queue.
+  void pop_front() {
+    auto& front = write_queue_.front();
+    queued_bytes_ -= front.second.size();
+    if (front_zerocopy_) {
+      // The kernel may still read from this buffer.
+      zerocopy_pending_.emplace_back(zerocopy_seq_ - 1,
+                                     std::move(front.second));
+      front_zerocopy_ = false;
+    } else {
+      this->recycle(front.second, front.first);
+    }
+    written_ = 0;
+    write_queue_.pop_front();
+  }
+
+  /// Drops all fully written buffers after writing `num_bytes` and remembers
+  /// the offset into the first buffer that remains in the queue.
+  void consume_written(size_t num_bytes) {
+    while (num_bytes > 0) {
+      auto pending = write_queue_.front().second.size() - written_;
+      if (num_bytes < pending) {
+        written_ += num_bytes;
+        break;
+      }
+      num_bytes -= pending;
+      pop_front();
+    }
+  }
+
+  /// Returns the free space for the next read, i.e., either the remainder of
+  /// the handoff buffer or the end of the receive buffer.
+  span<byte> next_read_buffer() {
+    // Large payloads go straight into their own buffer, which we then pass on
+    // to the application.
+    read_into_handoff_ = handoff_active_;
+    if (read_into_handoff_) {
+      // Grow the buffer only by the next read instead of zeroing the whole
+      // message upfront. `handle_received` shrinks it to the received bytes.
+      auto n = std::min(max_ - handoff_size_, this->read_buf_.size());
+      handoff_buf_.resize(handoff_size_ + n);
+      return make_span(handoff_buf_.data() + handoff_size_, n);
+    }
+    prepare_next_read();
+    return make_span(this->read_buf_.data() + read_end_,
+                     this->read_buf_.size() - read_end_);
+  }
+
+  /// Accounts for `num_bytes` received into the buffer from
+  /// `next_read_buffer` and hands all complete messages to the application.
+  bool handle_received(size_t num_bytes) {
+    if (read_into_handoff_) {
+      handoff_size_ += num_bytes;
+      handoff_buf_.resize(handoff_size_);
+    } else {
+      read_end_ += num_bytes;
+      // A read that fills the buffer indicates more pending data. Grow the
+      // buffer for delivering more messages per read next time.
+      auto& buf = this->read_buf_;
+      if (read_end_ == buf.size() && buf.size() < read_buf_max_size_)
+        buf.resize(std::min(buf.size() * 2, read_buf_max_size_));
+    }
+    return deliver_buffered_data();
+  }
+
+  /// Signals overload to the manager above the high watermark and clears the
+  /// signal again once the write queue drains below the low watermark.
+  void update_overload_state() {
+    auto& mgr = this->manager();
+    if (queued_bytes_ >= high_watermark_)
+      mgr.overloaded(true);
+    else if (queued_bytes_ <= low_watermark_)
+      mgr.overloaded(false);
+  }
+
+  /// Checks whether `entry` qualifies for a zero-copy write.
+  bool use_zerocopy(const typename write_queue_type::value_type& entry) const {
+    return zerocopy_threshold_ > 0 && !entry.first
+           && entry.second.size() >= zerocopy_threshold_;
+  }
+
+  /// Reads completion notifications from the error queue and recycles all
+  /// buffers that the kernel no longer reads from.
+  /// @returns the number of received notifications.
+  size_t read_zerocopy_completions() {
+    uint32_t last_completed = 0;
+    bool copied = false;
+    auto ret = net::read_zerocopy_completions(this->handle(), last_completed,
+                                              copied);
+    auto num_notifications = get_if<size_t>(&ret);
+    if (num_notifications == nullptr) {
+      CAF_LOG_DEBUG("reading the error queue failed" << CAF_ARG(get<sec>(ret)));
+      return 0;
+    }
+    if (*num_notifications == 0)
+      return 0;
+    if (copied && zerocopy_threshold_ > 0) {
+      // Pinning pages only adds overhead if the kernel copies anyway, e.g.,
+      // on the loopback device.
+      CAF_LOG_DEBUG("disable zero-copy writes after the kernel copied data");
+      zerocopy_threshold_ = 0;
+    }
+    // TCP completes zero-copy writes in order. The subtraction handles
+    // wrap-arounds of the sequence number.
+    while (!zerocopy_pending_.empty()
+           && static_cast<int32_t>(zerocopy_pending_.front().first
+                                   - last_completed)
+                <= 0) {
+      this->recycle(zerocopy_pending_.front().second, false);
+      zerocopy_pending_.pop_front();
+    }
+    return *num_notifications;
+  }
+
+  /// Returns how many buffered bytes the application receives next or 0 if
+  /// the buffer doesn't contain enough data yet.
+  size_t next_message_size() const noexcept {
+    auto available = read_end_ - read_begin_;
     switch (rd_flag_) {
       case net::receive_policy_flag::exactly:
-        if (this->read_buf_.size() != max_)
-          this->read_buf_.resize(max_);
-        read_threshold_ = max_;
-        break;
+        return available >= max_ ? max_ : 0;
       case net::receive_policy_flag::at_most:
-        if (this->read_buf_.size() != max_)
-          this->read_buf_.resize(max_);
-        read_threshold_ = 1;
-        break;
-      case net::receive_policy_flag::at_least: {
-        // read up to 10% more, but at least allow 100 bytes more
-        auto max_size = max_ + std::max<size_t>(100, max_ / 10);
-        if (this->read_buf_.size() != max_size)
-          this->read_buf_.resize(max_size);
-        read_threshold_ = max_;
+        return std::min(available, max_);
+      case net::receive_policy_flag::at_least:
+        // Deliver up to 10% more, but at least allow 100 bytes more.
+        return available >= max_ ? std::min(available, at_least_limit()) : 0;
+    }
+    return 0;
+  }
+
+  /// Returns the maximum number of bytes for an `at_least` receive policy.
+  size_t at_least_limit() const noexcept {
+    return max_ + std::max<size_t>(100, max_ / 10);
+  }
+
+  /// Checks whether the application receives the next message in a separate
+  /// buffer that it may take ownership of.
+  bool use_handoff() const noexcept {
+    return handoff_threshold_ > 0
+           && rd_flag_ == net::receive_policy_flag::exactly
+           && max_ >= handoff_threshold_;
+  }
+
+  /// Passes all complete messages from the receive buffer to the application.
+  bool deliver_buffered_data() {
+    for (;;) {
+      if (handoff_active_ || use_handoff()) {
+        fill_handoff_buffer();
+        if (handoff_size_ < max_)
+          break;
+        if (!deliver_handoff_buffer())
+          return false;
+      } else if (auto size = next_message_size()) {
+        auto msg = make_span(this->read_buf_.data() + read_begin_, size);
+        read_begin_ += size;
+        if (auto err = this->next_layer_.handle_data(*this, msg)) {
+          CAF_LOG_ERROR("handle_data failed: " << CAF_ARG(err));
+          return false;
+        }
+      } else {
         break;
       }
     }
+    if (read_begin_ == read_end_)
+      read_begin_ = read_end_ = 0;
+    return true;
+  }
+
+  /// Moves already received bytes of the next message into the handoff
+  /// buffer, acquiring a fresh buffer from the pool first if necessary.
+  void fill_handoff_buffer() {
+    if (!handoff_active_) {
+      // Pooled buffers are empty, but may have less capacity than we need.
+      handoff_buf_ = buffer_pool::instance().acquire(max_);
+      handoff_buf_.reserve(max_);
+      handoff_size_ = 0;
+      handoff_active_ = true;
+    }
+    auto num_bytes = std::min(read_end_ - read_begin_, max_ - handoff_size_);
+    if (num_bytes > 0) {
+      auto first = this->read_buf_.data() + read_begin_;
+      handoff_buf_.insert(handoff_buf_.end(), first, first + num_bytes);
+      read_begin_ += num_bytes;
+      handoff_size_ += num_bytes;
+    }
+  }
+
+  /// Passes the complete handoff buffer to the application.
+  bool deliver_handoff_buffer() {
+    auto err = this->next_layer_.handle_owned_data(*this, handoff_buf_);
+    // Recycle the buffer unless the application took it.
+    if (!handoff_buf_.empty())
+      buffer_pool::instance().release(std::move(handoff_buf_));
+    handoff_buf_ = byte_buffer{};
+    handoff_size_ = 0;
+    handoff_active_ = false;
+    if (err) {
+      CAF_LOG_ERROR("handle_owned_data failed: " << CAF_ARG(err));
+      return false;
+    }
+    return true;
+  }
+
+  /// Makes room for the next read by moving unconsumed data to the front of
+  /// the buffer and growing the buffer for messages that don't fit.
+  void prepare_next_read() {
+    auto required = rd_flag_ == net::receive_policy_flag::at_least
+                      ? at_least_limit()
+                      : max_;
+    auto& buf = this->read_buf_;
+    auto pending = read_end_ - read_begin_;
+    // Only move data around if the remaining space runs low, since this
+    // copies all pending bytes.
+    auto free_space = buf.size() - read_end_;
+    if (read_begin_ > 0
+        && (free_space < buf.size() / 4 || read_begin_ + required > buf.size())) {
+      memmove(buf.data(), buf.data() + read_begin_, pending);
+      read_begin_ = 0;
+      read_end_ = pending;
+    }
+    if (buf.size() < required)
+      buf.resize(required);
   }
 
   write_queue_type write_queue_;
+  std::vector<span<const byte>> write_batch_;
   size_t written_;
-  size_t read_threshold_;
-  size_t collected_;
+  size_t queued_bytes_;
+  size_t high_watermark_;
+  size_t low_watermark_;
+  size_t zerocopy_threshold_;
+  uint32_t zerocopy_seq_;
+  bool front_zerocopy_;
+  std::deque<std::pair<uint32_t, byte_buffer>> zerocopy_pending_;
+  size_t handoff_threshold_;
+  byte_buffer handoff_buf_;
+  size_t handoff_size_;
+  bool handoff_active_;
+  bool read_into_handoff_;
+  size_t read_buf_max_size_;
+  size_t read_begin_;
+  size_t read_end_;
   size_t max_;
   receive_policy_flag rd_flag_;
 };
@@ -0,0 +1,179 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "caf/actor_clock.hpp"
+#include "caf/detail/net_export.hpp"
+#include "caf/net/fwd.hpp"
+
+namespace caf::net {
+
+/// A hierarchical timing wheel for scheduling timeouts on the I/O thread of a
+/// multiplexer. The wheel has four levels with 64 slots each and a resolution
+/// of one millisecond. Adding and cancelling a timer runs in constant time and
+/// re-uses the storage of previously expired timers.
+class CAF_NET_EXPORT timer_wheel {
+public:
+  // -- member types -----------------------------------------------------------
+
+  using clock_type = actor_clock::clock_type;
+
+  using time_point = actor_clock::time_point;
+
+  using duration_type = std::chrono::milliseconds;
+
+  /// Stores a timeout that expired while advancing the wheel.
+  struct expired_timeout {
+    socket_manager_ptr mgr;
+    std::string type;
+    uint64_t id;
+  };
+
+  using expired_list = std::vector<expired_timeout>;
+
+  // -- constants --------------------------------------------------------------
+
+  /// Number of bits for selecting a slot within a level.
+  static constexpr size_t slot_bits = 6;
+
+  /// Number of slots per level.
+  static constexpr size_t num_slots = size_t{1} << slot_bits;
+
+  /// Number of levels in the hierarchy.
+  static constexpr size_t num_levels = 4;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  timer_wheel();
+
+  explicit timer_wheel(time_point start);
+
+  timer_wheel(const timer_wheel&) = delete;
+
+  timer_wheel& operator=(const timer_wheel&) = delete;
+
+  ~timer_wheel();
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the number of pending timers.
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  /// Returns whether no timer is pending.
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+  /// Returns the number of milliseconds until the wheel needs to advance
+  /// again, i.e., the timeout argument for `poll` or `epoll_wait`. Returns -1
+  /// if no timer is pending.
+  int poll_timeout(time_point now) const noexcept;
+
+  // -- modifiers --------------------------------------------------------------
+
+  /// Schedules a new timer that fires at `tp` (rounded up to the next
+  /// millisecond) and returns its ID. Timer IDs are never 0.
+  uint64_t add(time_point tp, socket_manager_ptr mgr, std::string type);
+
+  /// Cancels the timer with given ID.
+  /// @returns `true` if the timer was still pending, `false` otherwise.
+  bool cancel(uint64_t id) noexcept;
+
+  /// Advances the wheel to `now` and moves all expired timers to `out` in
+  /// order of their deadlines.
+  /// @returns the number of expired timers.
+  size_t advance(time_point now, expired_list& out);
+
+private:
+  // -- member types -----------------------------------------------------------
+
+  static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+  struct entry {
+    uint64_t deadline = 0;
+    uint32_t prev = npos;
+    uint32_t next = npos;
+    uint32_t generation = 1;
+    uint32_t slot = npos;
+    socket_manager_ptr mgr;
+    std::string type;
+  };
+
+  // -- utility functions ------------------------------------------------------
+
+  /// Converts a point in time to a tick, rounding up.
+  uint64_t to_tick(time_point tp) const noexcept;
+
+  /// Returns the next tick at which the wheel either fires or cascades timers.
+  /// Returns `npos_tick` if the wheel is empty.
+  uint64_t next_event_tick() const noexcept;
+
+  /// Links `index` into the slot matching its deadline.
+  void place(uint32_t index) noexcept;
+
+  /// Removes `index` from its slot.
+  void unlink(uint32_t index) noexcept;
+
+  /// Returns the storage of `index` to the free list.
+  void release(uint32_t index) noexcept;
+
+  /// Re-distributes all timers from given slot of given level.
+  void cascade(size_t level, size_t slot) noexcept;
+
+  /// Runs a single tick and moves expired timers to `out`.
+  size_t tick(expired_list& out);
+
+  static uint64_t make_id(uint32_t generation, uint32_t index) noexcept {
+    return (static_cast<uint64_t>(generation) << 32) | index;
+  }
+
+  // -- member variables -------------------------------------------------------
+
+  /// Reference point for converting between ticks and time points.
+  time_point start_;
+
+  /// The last tick the wheel has processed.
+  uint64_t now_;
+
+  /// Number of pending timers.
+  size_t size_;
+
+  /// Head of the intrusive list for each slot.
+  std::array<std::array<uint32_t, num_slots>, num_levels> slots_;
+
+  /// Bitmask of non-empty slots for each level.
+  std::array<uint64_t, num_levels> occupied_;
+
+  /// Stores all timers, including unused entries.
+  std::vector<entry> entries_;
+
+  /// Head of the intrusive list of unused entries.
+  uint32_t free_list_;
+};
+
+} // namespace caf::net
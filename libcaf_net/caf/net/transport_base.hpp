@@ -23,7 +23,9 @@
 #include "caf/detail/overload.hpp"
 #include "caf/fwd.hpp"
 #include "caf/logger.hpp"
+#include "caf/net/buffer_pool.hpp"
 #include "caf/net/defaults.hpp"
+#include "caf/net/network_socket.hpp"
 #include "caf/net/receive_policy.hpp"
 
 namespace caf::net {
@@ -52,12 +54,13 @@ public:
 
   using id_type = IdType;
 
-  using buffer_cache_type = std::vector<byte_buffer>;
-
   // -- constructors, destructors, and assignment operators --------------------
 
   transport_base(handle_type handle, application_type application)
-    : next_layer_(std::move(application)), handle_(handle), manager_(nullptr) {
+    : next_layer_(std::move(application)),
+      handle_(handle),
+      manager_(nullptr),
+      payload_size_hint_(0) {
     // nop
   }
 
@@ -103,12 +106,10 @@ public:
     max_consecutive_reads_ = get_or(this->system().config(),
                                     "middleman.max-consecutive-reads",
                                     defaults::middleman::max_consecutive_reads);
-    auto max_header_bufs = get_or(cfg, "middleman.max-header-buffers",
-                                  defaults::middleman::max_header_buffers);
-    header_bufs_.reserve(max_header_bufs);
-    auto max_payload_bufs = get_or(cfg, "middleman.max-payload-buffers",
-                                   defaults::middleman::max_payload_buffers);
-    payload_bufs_.reserve(max_payload_bufs);
+    if (auto usec = get_or(cfg, "middleman.socket-busy-poll", size_t{0})) {
+      if (auto err = busy_poll(handle_, usec))
+        CAF_LOG_WARNING("unable to enable busy polling on socket:" << err);
+    }
     if (auto err = next_layer_.init(*this))
       return err;
     return none;
@@ -194,41 +195,39 @@ public:
 
   // -- buffer management ------------------------------------------------------
 
-  /// Returns the next cached header buffer or creates a new one if no buffers
-  /// are cached.
+  /// Returns an empty header buffer from the buffer pool.
   byte_buffer next_header_buffer() {
-    return next_buffer_impl(header_bufs_);
+    return buffer_pool::instance().acquire();
   }
 
-  /// Returns the next cached payload buffer or creates a new one if no buffers
-  /// are cached.
+  /// Returns an empty payload buffer from the buffer pool with enough capacity
+  /// for the most recently written payload.
   byte_buffer next_payload_buffer() {
-    return next_buffer_impl(payload_bufs_);
+    return buffer_pool::instance().acquire(payload_size_hint_);
   }
 
-private:
+protected:
   // -- utility functions ------------------------------------------------------
 
-  static byte_buffer next_buffer_impl(buffer_cache_type& cache) {
-    if (cache.empty())
-      return {};
-    auto buf = std::move(cache.back());
-    cache.pop_back();
-    return buf;
+  /// Returns a written buffer to the buffer pool.
+  void recycle(byte_buffer& buf, bool is_header) {
+    if (!is_header)
+      payload_size_hint_ = buf.size();
+    buffer_pool::instance().release(std::move(buf));
   }
 
-protected:
+  // -- member variables -------------------------------------------------------
+
   next_layer_type next_layer_;
   handle_type handle_;
 
-  buffer_cache_type header_bufs_;
-  buffer_cache_type payload_bufs_;
-
   byte_buffer read_buf_;
 
   endpoint_manager* manager_;
 
   size_t max_consecutive_reads_;
+
+  size_t payload_size_hint_;
 };
 
 } // namespace caf::net
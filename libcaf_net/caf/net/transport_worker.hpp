@@ -18,14 +18,32 @@
 
 #pragma once
 
+#include <type_traits>
+#include <utility>
+
+#include "caf/byte_buffer.hpp"
 #include "caf/logger.hpp"
 #include "caf/net/endpoint_manager_queue.hpp"
 #include "caf/net/fwd.hpp"
+#include "caf/net/packet_writer.hpp"
 #include "caf/net/packet_writer_decorator.hpp"
 #include "caf/unit.hpp"
 
 namespace caf::net {
 
+/// Checks whether `Application` provides `handle_owned_data` for taking
+/// ownership of received buffers.
+template <class Application, class = void>
+struct has_handle_owned_data : std::false_type {};
+
+template <class Application>
+struct has_handle_owned_data<
+  Application, std::void_t<decltype(std::declval<Application&>()
+                                      .handle_owned_data(
+                                        std::declval<packet_writer&>(),
+                                        std::declval<byte_buffer&>()))>>
+  : std::true_type {};
+
 /// Implements a worker for transport protocols.
 template <class Application, class IdType>
 class transport_worker {
@@ -36,6 +54,13 @@ public:
 
   using application_type = Application;
 
+  // -- constants --------------------------------------------------------------
+
+  /// Signals whether `handle_owned_data` may pass ownership of the buffer to
+  /// the application.
+  static constexpr bool accepts_owned_data
+    = has_handle_owned_data<application_type>::value;
+
   // -- constructors, destructors, and assignment operators --------------------
 
   explicit transport_worker(application_type application,
@@ -72,6 +97,17 @@ public:
     return application_.handle_data(writer, data);
   }
 
+  /// Passes `data` to the application, which may take ownership of the
+  /// buffer. Leaves `data` empty in this case.
+  template <class Parent>
+  error handle_owned_data(Parent& parent, byte_buffer& data) {
+    auto writer = make_packet_writer_decorator(*this, parent);
+    if constexpr (accepts_owned_data)
+      return application_.handle_owned_data(writer, data);
+    else
+      return application_.handle_data(writer, make_span(data));
+  }
+
   template <class Parent>
   void write_message(Parent& parent,
                      std::unique_ptr<endpoint_manager_queue::message> msg) {
@@ -105,6 +141,11 @@ public:
     application_.timeout(writer, std::move(tag), id);
   }
 
+  template <class... Ts>
+  void set_timeout(uint64_t, Ts&&...) {
+    // nop
+  }
+
   void handle_error(sec error) {
     application_.handle_error(error);
   }
@@ -18,19 +18,31 @@
 
 #pragma once
 
+#include <chrono>
+#include <functional>
 #include <unordered_map>
+#include <vector>
 
+#include "caf/detail/sync_request_bouncer.hpp"
 #include "caf/logger.hpp"
+#include "caf/net/defaults.hpp"
 #include "caf/net/endpoint_manager_queue.hpp"
 #include "caf/net/fwd.hpp"
 #include "caf/net/packet_writer_decorator.hpp"
 #include "caf/net/transport_worker.hpp"
 #include "caf/sec.hpp"
 #include "caf/send.hpp"
+#include "caf/settings.hpp"
+#include "caf/timespan.hpp"
 
 namespace caf::net {
 
 /// Implements a dispatcher that dispatches between transport and workers.
+///
+/// The dispatcher stores workers in an open-addressing table keyed by
+/// `id_type` and drops workers that neither received data nor handled any
+/// event for longer than `middleman.worker-idle-timeout`. A periodic timeout of the endpoint manager
+/// drives the sweep for idle workers.
 template <class Factory, class IdType>
 class transport_worker_dispatcher {
 public:
@@ -46,6 +58,15 @@ public:
 
   using worker_ptr = transport_worker_ptr<application_type, id_type>;
 
+  using clock_type = std::chrono::steady_clock;
+
+  using time_point = clock_type::time_point;
+
+  // -- constants --------------------------------------------------------------
+
+  /// Tags the periodic timeout for evicting idle workers.
+  static constexpr const char* sweep_timeout_tag = "worker-sweep";
+
   // -- constructors, destructors, and assignment operators --------------------
 
   explicit transport_worker_dispatcher(factory_type factory)
@@ -56,15 +77,21 @@ public:
   // -- member functions -------------------------------------------------------
 
   template <class Parent>
-  error init(Parent&) {
-    CAF_ASSERT(workers_by_id_.empty());
+  error init(Parent& parent) {
+    CAF_ASSERT(num_workers_ == 0);
+    idle_timeout_ = get_or(parent.system().config(),
+                           "middleman.worker-idle-timeout",
+                           defaults::middleman::worker_idle_timeout);
     return none;
   }
 
   template <class Parent>
   error handle_data(Parent& parent, span<const byte> data, id_type id) {
-    if (auto worker = find_worker(id))
-      return worker->handle_data(parent, data);
+    start_sweeping(parent);
+    if (auto entry = find_entry(id)) {
+      entry->last_active = clock_type::now();
+      return entry->worker->handle_data(parent, data);
+    }
     // TODO: Where to get node_id from here?
     auto worker = add_new_worker(parent, node_id{}, id);
     if (worker)
@@ -79,19 +106,30 @@ public:
     auto receiver = msg->receiver;
     if (!receiver)
       return;
+    start_sweeping(parent);
     auto nid = receiver->node();
-    if (auto worker = find_worker(nid)) {
+    if (auto worker = find_active_worker(nid)) {
       worker->write_message(parent, std::move(msg));
       return;
     }
     // TODO: where to get id_type from here?
-    if (auto worker = add_new_worker(parent, nid, id_type{}))
-      (*worker)->write_message(parent, std::move(msg));
+    auto worker = add_new_worker(parent, nid, id_type{});
+    if (!worker) {
+      // Without an address, all unknown nodes compete for the default ID and
+      // only the first one gets a worker.
+      CAF_LOG_ERROR("drop message to unreachable node:"
+                    << CAF_ARG(nid) << CAF_ARG2("error", worker.error()));
+      detail::sync_request_bouncer bouncer{
+        make_error(sec::request_receiver_down)};
+      bouncer(*msg->msg);
+      return;
+    }
+    (*worker)->write_message(parent, std::move(msg));
   }
 
   template <class Parent>
   void resolve(Parent& parent, const uri& locator, const actor& listener) {
-    if (auto worker = find_worker(make_node_id(locator)))
+    if (auto worker = find_active_worker(make_node_id(locator)))
       worker->resolve(parent, locator.path(), listener);
     else
       anon_send(listener,
@@ -100,76 +138,251 @@ public:
 
   template <class Parent>
   void new_proxy(Parent& parent, const node_id& nid, actor_id id) {
-    if (auto worker = find_worker(nid))
+    if (auto worker = find_active_worker(nid))
       worker->new_proxy(parent, nid, id);
   }
 
   template <class Parent>
   void local_actor_down(Parent& parent, const node_id& nid, actor_id id,
                         error reason) {
-    if (auto worker = find_worker(nid))
+    if (auto worker = find_active_worker(nid))
       worker->local_actor_down(parent, nid, id, std::move(reason));
   }
 
   template <class... Ts>
   void set_timeout(uint64_t timeout_id, id_type id, Ts&&...) {
-    workers_by_timeout_id_.emplace(timeout_id, workers_by_id_.at(id));
+    if (auto entry = find_entry(id))
+      workers_by_timeout_id_.emplace(timeout_id, entry->worker);
   }
 
   template <class Parent>
   void timeout(Parent& parent, std::string tag, uint64_t id) {
-    if (auto worker = workers_by_timeout_id_.at(id)) {
-      worker->timeout(parent, std::move(tag), id);
-      workers_by_timeout_id_.erase(id);
+    if (sweeping_ && id == sweep_timeout_id_) {
+      evict_idle_workers(parent, clock_type::now());
+      schedule_sweep(parent);
+      return;
     }
+    auto i = workers_by_timeout_id_.find(id);
+    if (i == workers_by_timeout_id_.end())
+      return;
+    auto worker = std::move(i->second);
+    workers_by_timeout_id_.erase(i);
+    if (worker)
+      worker->timeout(parent, std::move(tag), id);
   }
 
   void handle_error(sec error) {
-    for (const auto& p : workers_by_id_) {
-      auto worker = p.second;
-      worker->handle_error(error);
-    }
+    for (auto& entry : table_)
+      if (entry.worker)
+        entry.worker->handle_error(error);
   }
 
   template <class Parent>
   expected<worker_ptr> add_new_worker(Parent& parent, node_id node,
                                       id_type id) {
     CAF_LOG_TRACE(CAF_ARG(node) << CAF_ARG(id));
+    // A worker outside of the table would never get evicted.
+    if (find_entry(id) != nullptr)
+      return make_error(sec::runtime_error, "worker already exists");
     auto application = factory_.make();
     auto worker = std::make_shared<worker_type>(std::move(application), id);
     if (auto err = worker->init(parent))
       return err;
-    workers_by_id_.emplace(std::move(id), worker);
-    workers_by_node_.emplace(std::move(node), worker);
+    insert_entry(std::move(id), node, worker);
+    // Workers for unknown nodes are only reachable by their ID.
+    if (node)
+      workers_by_node_.insert_or_assign(std::move(node), worker);
     return worker;
   }
 
+  /// Drops all workers that had no activity since `now - idle_timeout()` and
+  /// cancels their pending timeouts.
+  template <class Parent>
+  void evict_idle_workers(Parent& parent, time_point now) {
+    auto deadline = now - idle_timeout_;
+    size_t i = 0;
+    while (i < table_.size()) {
+      auto& entry = table_[i];
+      if (entry.worker && entry.last_active < deadline) {
+        CAF_LOG_DEBUG("evict idle worker:" << CAF_ARG2("id", entry.id));
+        drop_references(parent, entry);
+        // Erasing shifts the next entry into slot i, so check i again.
+        erase_at(i);
+        ++evicted_workers_;
+      } else {
+        ++i;
+      }
+    }
+  }
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns the number of workers in the table.
+  size_t live_workers() const noexcept {
+    return num_workers_;
+  }
+
+  /// Returns the number of workers that were dropped for being idle.
+  size_t evicted_workers() const noexcept {
+    return evicted_workers_;
+  }
+
+  timespan idle_timeout() const noexcept {
+    return idle_timeout_;
+  }
+
+  void idle_timeout(timespan x) noexcept {
+    idle_timeout_ = x;
+  }
+
 private:
+  // -- member types -----------------------------------------------------------
+
+  struct table_entry {
+    id_type id;
+    node_id node;
+    worker_ptr worker;
+    time_point last_active;
+  };
+
+  // -- worker lookups ---------------------------------------------------------
+
   worker_ptr find_worker(const node_id& nid) {
-    return find_worker_impl(workers_by_node_, nid);
+    if (auto i = workers_by_node_.find(nid); i != workers_by_node_.end())
+      return i->second;
+    CAF_LOG_DEBUG("could not find worker: " << CAF_ARG(nid));
+    return nullptr;
   }
 
-  worker_ptr find_worker(const id_type& id) {
-    return find_worker_impl(workers_by_id_, id);
+  /// Returns the worker for `nid` after refreshing its idle timer.
+  worker_ptr find_active_worker(const node_id& nid) {
+    auto worker = find_worker(nid);
+    if (worker)
+      if (auto entry = find_entry(worker->id()))
+        entry->last_active = clock_type::now();
+    return worker;
+  }
+
+  size_t home_slot(const id_type& id) const {
+    return std::hash<id_type>{}(id) & (table_.size() - 1);
   }
 
-  template <class Key>
-  worker_ptr find_worker_impl(const std::unordered_map<Key, worker_ptr>& map,
-                              const Key& key) {
-    if (map.count(key) == 0) {
-      CAF_LOG_DEBUG("could not find worker: " << CAF_ARG(key));
+  table_entry* find_entry(const id_type& id) {
+    if (table_.empty())
       return nullptr;
+    auto mask = table_.size() - 1;
+    for (auto i = home_slot(id);; i = (i + 1) & mask) {
+      auto& entry = table_[i];
+      if (!entry.worker)
+        return nullptr;
+      if (entry.id == id)
+        return &entry;
     }
-    return map.at(key);
   }
 
-  // -- worker lookups ---------------------------------------------------------
+  /// Inserts a new entry into the table.
+  /// @pre `find_entry(id) == nullptr`
+  void insert_entry(id_type id, const node_id& node, worker_ptr worker) {
+    // Keep the load factor at or below 3/4 to keep probe sequences short.
+    if ((num_workers_ + 1) * 4 > table_.size() * 3)
+      grow();
+    auto mask = table_.size() - 1;
+    auto i = home_slot(id);
+    while (table_[i].worker)
+      i = (i + 1) & mask;
+    table_[i] = table_entry{std::move(id), node, std::move(worker),
+                            clock_type::now()};
+    ++num_workers_;
+  }
+
+  void grow() {
+    std::vector<table_entry> entries(table_.empty() ? 16 : table_.size() * 2);
+    entries.swap(table_);
+    auto mask = table_.size() - 1;
+    for (auto& entry : entries) {
+      if (entry.worker) {
+        auto i = home_slot(entry.id);
+        while (table_[i].worker)
+          i = (i + 1) & mask;
+        table_[i] = std::move(entry);
+      }
+    }
+  }
+
+  /// Removes the entry at slot `i`, shifting subsequent entries of the same
+  /// probe sequence back to keep lookups correct without tombstones.
+  void erase_at(size_t i) {
+    auto mask = table_.size() - 1;
+    table_[i] = table_entry{};
+    --num_workers_;
+    for (auto j = (i + 1) & mask; table_[j].worker; j = (j + 1) & mask) {
+      auto k = home_slot(table_[j].id);
+      // Leave the entry if its home slot lies cyclically in (i, j].
+      auto stays = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+      if (!stays) {
+        table_[i] = std::move(table_[j]);
+        table_[j] = table_entry{};
+        i = j;
+      }
+    }
+  }
+
+  /// Removes all references to the worker in `entry` outside of the table.
+  template <class Parent>
+  void drop_references(Parent& parent, const table_entry& entry) {
+    if (auto i = workers_by_node_.find(entry.node);
+        i != workers_by_node_.end() && i->second == entry.worker)
+      workers_by_node_.erase(i);
+    for (auto i = workers_by_timeout_id_.begin();
+         i != workers_by_timeout_id_.end();) {
+      if (i->second == entry.worker) {
+        parent.manager().cancel_timeout(i->first);
+        i = workers_by_timeout_id_.erase(i);
+      } else {
+        ++i;
+      }
+    }
+  }
+
+  // -- sweeping ---------------------------------------------------------------
+
+  /// Starts the periodic sweep for idle workers unless already running. We
+  /// can't start sweeping in `init`, because it may run outside of the
+  /// multiplexer.
+  template <class Parent>
+  void start_sweeping(Parent& parent) {
+    if (!sweeping_ && idle_timeout_.count() > 0) {
+      sweeping_ = true;
+      schedule_sweep(parent);
+    }
+  }
+
+  template <class Parent>
+  void schedule_sweep(Parent& parent) {
+    sweep_timeout_id_ = parent.manager().set_timeout(
+      clock_type::now() + idle_timeout_ / 2, sweep_timeout_tag);
+  }
+
+  // -- member variables -------------------------------------------------------
+
+  /// Stores workers by `id_type` with linear probing. The size of this vector
+  /// is always 0 or a power of two.
+  std::vector<table_entry> table_;
 
-  std::unordered_map<id_type, worker_ptr> workers_by_id_;
   std::unordered_map<node_id, worker_ptr> workers_by_node_;
   std::unordered_map<uint64_t, worker_ptr> workers_by_timeout_id_;
 
   factory_type factory_;
+
+  size_t num_workers_ = 0;
+
+  size_t evicted_workers_ = 0;
+
+  timespan idle_timeout_ = defaults::middleman::worker_idle_timeout;
+
+  bool sweeping_ = false;
+
+  uint64_t sweep_timeout_id_ = 0;
 };
 
 } // namespace caf::net
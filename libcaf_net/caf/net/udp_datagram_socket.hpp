@@ -18,9 +18,12 @@
 
 #pragma once
 
+#include "caf/byte_buffer.hpp"
 #include "caf/detail/net_export.hpp"
 #include "caf/fwd.hpp"
+#include "caf/ip_endpoint.hpp"
 #include "caf/net/network_socket.hpp"
+#include "caf/span.hpp"
 
 namespace caf::net {
 
@@ -32,6 +35,48 @@ struct CAF_NET_EXPORT udp_datagram_socket : network_socket {
   using super::super;
 };
 
+/// Describes an outgoing datagram for batched writes.
+/// @relates udp_datagram_socket
+struct outgoing_datagram {
+  /// Points to the content of the datagram, scattered across up to
+  /// `max_datagram_buffers` buffers.
+  span<byte_buffer*> bufs;
+
+  /// The endpoint to send the datagram to.
+  ip_endpoint ep;
+};
+
+/// Describes a received datagram for batched reads.
+/// @relates udp_datagram_socket
+struct received_datagram {
+  /// The number of received bytes.
+  size_t size;
+
+  /// The sender of the datagram.
+  ip_endpoint ep;
+
+  /// The size of each datagram if the kernel coalesced several datagrams from
+  /// `ep` into one buffer (`UDP_GRO`), 0 otherwise. The last datagram in a
+  /// coalesced buffer may be shorter than `segment_size`.
+  size_t segment_size;
+};
+
+/// Maximum number of datagrams that a single batched read or write transfers.
+/// @relates udp_datagram_socket
+CAF_NET_EXPORT extern const size_t max_datagram_batch_size;
+
+/// Maximum number of buffers that make up a single outgoing datagram.
+/// @relates udp_datagram_socket
+CAF_NET_EXPORT extern const size_t max_datagram_buffers;
+
+/// Maximum number of datagrams in a single segmented write.
+/// @relates udp_datagram_socket
+CAF_NET_EXPORT extern const size_t max_datagram_segments;
+
+/// Maximum number of bytes in a single segmented write.
+/// @relates udp_datagram_socket
+CAF_NET_EXPORT extern const size_t max_segmented_write_size;
+
 /// Creates a `udp_datagram_socket` bound to given port.
 /// @param ep ip_endpoint that contains the port to bind to. Pass port '0' to
 ///           bind to any unused port - The endpoint will be updated with the
@@ -46,6 +91,12 @@ expected<std::pair<udp_datagram_socket, uint16_t>>
 /// @relates udp_datagram_socket
 error CAF_NET_EXPORT allow_connreset(udp_datagram_socket x, bool new_value);
 
+/// Enables or disables `UDP_GRO` on `x`, allowing the kernel to coalesce
+/// consecutive datagrams from the same sender into a single receive buffer.
+/// @relates udp_datagram_socket
+/// @note Only available on Linux.
+error CAF_NET_EXPORT gro(udp_datagram_socket x, bool new_value);
+
 /// Receives the next datagram on socket `x`.
 /// @param x The UDP socket for receiving datagrams.
 /// @param buf Writable output buffer.
@@ -57,15 +108,32 @@ error CAF_NET_EXPORT allow_connreset(udp_datagram_socket x, bool new_value);
 variant<std::pair<size_t, ip_endpoint>, sec>
   CAF_NET_EXPORT read(udp_datagram_socket x, span<byte> buf);
 
+/// Receives up to `bufs.size()` datagrams on socket `x`, using a single
+/// system call on Linux (`recvmmsg`).
+/// @param x The UDP socket for receiving datagrams.
+/// @param bufs Writable output buffers, one for each datagram.
+/// @param infos Stores length, sender and segment size of each received
+///              datagram.
+/// @returns The number of received datagrams on success, an error code
+///          otherwise.
+/// @relates udp_datagram_socket
+/// @pre `infos.size() >= bufs.size()`
+/// @post the result is either a `sec` or a positive (non-zero) integer of at
+///       most `min(bufs.size(), max_datagram_batch_size)`
+variant<size_t, sec>
+  CAF_NET_EXPORT read(udp_datagram_socket x, span<span<byte>> bufs,
+                      span<received_datagram> infos);
+
 /// Sends the content of `bufs` as a datagram to the endpoint `ep` on socket
 /// `x`.
 /// @param x The UDP socket for sending datagrams.
-/// @param bufs Points to the datagram to send, scattered across up to 10
-///             buffers.
+/// @param bufs Points to the datagram to send, scattered across up to
+///             `max_datagram_buffers` buffers.
 /// @param ep The enpoint to send the datagram to.
 /// @returns The number of written bytes on success, otherwise an error code.
+///          Fails with `sec::invalid_argument` if `bufs` contains more than
+///          `max_datagram_buffers` buffers.
 /// @relates udp_datagram_socket
-/// @pre `bufs.size() < 10`
 variant<size_t, sec> CAF_NET_EXPORT write(udp_datagram_socket x,
                                           span<byte_buffer*> bufs,
                                           ip_endpoint ep);
@@ -79,6 +147,39 @@ variant<size_t, sec> CAF_NET_EXPORT write(udp_datagram_socket x,
 variant<size_t, sec> CAF_NET_EXPORT write(udp_datagram_socket x,
                                           span<const byte> buf, ip_endpoint ep);
 
+/// Sends up to `max_datagram_batch_size` datagrams on socket `x`, using a
+/// single system call on Linux (`sendmmsg`).
+/// @param x The UDP socket for sending datagrams.
+/// @param datagrams The datagrams to send.
+/// @returns The number of sent datagrams on success, otherwise an error code.
+///          Fails with `sec::invalid_argument` if a datagram consists of more
+///          than `max_datagram_buffers` buffers.
+/// @relates udp_datagram_socket
+/// @post the result is either a `sec` or a positive (non-zero) integer
+variant<size_t, sec> CAF_NET_EXPORT
+write(udp_datagram_socket x, span<const outgoing_datagram> datagrams);
+
+/// Sends the content of `bufs` as a sequence of datagrams of `segment_size`
+/// bytes each to the endpoint `ep` on socket `x`, leaving the segmentation to
+/// the kernel or the network card (`UDP_SEGMENT`). The last datagram may be
+/// shorter than `segment_size`.
+/// @param x The UDP socket for sending datagrams.
+/// @param bufs Points to the content of all datagrams. Buffer boundaries need
+///             not align with datagram boundaries.
+/// @param segment_size The size of each datagram.
+/// @param ep The enpoint to send the datagrams to.
+/// @returns The number of written bytes on success, otherwise an error code.
+///          Fails with `sec::invalid_argument` if `bufs` contains more than
+///          `max_datagram_segments * max_datagram_buffers` buffers.
+/// @relates udp_datagram_socket
+/// @pre the total size is at most `max_segmented_write_size` and at most
+///      `max_datagram_segments * segment_size`
+/// @note Only available on Linux. Fails with `sec::socket_operation_failed`
+///       on other platforms.
+variant<size_t, sec> CAF_NET_EXPORT
+write_segmented(udp_datagram_socket x, span<byte_buffer*> bufs,
+                size_t segment_size, ip_endpoint ep);
+
 /// Converts the result from I/O operation on a ::udp_datagram_socket to either
 /// an error code or a non-zero positive integer.
 /// @relates udp_datagram_socket
@@ -0,0 +1,202 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "caf/byte.hpp"
+#include "caf/detail/net_export.hpp"
+#include "caf/error.hpp"
+#include "caf/ip_endpoint.hpp"
+#include "caf/net/udp_datagram_socket.hpp"
+#include "caf/span.hpp"
+#include "caf/timespan.hpp"
+
+namespace caf::net {
+
+/// A minimal io_uring instance for the multiplexer. Talks to the kernel via
+/// raw system calls and thus doesn't require liburing. Only available on
+/// Linux kernels that poll sockets internally (5.7 or later).
+class CAF_NET_EXPORT uring {
+public:
+  // -- member types -----------------------------------------------------------
+
+  /// Stores the result of a finished operation.
+  struct completion {
+    /// The value passed to the submitting function.
+    uint64_t user_data;
+
+    /// The return value of the operation, i.e., a negative `errno` on error.
+    int32_t res;
+  };
+
+  /// Keeps the arguments of a `sendmsg` or `recvmsg` operation alive until
+  /// the operation completes.
+  struct msg_args;
+
+  struct msg_args_deleter {
+    void operator()(msg_args* ptr) const noexcept;
+  };
+
+  using msg_args_ptr = std::unique_ptr<msg_args, msg_args_deleter>;
+
+  // -- constants --------------------------------------------------------------
+
+  /// Number of submission queue entries that the multiplexer asks for.
+  static constexpr unsigned default_entries = 256;
+
+  // -- constructors, destructors, and assignment operators --------------------
+
+  uring() noexcept;
+
+  uring(const uring&) = delete;
+
+  uring& operator=(const uring&) = delete;
+
+  ~uring();
+
+  /// Sets up the ring with room for `entries` submissions.
+  /// @returns an error if the kernel lacks io_uring or internal polling.
+  error init(unsigned entries = default_entries);
+
+  // -- properties -------------------------------------------------------------
+
+  /// Returns whether `init` succeeded.
+  bool valid() const noexcept {
+    return fd_ != -1;
+  }
+
+  /// Returns the number of prepared operations that `enter` submits next.
+  size_t pending() const noexcept {
+    return static_cast<size_t>(sqe_tail_ - sqe_head_);
+  }
+
+  // -- submitting operations --------------------------------------------------
+
+  /// Prepares a one-shot poll for `events` (a `poll` bitmask) on `fd`.
+  bool poll(uint64_t user_data, int fd, short events);
+
+  /// Prepares a `recv` into `buf`.
+  /// @pre `buf` remains valid until the operation completes.
+  bool recv(uint64_t user_data, int fd, span<byte> buf);
+
+  /// Prepares a gather write of `bufs` with `sendmsg`.
+  /// @returns the arguments that the caller must keep alive until the
+  ///          operation completes or `nullptr` if the submission queue is full.
+  /// @pre the memory that `bufs` points to remains valid until the operation
+  ///      completes.
+  msg_args_ptr sendmsg(uint64_t user_data, int fd,
+                       span<const span<const byte>> bufs);
+
+  /// Prepares a gather write of `bufs` as a single datagram to `dest`.
+  /// @returns the arguments that the caller must keep alive until the
+  ///          operation completes or `nullptr` if the submission queue is full.
+  /// @pre the memory that `bufs` points to remains valid until the operation
+  ///      completes.
+  msg_args_ptr sendmsg(uint64_t user_data, int fd,
+                       span<const span<const byte>> bufs,
+                       const ip_endpoint& dest);
+
+  /// Prepares a `recvmsg` of a single datagram into `buf` that also receives
+  /// the sender and, with `UDP_GRO`, the segment size.
+  /// @returns the arguments that the caller must keep alive until the
+  ///          operation completes or `nullptr` if the submission queue is full.
+  /// @pre `buf` remains valid until the operation completes.
+  msg_args_ptr recvmsg(uint64_t user_data, int fd, span<byte> buf);
+
+  /// Fills `info` from the arguments of a finished `recvmsg` that received
+  /// `num_bytes` bytes.
+  static error datagram_info(const msg_args& args, size_t num_bytes,
+                             received_datagram& info);
+
+  /// Prepares a timeout that completes after `rel_time` or once any other
+  /// operation completed, whichever happens first.
+  bool timeout(uint64_t user_data, timespan rel_time);
+
+  /// Prepares the cancellation of the operation with the given user data.
+  bool cancel(uint64_t user_data, uint64_t target);
+
+  // -- interacting with the kernel --------------------------------------------
+
+  /// Submits all prepared operations and waits for at least `min_complete`
+  /// completions.
+  /// @returns 0 on success, otherwise the `errno` reported by the kernel.
+  int enter(unsigned min_complete);
+
+  /// Appends all available completions to `out`.
+  /// @returns the number of appended completions.
+  size_t drain(std::vector<completion>& out);
+
+private:
+  // -- utility functions ------------------------------------------------------
+
+  /// Returns a zeroed submission queue entry, submitting prepared operations
+  /// first if the queue is full.
+  void* next_sqe();
+
+  /// Unmaps the rings and closes the file descriptor.
+  void release() noexcept;
+
+  /// Sets all member variables to their initial state.
+  void reset() noexcept;
+
+  // -- member variables -------------------------------------------------------
+
+  /// File descriptor of the ring or -1.
+  int fd_;
+
+  /// Memory mapping of the submission queue ring.
+  void* sq_ring_;
+  size_t sq_ring_size_;
+
+  /// Memory mapping of the completion queue ring. Equals `sq_ring_` if the
+  /// kernel maps both rings at once.
+  void* cq_ring_;
+  size_t cq_ring_size_;
+
+  /// Memory mapping of the submission queue entries.
+  void* sqes_;
+  size_t sqes_size_;
+
+  /// Pointers into the shared rings.
+  unsigned* sq_khead_;
+  unsigned* sq_ktail_;
+  unsigned* sq_array_;
+  unsigned sq_mask_;
+  unsigned sq_entries_;
+  unsigned* cq_khead_;
+  unsigned* cq_ktail_;
+  unsigned cq_mask_;
+  void* cqes_;
+
+  /// Index of the first prepared entry that the kernel hasn't seen yet.
+  unsigned sqe_head_;
+
+  /// Index of the next free entry.
+  unsigned sqe_tail_;
+
+  /// Stores the argument of the last timeout until submitting it.
+  int64_t timeout_spec_[2];
+};
+
+} // namespace caf::net
@@ -18,6 +18,8 @@
 
 #include "caf/net/basp/application.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <vector>
 
 #include "caf/actor_system.hpp"
@@ -32,6 +34,8 @@
 #include "caf/logger.hpp"
 #include "caf/net/basp/constants.hpp"
 #include "caf/net/basp/ec.hpp"
+#include "caf/net/buffer_pool.hpp"
+#include "caf/net/compression.hpp"
 #include "caf/net/packet_writer.hpp"
 #include "caf/no_stages.hpp"
 #include "caf/none.hpp"
@@ -41,8 +45,22 @@
 
 namespace caf::net::basp {
 
-application::application(proxy_registry& proxies)
-  : proxies_(proxies), queue_{new message_queue}, hub_{new hub_type} {
+namespace {
+
+// Encodes `x` for the operation data of a heartbeat. Never returns 0, since
+// heartbeats without timestamp use 0.
+uint64_t to_heartbeat_timestamp(actor_clock::time_point x) {
+  auto ns = std::chrono::duration_cast<timespan>(x.time_since_epoch()).count();
+  auto result = static_cast<uint64_t>(ns) & ~heartbeat_reply_flag;
+  return result != 0 ? result : 1;
+}
+
+} // namespace
+
+application::application(proxy_registry& proxies, worker_pool* workers)
+  : proxies_(proxies),
+    queue_{std::make_shared<message_queue>()},
+    workers_(workers) {
   // nop
 }
 
@@ -51,31 +69,26 @@ error application::write_message(
   CAF_ASSERT(ptr != nullptr);
   CAF_ASSERT(ptr->msg != nullptr);
   CAF_LOG_TRACE(CAF_ARG2("content", ptr->msg->content()));
-  const auto& src = ptr->msg->sender;
-  const auto& dst = ptr->receiver;
-  if (dst == nullptr) {
+  if (ptr->receiver == nullptr) {
     // TODO: valid?
     return none;
   }
+  // Pack further queued messages into the same frame if our peer supports it.
+  // The endpoint manager only queues messages for this connection.
+  if ((capabilities_ & batch_capability) != 0 && manager_ != nullptr)
+    if (auto next = manager_->next_message())
+      return write_batch(writer, std::move(ptr), std::move(next));
   auto payload_buf = writer.next_payload_buffer();
   binary_serializer sink{system(), payload_buf};
-  if (src != nullptr) {
-    auto src_id = src->id();
-    system().registry().put(src_id, src);
-    if (auto err = sink(src->node(), src_id, dst->id(), ptr->msg->stages))
-      return err;
-  } else {
-    if (auto err = sink(node_id{}, actor_id{0}, dst->id(), ptr->msg->stages))
-      return err;
-  }
-  if (auto err = sink(ptr->msg->content()))
+  if (auto err = serialize(sink, *ptr))
     return err;
-  auto hdr = writer.next_header_buffer();
-  to_bytes(header{message_type::actor_message,
-                  static_cast<uint32_t>(payload_buf.size()),
-                  ptr->msg->mid.integer_value()},
-           hdr);
-  writer.write_packet(hdr, payload_buf);
+  auto type = interning() ? message_type::interned_actor_message
+                          : message_type::actor_message;
+  write_actor_frame(writer,
+                    header{type,
+                           static_cast<uint32_t>(payload_buf.size()),
+                           ptr->msg->mid.integer_value()},
+                    payload_buf);
   return none;
 }
 
@@ -97,6 +110,25 @@ void application::resolve(packet_writer& writer, string_view path,
   pending_resolves_.emplace(req_id, listener);
 }
 
+error application::heartbeat(packet_writer& writer,
+                             actor_clock::time_point now) {
+  CAF_LOG_TRACE(CAF_ARG(got_input_));
+  if (got_input_) {
+    got_input_ = false;
+    last_input_ = now;
+  } else if ((capabilities_ & heartbeat_capability) != 0
+             && now - last_input_ >= connection_timeout_) {
+    // Our peer answers heartbeats, so we should have heard from it.
+    return ec::connection_timeout;
+  }
+  auto hdr = writer.next_header_buffer();
+  to_bytes(header{message_type::heartbeat, 0, to_heartbeat_timestamp(now)},
+           hdr);
+  writer.write_packet(hdr);
+  ++heartbeat_stats_.sent_heartbeats;
+  return none;
+}
+
 void application::new_proxy(packet_writer& writer, actor_id id) {
   auto hdr = writer.next_header_buffer();
   to_bytes(header{message_type::monitor_message, 0, static_cast<uint64_t>(id)},
@@ -118,6 +150,17 @@ void application::local_actor_down(packet_writer& writer, actor_id id,
   writer.write_packet(hdr, payload);
 }
 
+uint64_t application::local_capabilities() const noexcept {
+  uint64_t result = 0;
+  if (max_batch_size_ > 0)
+    result |= batch_capability;
+  // We always accept compressed and interned messages and answer heartbeats.
+  result |= compression_capability;
+  result |= interning_capability;
+  result |= heartbeat_capability;
+  return result;
+}
+
 strong_actor_ptr application::resolve_local_path(string_view path) {
   CAF_LOG_TRACE(CAF_ARG(path));
   // We currently support two path formats: `id/<actor_id>` and `name/<atom>`.
@@ -192,6 +235,7 @@ error application::handle(packet_writer& writer, header hdr,
     case message_type::handshake:
       return ec::unexpected_handshake;
     case message_type::actor_message:
+    case message_type::interned_actor_message:
       return handle_actor_message(writer, hdr, payload);
     case message_type::resolve_request:
       return handle_resolve_request(writer, hdr, payload);
@@ -202,7 +246,11 @@ error application::handle(packet_writer& writer, header hdr,
     case message_type::down_message:
       return handle_down_message(writer, hdr, payload);
     case message_type::heartbeat:
-      return none;
+      return handle_heartbeat(writer, hdr);
+    case message_type::actor_message_batch:
+      return handle_actor_message_batch(writer, hdr, payload);
+    case message_type::compressed_message:
+      return handle_compressed_message(writer, hdr, payload);
     default:
       return ec::unimplemented;
   }
@@ -220,6 +268,11 @@ error application::handle_handshake(packet_writer&, header hdr,
   binary_deserializer source{&executor_, payload};
   if (auto err = source(peer_id, app_ids))
     return err;
+  // Nodes that predate capability negotiation omit this field.
+  uint64_t peer_capabilities = 0;
+  if (source.remaining() > 0)
+    if (auto err = source(peer_capabilities))
+      return err;
   if (!peer_id || app_ids.empty())
     return ec::invalid_handshake;
   auto ids = get_or(system().config(), "middleman.app-identifiers",
@@ -230,32 +283,72 @@ error application::handle_handshake(packet_writer&, header hdr,
   if (std::none_of(app_ids.begin(), app_ids.end(), predicate))
     return ec::app_identifiers_mismatch;
   peer_id_ = std::move(peer_id);
+  peer_id_bytes_.clear();
+  binary_serializer sink{&executor_, peer_id_bytes_};
+  if (auto err = sink(peer_id_))
+    return err;
+  capabilities_ = local_capabilities() & peer_capabilities;
   state_ = connection_state::await_header;
   return none;
 }
 
 error application::handle_actor_message(packet_writer&, header hdr,
-                                        byte_span payload) {
-  auto worker = hub_->pop();
+                                        byte_span payload,
+                                        byte_buffer* owner) {
+  // Resolve interned senders here, because definitions and references depend
+  // on the order of messages.
+  strong_actor_ptr src;
+  actor_id src_id = 0;
+  actor_id dst_id = 0;
+  if (hdr.type == message_type::interned_actor_message) {
+    binary_deserializer source{&executor_, payload};
+    if (auto err = read_interned_source(source, src))
+      return err;
+    payload = source.remainder();
+    if (src != nullptr)
+      src_id = src->id();
+    if (auto err = source(dst_id))
+      return err;
+  } else if (auto err = read_actor_ids(payload, src_id, dst_id)) {
+    // The worker drops malformed messages later.
+    CAF_LOG_DEBUG("unable to read routing information" << CAF_ARG(err));
+  }
+  auto key = message_queue::ordering_key(src_id, dst_id);
+  // Scheduling a worker costs more than deserializing small messages.
+  auto worker = payload.size() > inline_threshold_ ? workers_->pop()
+                                                   : nullptr;
   if (worker != nullptr) {
     CAF_LOG_DEBUG("launch BASP worker for deserializing an actor_message");
-    worker->launch(node_id{}, hdr, payload);
+    ++dispatch_stats_.offloaded_messages;
+    dispatch_stats_.offloaded_bytes += payload.size();
+    if (owner != nullptr) {
+      auto offset = static_cast<size_t>(payload.data() - owner->data());
+      worker->launch(queue_, proxies_, node_id{}, hdr, std::move(*owner),
+                     offset, std::move(src), key);
+    } else {
+      worker->launch(queue_, proxies_, node_id{}, hdr, payload, std::move(src),
+                     key);
+    }
   } else {
-    CAF_LOG_DEBUG(
-      "out of BASP workers, continue deserializing an actor_message");
-    // If no worker is available then we have no other choice than to take
-    // the performance hit and deserialize in this thread.
+    CAF_LOG_DEBUG("deserialize actor_message in this thread"
+                  << CAF_ARG2("payload.size", payload.size()));
+    // Either the message is small or no worker is available. In the latter
+    // case, we have no other choice than to take the performance hit.
+    if (payload.size() > inline_threshold_)
+      ++dispatch_stats_.fallback_messages;
+    auto start = std::chrono::steady_clock::now();
     struct handler : remote_message_handler<handler> {
       handler(message_queue* queue, proxy_registry* proxies,
               actor_system* system, node_id last_hop, basp::header& hdr,
-              byte_span payload)
+              byte_span payload, strong_actor_ptr src, uint64_t key)
         : queue_(queue),
           proxies_(proxies),
           system_(system),
           last_hop_(std::move(last_hop)),
           hdr_(hdr),
-          payload_(payload) {
-        msg_id_ = queue_->new_id();
+          payload_(payload),
+          src_(std::move(src)) {
+        msg_id_ = queue_->new_id(key);
       }
       message_queue* queue_;
       proxy_registry* proxies_;
@@ -263,14 +356,183 @@ error application::handle_actor_message(packet_writer&, header hdr,
       node_id last_hop_;
       basp::header& hdr_;
       byte_span payload_;
+      strong_actor_ptr src_;
       uint64_t msg_id_;
     };
-    handler f{queue_.get(), &proxies_, system_, node_id{}, hdr, payload};
+    handler f{queue_.get(), &proxies_, system_, node_id{}, hdr, payload,
+              std::move(src), key};
     f.handle_remote_message(&executor_);
+    record_inline_dispatch(payload.size(),
+                           std::chrono::steady_clock::now() - start);
+  }
+  return none;
+}
+
+void application::record_inline_dispatch(size_t size, timespan elapsed) {
+  ++dispatch_stats_.inline_messages;
+  dispatch_stats_.inline_bytes += size;
+  dispatch_stats_.inline_time += elapsed;
+  if (inline_budget_.count() <= 0 || size == 0)
+    return;
+  // Smooth the cost per byte with a factor of 1/8 and allow as many bytes as
+  // we can deserialize within our budget.
+  auto cost = static_cast<double>(elapsed.count()) / size;
+  if (inline_cost_ > 0)
+    inline_cost_ += (cost - inline_cost_) / 8;
+  else
+    inline_cost_ = cost;
+  auto upper = static_cast<double>(max_inline_threshold_);
+  auto limit = inline_cost_ > 0 ? inline_budget_.count() / inline_cost_ : upper;
+  auto lower = std::min(min_inline_threshold, max_inline_threshold_);
+  inline_threshold_ = std::max(lower,
+                               static_cast<size_t>(std::min(limit, upper)));
+}
+
+error application::handle_heartbeat(packet_writer& writer, header hdr) {
+  CAF_LOG_TRACE(CAF_ARG(hdr));
+  // Heartbeats without timestamp only keep the connection busy.
+  if (hdr.operation_data == 0)
+    return none;
+  if ((hdr.operation_data & heartbeat_reply_flag) == 0) {
+    auto buf = writer.next_header_buffer();
+    to_bytes(header{message_type::heartbeat, 0,
+                    hdr.operation_data | heartbeat_reply_flag},
+             buf);
+    writer.write_packet(buf);
+    return none;
+  }
+  auto sent = timespan{
+    static_cast<int64_t>(hdr.operation_data & ~heartbeat_reply_flag)};
+  auto now = actor_clock::clock_type::now().time_since_epoch();
+  auto rtt = std::chrono::duration_cast<timespan>(now) - sent;
+  // Ignore answers with a timestamp from the future.
+  if (rtt.count() >= 0)
+    record_rtt(rtt);
+  return none;
+}
+
+void application::record_rtt(timespan rtt) {
+  auto& st = heartbeat_stats_;
+  st.last_rtt = rtt;
+  if (st.received_replies++ == 0) {
+    st.smoothed_rtt = rtt;
+    st.rtt_variance = rtt / 2;
+    return;
   }
+  // Same gains as TCP: 1/4 for the deviation and 1/8 for the mean.
+  auto delta = st.smoothed_rtt > rtt ? st.smoothed_rtt - rtt
+                                     : rtt - st.smoothed_rtt;
+  st.rtt_variance += (delta - st.rtt_variance) / 4;
+  st.smoothed_rtt += (rtt - st.smoothed_rtt) / 8;
+}
+
+error application::handle_actor_message_batch(packet_writer& writer,
+                                              header hdr, byte_span payload) {
+  CAF_LOG_TRACE(CAF_ARG(hdr) << CAF_ARG2("payload.size", payload.size()));
+  binary_deserializer source{&executor_, payload};
+  for (uint64_t i = 0; i < hdr.operation_data; ++i) {
+    uint32_t size = 0;
+    uint64_t mid = 0;
+    if (auto err = source(size, mid))
+      return err;
+    if (size > source.remaining())
+      return ec::invalid_payload;
+    auto entry = make_span(source.remainder().data(), size);
+    source.skip(size);
+    auto type = interning() ? message_type::interned_actor_message
+                            : message_type::actor_message;
+    header entry_hdr{type, size, mid};
+    if (auto err = handle_actor_message(writer, entry_hdr, entry))
+      return err;
+  }
+  if (source.remaining() > 0)
+    return ec::invalid_payload;
   return none;
 }
 
+error application::read_actor_ids(byte_span payload, actor_id& src_id,
+                                   actor_id& dst_id) {
+  binary_deserializer source{&executor_, payload};
+  auto n = peer_id_bytes_.size();
+  if (n > 0 && payload.size() >= n
+      && std::equal(peer_id_bytes_.begin(), peer_id_bytes_.end(),
+                    payload.begin())) {
+    source.skip(n);
+  } else {
+    node_id src_node;
+    if (auto err = source(src_node))
+      return err;
+  }
+  return source(src_id, dst_id);
+}
+
+error application::read_interned_source(binary_deserializer& source,
+                                        strong_actor_ptr& src) {
+  uint32_t ref = 0;
+  if (auto err = source(ref))
+    return err;
+  if (ref == 0)
+    return none;
+  if ((ref & interned_definition_flag) == 0) {
+    if (ref > interned_actors_.size() || !interned_actors_[ref - 1])
+      return ec::invalid_payload;
+    // The sender is gone if we have dropped its proxy in the meantime.
+    src = actor_cast<strong_actor_ptr>(interned_actors_[ref - 1]);
+    if (src == nullptr)
+      CAF_LOG_DEBUG("received message from a terminated actor" << CAF_ARG(ref));
+    return none;
+  }
+  node_id src_node;
+  actor_id src_id = 0;
+  if (auto err = source(src_node, src_id))
+    return err;
+  if (src_node != none && src_id != 0)
+    src = proxies_.get_or_put(src_node, src_id);
+  auto index = ref & ~interned_definition_flag;
+  if (index > 0) {
+    if (index > max_interned_actors)
+      return ec::invalid_payload;
+    if (interned_actors_.size() < index)
+      interned_actors_.resize(index);
+    interned_actors_[index - 1] = actor_cast<actor_addr>(src);
+  }
+  return none;
+}
+
+error application::handle_compressed_message(packet_writer& writer,
+                                             header hdr, byte_span payload) {
+  CAF_LOG_TRACE(CAF_ARG(hdr) << CAF_ARG2("payload.size", payload.size()));
+  if (payload.size() < header_size)
+    return ec::invalid_payload;
+  auto inner_hdr = header::from_bytes(payload);
+  if (inner_hdr.type == message_type::handshake
+      || inner_hdr.type == message_type::compressed_message)
+    return ec::invalid_payload;
+  auto start = std::chrono::steady_clock::now();
+  auto compressed = make_span(payload.data() + header_size,
+                              payload.size() - header_size);
+  auto& pool = buffer_pool::instance();
+  auto buf = pool.acquire(inner_hdr.payload_len);
+  if (auto err = decompress(compressed, inner_hdr.payload_len, buf)) {
+    pool.release(std::move(buf));
+    return ec::invalid_payload;
+  }
+  compression_stats_.decompression_time += std::chrono::steady_clock::now()
+                                           - start;
+  ++compression_stats_.decompressed_messages;
+  // Workers take ownership of the decompressed actor message instead of
+  // copying it. Otherwise, the buffer goes back to the pool after dispatching.
+  error result;
+  if (inner_hdr.type == message_type::actor_message
+      || inner_hdr.type == message_type::interned_actor_message)
+    result = handle_actor_message(writer, inner_hdr, buf, &buf);
+  else
+    result = handle(writer, inner_hdr, buf);
+  if (buf.capacity() > 0)
+    pool.release(std::move(buf));
+  return result;
+}
+
 error application::handle_resolve_request(packet_writer& writer, header rec_hdr,
                                           byte_span received) {
   CAF_LOG_TRACE(CAF_ARG(rec_hdr) << CAF_ARG2("received.size", received.size()));
@@ -382,7 +644,163 @@ error application::generate_handshake(byte_buffer& buf) {
   binary_serializer sink{&executor_, buf};
   return sink(system().node(),
               get_or(system().config(), "middleman.app-identifiers",
-                     application::default_app_ids()));
+                     application::default_app_ids()),
+              local_capabilities());
+}
+
+error application::serialize(binary_serializer& sink,
+                             const endpoint_manager_queue::message& msg) {
+  const auto& src = msg.msg->sender;
+  const auto& dst = msg.receiver;
+  if (interning()) {
+    uint32_t new_ref = 0;
+    if (auto err = write_interned_source(sink, src, new_ref))
+      return err;
+    if (auto err = sink(dst->id(), msg.msg->stages, msg.msg->content()))
+      return err;
+    // Our peer only learns the reference if we actually send this message.
+    if (new_ref != 0)
+      intern(src, new_ref);
+    return none;
+  } else if (src != nullptr) {
+    auto src_id = src->id();
+    system().registry().put(src_id, src);
+    if (auto err = sink(src->node(), src_id, dst->id(), msg.msg->stages))
+      return err;
+  } else {
+    if (auto err = sink(node_id{}, actor_id{0}, dst->id(), msg.msg->stages))
+      return err;
+  }
+  return sink(msg.msg->content());
+}
+
+error application::write_interned_source(binary_serializer& sink,
+                                         const strong_actor_ptr& src,
+                                         uint32_t& new_ref) {
+  if (src == nullptr)
+    return sink(uint32_t{0});
+  if (auto i = interned_ids_.find(actor_cast<actor_addr>(src));
+      i != interned_ids_.end())
+    return sink(i->second);
+  system().registry().put(src->id(), src);
+  // Once the table is full, we keep sending new actors as inline
+  // definitions with index 0.
+  new_ref = next_interned_ref();
+  return sink(new_ref | interned_definition_flag, src->node(), src->id());
+}
+
+uint32_t application::next_interned_ref() {
+  if (free_interned_refs_.empty() && max_interned_ref_ == max_interned_actors) {
+    // Scanning the full table is expensive, so we only do it every now and
+    // then while running out of references.
+    if (interned_purge_countdown_ > 0) {
+      --interned_purge_countdown_;
+      return 0;
+    }
+    interned_purge_countdown_ = interned_purge_interval;
+    for (auto i = interned_ids_.begin(); i != interned_ids_.end();) {
+      if (actor_cast<strong_actor_ptr>(i->first) == nullptr) {
+        // Our peer overrides the old entry when receiving a new definition.
+        free_interned_refs_.emplace_back(i->second);
+        i = interned_ids_.erase(i);
+      } else {
+        ++i;
+      }
+    }
+    CAF_LOG_DEBUG("freed interned references"
+                  << CAF_ARG2("count", free_interned_refs_.size()));
+  }
+  if (!free_interned_refs_.empty())
+    return free_interned_refs_.back();
+  if (max_interned_ref_ < max_interned_actors)
+    return max_interned_ref_ + 1;
+  return 0;
+}
+
+void application::intern(const strong_actor_ptr& src, uint32_t ref) {
+  if (!free_interned_refs_.empty())
+    free_interned_refs_.pop_back();
+  else
+    max_interned_ref_ = ref;
+  interned_ids_.emplace(actor_cast<actor_addr>(src), ref);
+}
+
+error application::write_batch(packet_writer& writer,
+                               endpoint_manager_queue::message_ptr first,
+                               endpoint_manager_queue::message_ptr second) {
+  auto payload_buf = writer.next_payload_buffer();
+  uint64_t num_messages = 0;
+  error result;
+  // Appends a message to the batch, prefixed by its size and message ID. A
+  // message that fails to serialize only drops itself from the batch.
+  auto append = [&](const endpoint_manager_queue::message& msg) {
+    if (msg.receiver == nullptr)
+      return;
+    auto offset = payload_buf.size();
+    payload_buf.resize(offset + batch_entry_header_size);
+    binary_serializer sink{system(), payload_buf};
+    if (auto err = serialize(sink, msg)) {
+      CAF_LOG_ERROR("unable to serialize an actor message:" << CAF_ARG(err));
+      payload_buf.resize(offset);
+      if (!result)
+        result = std::move(err);
+      return;
+    }
+    auto size = payload_buf.size() - offset - batch_entry_header_size;
+    sink.seek(offset);
+    if (auto err = sink(static_cast<uint32_t>(size),
+                        msg.msg->mid.integer_value()))
+      CAF_RAISE_ERROR("unable to serialize a batch entry header");
+    ++num_messages;
+  };
+  append(*first);
+  append(*second);
+  while (payload_buf.size() < max_batch_size_) {
+    auto next = manager_->next_message();
+    if (next == nullptr)
+      break;
+    append(*next);
+  }
+  if (num_messages == 0)
+    return result;
+  CAF_LOG_DEBUG("write batch frame" << CAF_ARG(num_messages)
+                                    << CAF_ARG2("size", payload_buf.size()));
+  write_actor_frame(writer,
+                    header{message_type::actor_message_batch,
+                           static_cast<uint32_t>(payload_buf.size()),
+                           num_messages},
+                    payload_buf);
+  return result;
+}
+
+void application::write_actor_frame(packet_writer& writer, header hdr,
+                                    byte_buffer& payload) {
+  if ((capabilities_ & compression_capability) != 0
+      && compression_threshold_ > 0
+      && payload.size() >= compression_threshold_) {
+    auto start = std::chrono::steady_clock::now();
+    auto frame = writer.next_payload_buffer();
+    to_bytes(hdr, frame);
+    compress(payload, frame);
+    compression_stats_.compression_time += std::chrono::steady_clock::now()
+                                           - start;
+    // Send the original payload if compressing did not pay off.
+    auto compressed_size = frame.size() - header_size;
+    if (compressed_size < payload.size()) {
+      ++compression_stats_.compressed_messages;
+      compression_stats_.uncompressed_bytes += payload.size();
+      compression_stats_.compressed_bytes += compressed_size;
+      auto outer_hdr = writer.next_header_buffer();
+      to_bytes(header{message_type::compressed_message,
+                      static_cast<uint32_t>(frame.size()), 0},
+               outer_hdr);
+      writer.write_packet(outer_hdr, frame);
+      return;
+    }
+  }
+  auto hdr_buf = writer.next_header_buffer();
+  to_bytes(hdr, hdr_buf);
+  writer.write_packet(hdr_buf, payload);
 }
 
 } // namespace caf::net::basp
@@ -41,6 +41,8 @@ std::string to_string(ec x) {
       return "invalid_scheme";
     case ec::invalid_locator:
       return "invalid_locator";
+    case ec::connection_timeout:
+      return "connection_timeout";
   };
 }
 
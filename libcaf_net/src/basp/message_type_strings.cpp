@@ -27,6 +27,12 @@ std::string to_string(message_type x) {
       return "down_message";
     case message_type::heartbeat:
       return "heartbeat";
+    case message_type::actor_message_batch:
+      return "actor_message_batch";
+    case message_type::compressed_message:
+      return "compressed_message";
+    case message_type::interned_actor_message:
+      return "interned_actor_message";
   };
 }
 
@@ -0,0 +1,187 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/net/buffer_pool.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include "caf/config.hpp"
+#include "caf/net/defaults.hpp"
+
+namespace caf::net {
+
+// -- thread-local caches ------------------------------------------------------
+
+struct buffer_pool::thread_cache {
+  buffer_pool* owner;
+
+  std::array<buffer_list, num_size_classes> lists;
+
+  explicit thread_cache(buffer_pool* owner) : owner(owner) {
+    // nop
+  }
+
+  ~thread_cache() {
+    // Threads may terminate at any time, so we simply free cached buffers.
+    size_t bytes = 0;
+    for (auto& list : lists)
+      for (auto& buf : list)
+        bytes += buf.capacity();
+    owner->pooled_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+};
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+buffer_pool::buffer_pool()
+  : limit_(defaults::middleman::buffer_pool_limit),
+    acquired_(0),
+    hits_(0),
+    released_(0),
+    discarded_(0),
+    pooled_bytes_(0) {
+  // nop
+}
+
+buffer_pool::~buffer_pool() {
+  // nop
+}
+
+buffer_pool& buffer_pool::instance() {
+  static buffer_pool instance;
+  return instance;
+}
+
+// -- properties ---------------------------------------------------------------
+
+buffer_pool::stats buffer_pool::statistics() const noexcept {
+  return {acquired_.load(std::memory_order_relaxed),
+          hits_.load(std::memory_order_relaxed),
+          released_.load(std::memory_order_relaxed),
+          discarded_.load(std::memory_order_relaxed),
+          pooled_bytes_.load(std::memory_order_relaxed)};
+}
+
+// -- buffer management --------------------------------------------------------
+
+byte_buffer buffer_pool::acquire(size_t size_hint) {
+  acquired_.fetch_add(1, std::memory_order_relaxed);
+  auto index = class_for_acquire(size_hint);
+  if (index == npos) {
+    byte_buffer result;
+    result.reserve(size_hint);
+    return result;
+  }
+  auto& local = local_lists()[index];
+  if (local.empty()) {
+    // Refill half of the local cache to amortize the locking.
+    auto& shared = shared_[index];
+    std::unique_lock<std::mutex> guard{shared.mtx};
+    auto& buffers = shared.buffers;
+    auto n = std::min(buffers.size(), thread_cache_size / 2);
+    for (size_t i = 0; i < n; ++i) {
+      local.emplace_back(std::move(buffers.back()));
+      buffers.pop_back();
+    }
+  }
+  if (!local.empty()) {
+    auto result = std::move(local.back());
+    local.pop_back();
+    pooled_bytes_.fetch_sub(result.capacity(), std::memory_order_relaxed);
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return result;
+  }
+  byte_buffer result;
+  result.reserve(min_class_size << index);
+  return result;
+}
+
+void buffer_pool::release(byte_buffer buf) {
+  auto capacity = buf.capacity();
+  auto index = class_for_release(capacity);
+  if (index == npos) {
+    discarded_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  auto pooled = pooled_bytes_.fetch_add(capacity, std::memory_order_relaxed);
+  if (pooled + capacity > limit()) {
+    pooled_bytes_.fetch_sub(capacity, std::memory_order_relaxed);
+    discarded_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  released_.fetch_add(1, std::memory_order_relaxed);
+  buf.clear();
+  auto& local = local_lists()[index];
+  if (local.size() >= thread_cache_size) {
+    // Move half of the local cache to the shared list to make buffers
+    // available to other threads.
+    auto& shared = shared_[index];
+    std::unique_lock<std::mutex> guard{shared.mtx};
+    auto first = local.begin() + static_cast<ptrdiff_t>(thread_cache_size / 2);
+    shared.buffers.insert(shared.buffers.end(),
+                          std::make_move_iterator(first),
+                          std::make_move_iterator(local.end()));
+    local.erase(first, local.end());
+  }
+  local.emplace_back(std::move(buf));
+}
+
+void buffer_pool::clear() {
+  size_t bytes = 0;
+  auto drop_all = [&bytes](buffer_list& buffers) {
+    for (auto& buf : buffers)
+      bytes += buf.capacity();
+    buffers.clear();
+  };
+  for (auto& list : local_lists())
+    drop_all(list);
+  for (auto& shared : shared_) {
+    std::unique_lock<std::mutex> guard{shared.mtx};
+    drop_all(shared.buffers);
+  }
+  pooled_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+// -- utility functions --------------------------------------------------------
+
+size_t buffer_pool::class_for_acquire(size_t size) noexcept {
+  size_t index = 0;
+  while ((min_class_size << index) < size)
+    if (++index == num_size_classes)
+      return npos;
+  return index;
+}
+
+size_t buffer_pool::class_for_release(size_t capacity) noexcept {
+  if (capacity < min_class_size || capacity > max_class_size)
+    return npos;
+  size_t index = 0;
+  while (index + 1 < num_size_classes
+         && (min_class_size << (index + 1)) <= capacity)
+    ++index;
+  return index;
+}
+
+std::array<buffer_pool::buffer_list, buffer_pool::num_size_classes>&
+buffer_pool::local_lists() {
+  thread_local thread_cache cache{this};
+  return cache.lists;
+}
+
+} // namespace caf::net
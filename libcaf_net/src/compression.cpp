@@ -0,0 +1,190 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/net/compression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "caf/sec.hpp"
+
+namespace caf::net {
+
+namespace {
+
+// The LZ4 block format encodes matches with at least 4 bytes.
+constexpr size_t min_match = 4;
+
+// The last match must start at least 12 bytes before the end of the input.
+constexpr size_t match_start_limit = 12;
+
+// The last 5 bytes of the input are always literals.
+constexpr size_t last_literals = 5;
+
+// Matches can refer to at most 65535 bytes back.
+constexpr size_t max_offset = 65535;
+
+constexpr size_t hash_bits = 12;
+
+uint32_t read32(const byte* ptr) {
+  uint32_t result;
+  memcpy(&result, ptr, sizeof(result));
+  return result;
+}
+
+size_t hash(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - hash_bits);
+}
+
+void write_length(byte_buffer& output, size_t len) {
+  for (; len >= 255; len -= 255)
+    output.push_back(byte{255});
+  output.push_back(static_cast<byte>(len));
+}
+
+void write_sequence(byte_buffer& output, const byte* literals, size_t num,
+                    size_t offset, size_t match_len) {
+  auto ml = match_len - min_match;
+  auto token = (std::min(num, size_t{15}) << 4) | std::min(ml, size_t{15});
+  output.push_back(static_cast<byte>(token));
+  if (num >= 15)
+    write_length(output, num - 15);
+  output.insert(output.end(), literals, literals + num);
+  output.push_back(static_cast<byte>(offset & 0xFF));
+  output.push_back(static_cast<byte>(offset >> 8));
+  if (ml >= 15)
+    write_length(output, ml - 15);
+}
+
+void write_last_literals(byte_buffer& output, const byte* literals,
+                         size_t num) {
+  output.push_back(static_cast<byte>(std::min(num, size_t{15}) << 4));
+  if (num >= 15)
+    write_length(output, num - 15);
+  output.insert(output.end(), literals, literals + num);
+}
+
+// Reads a length extension, i.e., a sequence of bytes that ends with the
+// first byte less than 255.
+bool read_length(span<const byte> input, size_t& pos, size_t& len) {
+  for (;;) {
+    if (pos == input.size())
+      return false;
+    auto x = static_cast<size_t>(input[pos++]);
+    len += x;
+    if (x < 255)
+      return true;
+  }
+}
+
+} // namespace
+
+void compress(span<const byte> input, byte_buffer& output) {
+  auto src = input.data();
+  auto n = input.size();
+  size_t anchor = 0;
+  if (n >= match_start_limit) {
+    std::array<uint32_t, size_t{1} << hash_bits> table{};
+    size_t pos = 0;
+    auto limit = n - match_start_limit;
+    while (pos <= limit) {
+      auto sequence = read32(src + pos);
+      auto& slot = table[hash(sequence)];
+      size_t candidate = slot;
+      slot = static_cast<uint32_t>(pos);
+      if (candidate >= pos || pos - candidate > max_offset
+          || read32(src + candidate) != sequence) {
+        ++pos;
+        continue;
+      }
+      // Extend the match forward, but leave room for the last literals.
+      size_t len = min_match;
+      auto max_len = n - last_literals - pos;
+      while (len < max_len && src[candidate + len] == src[pos + len])
+        ++len;
+      // Extend the match backward into pending literals.
+      while (pos > anchor && candidate > 0
+             && src[pos - 1] == src[candidate - 1]) {
+        --pos;
+        --candidate;
+        ++len;
+      }
+      write_sequence(output, src + anchor, pos - anchor, pos - candidate, len);
+      pos += len;
+      anchor = pos;
+    }
+  }
+  write_last_literals(output, src + anchor, n - anchor);
+}
+
+error decompress(span<const byte> input, size_t decompressed_size,
+                 byte_buffer& output) {
+  auto malformed = [] {
+    return make_error(sec::invalid_argument, "malformed compressed block");
+  };
+  // Each input byte expands to at most 255 output bytes. Checking this bound
+  // first keeps malicious size hints from allocating huge buffers.
+  if (decompressed_size > input.size() * 255 + min_match)
+    return malformed();
+  output.resize(decompressed_size);
+  auto dst = output.data();
+  size_t ipos = 0;
+  size_t opos = 0;
+  for (;;) {
+    if (ipos == input.size())
+      return malformed();
+    auto token = static_cast<size_t>(input[ipos++]);
+    auto num = token >> 4;
+    if (num == 15 && !read_length(input, ipos, num))
+      return malformed();
+    if (num > input.size() - ipos || num > decompressed_size - opos)
+      return malformed();
+    if (num > 0)
+      memcpy(dst + opos, input.data() + ipos, num);
+    ipos += num;
+    opos += num;
+    // The last sequence only consists of literals.
+    if (ipos == input.size())
+      break;
+    if (input.size() - ipos < 2)
+      return malformed();
+    auto offset = static_cast<size_t>(input[ipos])
+                  | (static_cast<size_t>(input[ipos + 1]) << 8);
+    ipos += 2;
+    if (offset == 0 || offset > opos)
+      return malformed();
+    auto len = token & 0x0F;
+    if (len == 15 && !read_length(input, ipos, len))
+      return malformed();
+    len += min_match;
+    if (len > decompressed_size - opos)
+      return malformed();
+    // Matches may overlap with their own output, so copy byte by byte.
+    auto from = dst + opos - offset;
+    for (size_t i = 0; i < len; ++i)
+      dst[opos + i] = from[i];
+    opos += len;
+  }
+  if (opos != decompressed_size)
+    return malformed();
+  return none;
+}
+
+} // namespace caf::net
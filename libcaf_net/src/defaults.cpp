@@ -18,12 +18,50 @@
 
 #include "caf/net/defaults.hpp"
 
+#include <chrono>
+
 namespace caf::defaults::middleman {
 
-const size_t max_payload_buffers = 100;
+const size_t basp_max_batch_size = 64 * 1024;
+
+const size_t basp_compression_threshold = 0;
+
+const size_t basp_inline_threshold = 512;
+
+const timespan basp_inline_budget = timespan{0};
+
+const timespan connection_timeout = std::chrono::seconds{30};
 
-const size_t max_header_buffers = 10;
+const size_t buffer_pool_limit = 64 * 1024 * 1024;
+
+const size_t datagram_batch_size = 16;
+
+const bool udp_gso = false;
+
+const bool udp_gro = false;
+
+const timespan heartbeat_interval = timespan{0};
 
 const uint16_t tcp_port = 0;
 
+const size_t multiplexer_threads = 1;
+
+const size_t min_workers = 1;
+
+const size_t stream_read_buffer_size = 4096;
+
+const size_t stream_read_buffer_max_size = 65536;
+
+const size_t stream_handoff_threshold = 16 * 1024;
+
+const size_t write_queue_high_watermark = 16 * 1024 * 1024;
+
+const size_t write_queue_low_watermark = 4 * 1024 * 1024;
+
+const timespan worker_idle_timeout = std::chrono::minutes{5};
+
+const timespan worker_trim_interval = std::chrono::seconds{1};
+
+const size_t zerocopy_threshold = 0;
+
 } // namespace caf::defaults::middleman
@@ -18,7 +18,9 @@
 
 #include "caf/net/endpoint_manager.hpp"
 
+#include "caf/detail/sync_request_bouncer.hpp"
 #include "caf/intrusive/inbox_result.hpp"
+#include "caf/logger.hpp"
 #include "caf/net/multiplexer.hpp"
 #include "caf/sec.hpp"
 #include "caf/send.hpp"
@@ -27,7 +29,12 @@ namespace caf::net {
 
 endpoint_manager::endpoint_manager(socket handle, const multiplexer_ptr& parent,
                                    actor_system& sys)
-  : super(handle, parent), sys_(sys), queue_(unit, unit, unit) {
+  : super(handle, parent),
+    sys_(sys),
+    queue_(unit, unit, unit),
+    overloaded_(false),
+    policy_(parent->default_overload_policy()),
+    dropped_messages_(0) {
   queue_.try_block();
 }
 
@@ -50,6 +57,24 @@ endpoint_manager_queue::message_ptr endpoint_manager::next_message() {
   return result;
 }
 
+void endpoint_manager::overloaded(bool value) noexcept {
+  if (overloaded_.exchange(value, std::memory_order_relaxed) != value)
+    CAF_LOG_DEBUG(CAF_ARG2("handle", handle_.id)
+                  << CAF_ARG2("overloaded", value));
+}
+
+uint64_t endpoint_manager::set_timeout(actor_clock::time_point tp,
+                                       std::string type) {
+  auto mpx = parent_.lock();
+  CAF_ASSERT(mpx != nullptr);
+  return mpx->set_timeout(tp, this, std::move(type));
+}
+
+void endpoint_manager::cancel_timeout(uint64_t id) {
+  if (auto mpx = parent_.lock())
+    mpx->cancel_timeout(id);
+}
+
 void endpoint_manager::resolve(uri locator, actor listener) {
   using intrusive::inbox_result;
   using event_type = endpoint_manager_queue::event;
@@ -61,6 +86,21 @@ void endpoint_manager::resolve(uri locator, actor listener) {
 void endpoint_manager::enqueue(mailbox_element_ptr msg,
                                strong_actor_ptr receiver) {
   using message_type = endpoint_manager_queue::message;
+  if (overloaded() && policy_ != overload_policy::none) {
+    CAF_LOG_DEBUG("drop message for overloaded endpoint"
+                  << CAF_ARG2("handle", handle_.id));
+    dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+    if (policy_ == overload_policy::error
+        || (policy_ == overload_policy::notify && msg->mid.is_request())) {
+      detail::sync_request_bouncer bouncer{
+        make_error(sec::unavailable_or_would_block)};
+      bouncer(*msg);
+    } else if (policy_ == overload_policy::notify && msg->sender != nullptr) {
+      anon_send(actor_cast<actor>(msg->sender),
+                make_error(sec::unavailable_or_would_block));
+    }
+    return;
+  }
   auto ptr = new message_type(std::move(msg), std::move(receiver));
   enqueue(ptr);
 }
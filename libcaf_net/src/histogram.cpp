@@ -0,0 +1,112 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/net/histogram.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "caf/config.hpp"
+
+namespace caf::net {
+
+// -- snapshot -----------------------------------------------------------------
+
+double histogram::snapshot::mean() const noexcept {
+  if (count == 0)
+    return 0.0;
+  return static_cast<double>(sum) / static_cast<double>(count);
+}
+
+uint64_t histogram::snapshot::quantile(double q) const noexcept {
+  CAF_ASSERT(q >= 0.0 && q <= 1.0);
+  if (count == 0)
+    return 0;
+  auto rank = static_cast<uint64_t>(q * static_cast<double>(count));
+  if (rank == 0)
+    rank = 1;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < num_buckets; ++i) {
+    seen += buckets[i];
+    if (seen >= rank)
+      return std::min(upper_bound(i), max);
+  }
+  return max;
+}
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+histogram::histogram() noexcept {
+  reset();
+}
+
+// -- properties ---------------------------------------------------------------
+
+size_t histogram::bucket_of(uint64_t value) noexcept {
+  size_t result = 0;
+  while (value != 0 && result + 1 < num_buckets) {
+    value >>= 1;
+    ++result;
+  }
+  return result;
+}
+
+uint64_t histogram::upper_bound(size_t bucket) noexcept {
+  if (bucket + 1 >= num_buckets)
+    return std::numeric_limits<uint64_t>::max();
+  return uint64_t{1} << bucket;
+}
+
+histogram::snapshot histogram::read() const noexcept {
+  snapshot result;
+  for (size_t i = 0; i < num_buckets; ++i)
+    result.buckets[i] = buckets_[i].load(std::memory_order_acquire);
+  result.count = count_.load(std::memory_order_relaxed);
+  result.sum = sum_.load(std::memory_order_relaxed);
+  result.max = max_.load(std::memory_order_relaxed);
+  return result;
+}
+
+// -- modifiers ----------------------------------------------------------------
+
+void histogram::record(uint64_t value) noexcept {
+  // There is only a single writer. Hence, we can get away with relaxed
+  // load/store pairs instead of read-modify-write operations.
+  auto inc = [](std::atomic<uint64_t>& x, uint64_t n) {
+    x.store(x.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  };
+  inc(buckets_[bucket_of(value)], 1);
+  inc(count_, 1);
+  inc(sum_, value);
+  if (value > max_.load(std::memory_order_relaxed))
+    max_.store(value, std::memory_order_relaxed);
+}
+
+void histogram::reset() noexcept {
+  // Clear the count first and publish it with the zeroed buckets. A reader
+  // that observes a zeroed bucket then also observes the zeroed count and
+  // treats the histogram as empty instead of computing quantiles from a
+  // count that no longer matches the buckets.
+  count_.store(0, std::memory_order_relaxed);
+  for (auto& x : buckets_)
+    x.store(0, std::memory_order_release);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace caf::net
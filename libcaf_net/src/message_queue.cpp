@@ -18,31 +18,36 @@
 
 #include "caf/net/basp/message_queue.hpp"
 
-#include <iterator>
+#include <algorithm>
 
 namespace caf::net::basp {
 
-message_queue::message_queue() : next_id(0), next_undelivered(0) {
-  // nop
+message_queue::message_queue() {
+  for (size_t i = 0; i < num_shards; ++i) {
+    auto& x = shards[i];
+    x.next_id = static_cast<uint64_t>(i) << shard_shift;
+    x.next_undelivered = x.next_id;
+  }
 }
 
 void message_queue::push(execution_unit* ctx, uint64_t id,
                          strong_actor_ptr receiver,
                          mailbox_element_ptr content) {
-  std::unique_lock<std::mutex> guard{lock};
-  CAF_ASSERT(id >= next_undelivered);
-  CAF_ASSERT(id < next_id);
-  auto first = pending.begin();
-  auto last = pending.end();
-  if (id == next_undelivered) {
+  auto& x = shards[shard_index(id)];
+  std::unique_lock<std::mutex> guard{x.lock};
+  CAF_ASSERT(id >= x.next_undelivered);
+  CAF_ASSERT(id < x.next_id);
+  auto first = x.pending.begin();
+  auto last = x.pending.end();
+  if (id == x.next_undelivered) {
     // Dispatch current head.
     if (receiver != nullptr)
       receiver->enqueue(std::move(content), ctx);
     auto next = id + 1;
     // Check whether we can deliver more.
     if (first == last || first->id != next) {
-      next_undelivered = next;
-      CAF_ASSERT(next_undelivered <= next_id);
+      x.next_undelivered = next;
+      CAF_ASSERT(x.next_undelivered <= x.next_id);
       return;
     }
     // Deliver everything until reaching a non-consecutive ID or the end.
@@ -50,24 +55,25 @@ void message_queue::push(execution_unit* ctx, uint64_t id,
     for (; i != last && i->id == next; ++i, ++next)
       if (i->receiver != nullptr)
         i->receiver->enqueue(std::move(i->content), ctx);
-    next_undelivered = next;
-    pending.erase(first, i);
-    CAF_ASSERT(next_undelivered <= next_id);
+    x.next_undelivered = next;
+    x.pending.erase(first, i);
+    CAF_ASSERT(x.next_undelivered <= x.next_id);
     return;
   }
   // Get the insertion point.
-  auto pred = [&](const actor_msg& x) { return x.id >= id; };
-  pending.emplace(std::find_if(first, last, pred),
-                  actor_msg{id, std::move(receiver), std::move(content)});
+  auto pred = [](const actor_msg& x, uint64_t id) { return x.id < id; };
+  x.pending.emplace(std::lower_bound(first, last, id, pred),
+                    actor_msg{id, std::move(receiver), std::move(content)});
 }
 
 void message_queue::drop(execution_unit* ctx, uint64_t id) {
   push(ctx, id, nullptr, nullptr);
 }
 
-uint64_t message_queue::new_id() {
-  std::unique_lock<std::mutex> guard{lock};
-  return next_id++;
+uint64_t message_queue::new_id(uint64_t key) {
+  auto& x = shards[shard_index(key)];
+  std::unique_lock<std::mutex> guard{x.lock};
+  return x.next_id++;
 }
 
 } // namespace caf::net::basp
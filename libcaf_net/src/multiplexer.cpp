@@ -19,6 +19,8 @@
 #include "caf/net/multiplexer.hpp"
 
 #include <algorithm>
+#include <chrono>
+#include <limits>
 
 #include "caf/byte.hpp"
 #include "caf/config.hpp"
@@ -39,6 +41,12 @@
 #  include "caf/detail/socket_sys_includes.hpp"
 #endif // CAF_WINDOWS
 
+#ifdef CAF_LINUX
+#  include <cerrno>
+#  include <sys/epoll.h>
+#  include <unistd.h>
+#endif // CAF_LINUX
+
 namespace caf::net {
 
 #ifndef POLLRDHUP
@@ -76,21 +84,127 @@ short to_bitmask(operation op) {
   }
 }
 
+#ifdef CAF_LINUX
+
+/// Upper bound for the number of events we fetch with a single `epoll_wait`.
+constexpr size_t max_epoll_events = 1024;
+
+uint32_t to_epoll_events(short events) {
+  uint32_t result = 0;
+  if ((events & POLLIN) != 0)
+    result |= EPOLLIN;
+  if ((events & POLLPRI) != 0)
+    result |= EPOLLPRI;
+  if ((events & POLLOUT) != 0)
+    result |= EPOLLOUT;
+  if ((events & POLLRDHUP) != 0)
+    result |= EPOLLRDHUP;
+  return result;
+}
+
+short from_epoll_events(uint32_t events) {
+  short result = 0;
+  if ((events & EPOLLIN) != 0)
+    result |= POLLIN;
+  if ((events & EPOLLPRI) != 0)
+    result |= POLLPRI;
+  if ((events & EPOLLOUT) != 0)
+    result |= POLLOUT;
+  if ((events & EPOLLERR) != 0)
+    result |= POLLERR;
+  if ((events & EPOLLHUP) != 0)
+    result |= POLLHUP;
+  if ((events & EPOLLRDHUP) != 0)
+    result |= POLLRDHUP;
+  return result;
+}
+
+/// Marks timeout operations of the io_uring backend.
+constexpr uint64_t uring_timeout_id = 0;
+
+/// Marks cancel operations of the io_uring backend.
+constexpr uint64_t uring_cancel_id = std::numeric_limits<uint64_t>::max();
+
+/// Converts the result of a read or write operation on an io_uring.
+variant<size_t, sec> from_uring_result(int32_t res) {
+  if (res > 0)
+    return static_cast<size_t>(res);
+  if (res == 0)
+    return sec::socket_disconnected;
+  if (res == -EAGAIN)
+    return sec::unavailable_or_would_block;
+  return sec::socket_operation_failed;
+}
+
+#endif // CAF_LINUX
+
 } // namespace
 
-multiplexer::multiplexer() : shutting_down_(false) {
+multiplexer::multiplexer() : multiplexer(default_backend) {
   // nop
 }
 
+multiplexer::multiplexer(backend_type backend)
+  : backend_(backend),
+#ifdef CAF_LINUX
+    epoll_fd_(-1),
+#endif // CAF_LINUX
+    shutting_down_(false) {
+  // The pollset updater only receives a wakeup signal for commands that
+  // arrive at a blocked queue.
+  commands_.try_block();
+}
+
 multiplexer::~multiplexer() {
-  // nop
+  if (!commands_.closed())
+    commands_.close();
+#ifdef CAF_LINUX
+  if (epoll_fd_ != -1)
+    ::close(epoll_fd_);
+  if (ring_.valid() && !uring_ops_.empty()) {
+    // Give the kernel a chance to release our buffers before closing the
+    // ring. Pending operations on sockets that remain open may not complete
+    // in time, but closing the ring cancels them anyway.
+    for (auto& kvp : uring_ops_)
+      ring_.cancel(uring_cancel_id, kvp.first);
+    if (ring_.enter(0) == 0) {
+      ring_.drain(completions_);
+      for (auto& cqe : completions_)
+        uring_ops_.erase(cqe.user_data);
+    }
+  }
+#endif // CAF_LINUX
 }
 
 error multiplexer::init() {
-  auto pipe_handles = make_pipe();
+  if (backend_ == backend_type::epoll) {
+#ifdef CAF_LINUX
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ == -1)
+      return make_error(sec::network_syscall_failed, "epoll_create1",
+                        last_socket_error_as_string());
+#else
+    return make_error(sec::runtime_error,
+                      "the epoll backend is only available on Linux");
+#endif // CAF_LINUX
+  } else if (backend_ == backend_type::io_uring) {
+#ifdef CAF_LINUX
+    if (auto err = ring_.init()) {
+      CAF_LOG_WARNING("io_uring unavailable, falling back to poll:" << err);
+      backend_ = backend_type::poll;
+    }
+#else
+    CAF_LOG_WARNING("io_uring is only available on Linux, using poll");
+    backend_ = backend_type::poll;
+#endif // CAF_LINUX
+  }
+  auto pipe_handles = make_wakeup_pipe();
   if (!pipe_handles)
     return std::move(pipe_handles.error());
-  add(make_counted<pollset_updater>(pipe_handles->first, shared_from_this()));
+  auto updater = make_counted<pollset_updater>(pipe_handles->first,
+                                               shared_from_this());
+  updater_ = updater.get();
+  add(std::move(updater));
   write_handle_ = pipe_handles->second;
   return none;
 }
@@ -100,10 +214,8 @@ size_t multiplexer::num_socket_managers() const noexcept {
 }
 
 ptrdiff_t multiplexer::index_of(const socket_manager_ptr& mgr) {
-  auto first = managers_.begin();
-  auto last = managers_.end();
-  auto i = std::find(first, last, mgr);
-  return i == last ? -1 : std::distance(first, i);
+  auto i = indexes_.find(mgr.get());
+  return i == indexes_.end() ? -1 : static_cast<ptrdiff_t>(i->second);
 }
 
 void multiplexer::register_reading(const socket_manager_ptr& mgr) {
@@ -112,15 +224,13 @@ void multiplexer::register_reading(const socket_manager_ptr& mgr) {
       // discard
     } else if (mgr->mask() != operation::none) {
       CAF_ASSERT(index_of(mgr) != -1);
-      if (mgr->mask_add(operation::read)) {
-        auto& fd = pollset_[index_of(mgr)];
-        fd.events |= input_mask;
-      }
+      if (mgr->mask_add(operation::read))
+        set_events(index_of(mgr), to_bitmask(mgr->mask()));
     } else if (mgr->mask_add(operation::read)) {
       add(mgr);
     }
   } else {
-    write_to_pipe(0, mgr);
+    push_command(opcode::register_reading, mgr);
   }
 }
 
@@ -130,19 +240,26 @@ void multiplexer::register_writing(const socket_manager_ptr& mgr) {
       // discard
     } else if (mgr->mask() != operation::none) {
       CAF_ASSERT(index_of(mgr) != -1);
-      if (mgr->mask_add(operation::write)) {
-        auto& fd = pollset_[index_of(mgr)];
-        fd.events |= output_mask;
-      }
+      if (mgr->mask_add(operation::write))
+        set_events(index_of(mgr), to_bitmask(mgr->mask()));
     } else if (mgr->mask_add(operation::write)) {
       add(mgr);
     }
   } else {
-    write_to_pipe(1, mgr);
+    push_command(opcode::register_writing, mgr);
   }
 }
 
 void multiplexer::close_pipe() {
+  if (std::this_thread::get_id() != tid_) {
+    push_command(opcode::close_pipe, nullptr);
+    return;
+  }
+  // Closing the queue drops all pending commands. The final wakeup makes the
+  // pollset updater remove itself from the pollset.
+  if (!commands_.closed())
+    commands_.close();
+  wakeup();
   std::lock_guard<std::mutex> guard{write_lock_};
   if (write_handle_ != invalid_socket) {
     close(write_handle_);
@@ -150,19 +267,75 @@ void multiplexer::close_pipe() {
   }
 }
 
+bool multiplexer::handle_commands() {
+  using node_pointer = command_queue::node_pointer;
+  for (;;) {
+    if (commands_.closed())
+      return false;
+    if (commands_.blocked())
+      return true;
+    auto head = commands_.take_head();
+    if (head == nullptr) {
+      if (commands_.try_block())
+        return true;
+      // A producer enqueued a new command in the meantime.
+      continue;
+    }
+    // The queue is a LIFO stack. Reverse the batch to run commands in the
+    // order other threads have submitted them.
+    node_pointer batch = nullptr;
+    while (head != nullptr) {
+      auto next = head->next;
+      head->next = batch;
+      batch = head;
+      head = next;
+    }
+    while (batch != nullptr) {
+      std::unique_ptr<command> cmd{static_cast<command*>(batch)};
+      batch = batch->next;
+      switch (cmd->op) {
+        case opcode::register_reading:
+          register_reading(cmd->mgr);
+          break;
+        case opcode::register_writing:
+          register_writing(cmd->mgr);
+          break;
+        case opcode::close_pipe:
+          close_pipe();
+          break;
+        case opcode::shutdown:
+          shutdown();
+          break;
+      }
+    }
+  }
+}
+
 bool multiplexer::poll_once(bool blocking) {
-  if (pollset_.empty())
+  if (managers_.empty())
     return false;
+#ifdef CAF_LINUX
+  if (backend_ == backend_type::epoll)
+    return epoll_once(blocking);
+  if (backend_ == backend_type::io_uring)
+    return uring_once(blocking);
+#endif // CAF_LINUX
   // We'll call poll() until poll() succeeds or fails.
   for (;;) {
+    auto record_metrics = metrics_enabled();
+    std::chrono::steady_clock::time_point start;
+    if (record_metrics)
+      start = std::chrono::steady_clock::now();
     int presult;
 #ifdef CAF_WINDOWS
     presult = ::WSAPoll(pollset_.data(), static_cast<ULONG>(pollset_.size()),
-                        blocking ? -1 : 0);
+                        poll_timeout(blocking));
 #else
     presult = ::poll(pollset_.data(), static_cast<nfds_t>(pollset_.size()),
-                     blocking ? -1 : 0);
+                     poll_timeout(blocking));
 #endif
+    if (record_metrics)
+      record_poll(start, presult);
     if (presult < 0) {
       auto code = last_socket_error();
       switch (code) {
@@ -193,7 +366,7 @@ bool multiplexer::poll_once(bool blocking) {
                               << presult << "event(s)");
     // No activity.
     if (presult == 0)
-      return false;
+      return handle_timeouts();
     // Scan pollset for events.
     CAF_LOG_DEBUG("scan pollset for socket events");
     for (size_t i = 0; i < pollset_.size() && presult > 0;) {
@@ -212,30 +385,369 @@ bool multiplexer::poll_once(bool blocking) {
       }
       ++i;
     }
+    handle_timeouts();
+    return true;
+  }
+}
+
+#ifdef CAF_LINUX
+
+bool multiplexer::epoll_once(bool blocking) {
+  events_.resize(std::min(managers_.size(), max_epoll_events));
+  // We'll call epoll_wait() until it succeeds or fails.
+  for (;;) {
+    auto record_metrics = metrics_enabled();
+    std::chrono::steady_clock::time_point start;
+    if (record_metrics)
+      start = std::chrono::steady_clock::now();
+    auto presult = epoll_wait(epoll_fd_, events_.data(),
+                              static_cast<int>(events_.size()),
+                              poll_timeout(blocking));
+    if (record_metrics)
+      record_poll(start, presult);
+    if (presult < 0) {
+      if (errno == EINTR) {
+        // A signal was caught. Simply try again.
+        CAF_LOG_DEBUG("received errc::interrupted, try again");
+        continue;
+      }
+      // Must not happen.
+      auto msg = std::generic_category().message(errno);
+      string_view prefix = "epoll_wait() failed: ";
+      msg.insert(msg.begin(), prefix.begin(), prefix.end());
+      CAF_CRITICAL(msg.c_str());
+    }
+    CAF_LOG_DEBUG("epoll_wait() on" << managers_.size() << "sockets reported"
+                                    << presult << "event(s)");
+    // No activity.
+    if (presult == 0)
+      return handle_timeouts();
+    // Pin all ready managers before running any event handler.
+    CAF_ASSERT(ready_.empty());
+    for (int i = 0; i < presult; ++i) {
+      auto ptr = static_cast<socket_manager*>(events_[i].data.ptr);
+      ready_.emplace_back(socket_manager_ptr{ptr},
+                          from_epoll_events(events_[i].events));
+    }
+    for (auto& [mgr, revents] : ready_) {
+      auto index = index_of(mgr);
+      // Skip managers that a previous event handler removed from the pollset.
+      if (index == -1)
+        continue;
+      auto events = to_bitmask(mgr->mask());
+      auto new_events = handle(mgr, events, revents);
+      if (new_events == 0)
+        del(index);
+      else if (new_events != events)
+        set_events(index, new_events);
+    }
+    ready_.clear();
+    handle_timeouts();
     return true;
   }
 }
 
+bool multiplexer::uring_once(bool blocking) {
+  uring_arm_dirty();
+  auto timeout = poll_timeout(blocking);
+  if (timeout > 0)
+    ring_.timeout(uring_timeout_id, std::chrono::milliseconds{timeout});
+  auto record_metrics = metrics_enabled();
+  std::chrono::steady_clock::time_point start;
+  if (record_metrics)
+    start = std::chrono::steady_clock::now();
+  // We'll call io_uring_enter() until it succeeds or fails.
+  for (;;) {
+    auto code = ring_.enter(timeout != 0 ? 1 : 0);
+    if (code == 0)
+      break;
+    if (code == EINTR) {
+      // A signal was caught. Simply try again.
+      CAF_LOG_DEBUG("received errc::interrupted, try again");
+      continue;
+    }
+    if (code == EAGAIN || code == EBUSY) {
+      // The completion queue overflowed. Draining it resolves the issue.
+      CAF_LOG_DEBUG("io_uring_enter() reported a full completion queue");
+      break;
+    }
+    // Must not happen.
+    auto msg = std::generic_category().message(code);
+    string_view prefix = "io_uring_enter() failed: ";
+    msg.insert(msg.begin(), prefix.begin(), prefix.end());
+    CAF_CRITICAL(msg.c_str());
+  }
+  CAF_ASSERT(completions_.empty());
+  ring_.drain(completions_);
+  auto num_events = std::count_if(completions_.begin(), completions_.end(),
+                                  [](const uring::completion& cqe) {
+                                    return cqe.user_data != uring_timeout_id
+                                           && cqe.user_data != uring_cancel_id;
+                                  });
+  if (record_metrics)
+    record_poll(start, static_cast<int>(num_events));
+  CAF_LOG_DEBUG("io_uring_enter() reported" << num_events << "event(s)");
+  // No activity.
+  if (num_events == 0) {
+    completions_.clear();
+    return handle_timeouts();
+  }
+  for (auto& cqe : completions_)
+    uring_dispatch(cqe);
+  completions_.clear();
+  handle_timeouts();
+  return true;
+}
+
+void multiplexer::uring_mark_dirty(ptrdiff_t index) {
+  CAF_ASSERT(index != -1);
+  auto& st = uring_states_[index];
+  if (!st.dirty) {
+    st.dirty = true;
+    uring_dirty_.emplace_back(managers_[index]);
+  }
+}
+
+void multiplexer::uring_arm_dirty() {
+  // Arming a manager may run its write handler, which in turn may mark other
+  // managers as dirty.
+  std::vector<socket_manager_ptr> dirty;
+  while (!uring_dirty_.empty()) {
+    dirty.swap(uring_dirty_);
+    for (auto& mgr : dirty) {
+      // Skip managers that left the pollset in the meantime.
+      auto index = index_of(mgr);
+      if (index != -1 && uring_states_[index].dirty) {
+        uring_states_[index].dirty = false;
+        uring_arm(index);
+      }
+    }
+    dirty.clear();
+  }
+}
+
+void multiplexer::uring_arm(ptrdiff_t index) {
+  auto mgr = managers_[index];
+  auto fd = mgr->handle().id;
+  auto next_id = [this] { return next_uring_op_++; };
+  if (!mgr->supports_completions()) {
+    // Readiness polls are one-shot. Replace the poll if the mask changed.
+    auto& st = uring_states_[index];
+    auto events = to_bitmask(mgr->mask());
+    if (st.poll_op != 0 && st.poll_events == events)
+      return;
+    if (st.poll_op != 0) {
+      ring_.cancel(uring_cancel_id, st.poll_op);
+      st.poll_op = 0;
+    }
+    if (events == 0)
+      return;
+    auto id = next_id();
+    if (!ring_.poll(id, fd, events)) {
+      CAF_LOG_ERROR("failed to submit a poll" << CAF_ARG2("socket", fd));
+      return;
+    }
+    st.poll_op = id;
+    st.poll_events = events;
+    uring_ops_.emplace(id, uring_op{mgr, operation::none, nullptr});
+    return;
+  }
+  // Managers with completion-based I/O have at most one read and one write
+  // in flight. We never cancel a write while the manager still runs.
+  if ((mgr->mask() & operation::read) == operation::read) {
+    if (uring_states_[index].read_op == 0) {
+      auto buf = mgr->read_buffer();
+      auto id = next_id();
+      // Datagram reads also need to receive the sender.
+      uring::msg_args_ptr args;
+      auto ok = false;
+      if (!buf.empty()) {
+        if (mgr->uses_datagrams())
+          ok = (args = ring_.recvmsg(id, fd, buf)) != nullptr;
+        else
+          ok = ring_.recv(id, fd, buf);
+      }
+      if (ok) {
+        uring_states_[index].read_op = id;
+        uring_ops_.emplace(id,
+                           uring_op{mgr, operation::read, std::move(args)});
+      } else {
+        CAF_LOG_ERROR("failed to submit a read" << CAF_ARG2("socket", fd));
+      }
+    }
+  } else if (auto& st = uring_states_[index];
+             st.read_op != 0 && !st.read_cancel_pending) {
+    // Cancel only once. The read stays pending until its completion arrives.
+    ring_.cancel(uring_cancel_id, st.read_op);
+    st.read_cancel_pending = true;
+  }
+  if ((mgr->mask() & operation::write) == operation::write
+      && uring_states_[index].write_op == 0) {
+    // Fetching the buffers may add or remove managers.
+    auto bufs = mgr->write_buffers();
+    index = index_of(mgr);
+    if (index == -1)
+      return;
+    if (bufs.empty()) {
+      if (mgr->mask_del(operation::write) && mgr->mask() == operation::none)
+        del(index);
+      return;
+    }
+    auto id = next_id();
+    auto args = mgr->uses_datagrams()
+                  ? ring_.sendmsg(id, fd, bufs, mgr->write_destination())
+                  : ring_.sendmsg(id, fd, bufs);
+    if (args) {
+      uring_states_[index].write_op = id;
+      uring_ops_.emplace(id, uring_op{mgr, operation::write, std::move(args)});
+    } else {
+      CAF_LOG_ERROR("failed to submit a write" << CAF_ARG2("socket", fd));
+    }
+  }
+}
+
+void multiplexer::uring_dispatch(const uring::completion& cqe) {
+  auto i = uring_ops_.find(cqe.user_data);
+  if (i == uring_ops_.end())
+    return;
+  auto op = std::move(i->second);
+  uring_ops_.erase(i);
+  auto& mgr = op.mgr;
+  auto index = index_of(mgr);
+  // Skip completions for managers that left the pollset and for operations
+  // that we have replaced in the meantime.
+  if (index == -1)
+    return;
+  auto& st = uring_states_[index];
+  switch (op.kind) {
+    case operation::read: {
+      if (st.read_op != cqe.user_data)
+        return;
+      st.read_op = 0;
+      st.read_cancel_pending = false;
+      // We only cancel reads after the manager stopped reading.
+      if (cqe.res == -ECANCELED)
+        break;
+      auto keep_reading = true;
+      if (op.args == nullptr) {
+        keep_reading = mgr->handle_read_completion(from_uring_result(cqe.res));
+      } else if (cqe.res >= 0) {
+        // Unlike streams, datagram sockets may receive empty messages.
+        received_datagram info;
+        auto num_bytes = static_cast<size_t>(cqe.res);
+        if (auto err = uring::datagram_info(*op.args, num_bytes, info)) {
+          CAF_ASSERT(err.category() == type_id_v<sec>);
+          keep_reading = mgr->handle_datagram_completion(
+            static_cast<sec>(err.code()));
+        } else {
+          keep_reading = mgr->handle_datagram_completion(std::move(info));
+        }
+      } else {
+        keep_reading = mgr->handle_datagram_completion(
+          get<sec>(from_uring_result(cqe.res)));
+      }
+      if (!keep_reading)
+        mgr->mask_del(operation::read);
+      break;
+    }
+    case operation::write: {
+      if (st.write_op != cqe.user_data)
+        return;
+      st.write_op = 0;
+      if (!mgr->handle_write_completion(from_uring_result(cqe.res)))
+        mgr->mask_del(operation::write);
+      break;
+    }
+    default: {
+      if (st.poll_op != cqe.user_data)
+        return;
+      st.poll_op = 0;
+      auto revents = cqe.res < 0 ? short{POLLERR} : static_cast<short>(cqe.res);
+      handle(mgr, to_bitmask(mgr->mask()), revents);
+    }
+  }
+  // Event handlers may add or remove managers.
+  index = index_of(mgr);
+  if (index == -1)
+    return;
+  if (mgr->mask() == operation::none)
+    del(index);
+  else
+    uring_mark_dirty(index);
+}
+
+#endif // CAF_LINUX
+
+uint64_t multiplexer::set_timeout(actor_clock::time_point tp,
+                                  socket_manager_ptr mgr, std::string type) {
+  CAF_ASSERT(std::this_thread::get_id() == tid_);
+  return timers_.add(tp, std::move(mgr), std::move(type));
+}
+
+bool multiplexer::cancel_timeout(uint64_t id) {
+  CAF_ASSERT(std::this_thread::get_id() == tid_);
+  return timers_.cancel(id);
+}
+
+int multiplexer::poll_timeout(bool blocking) {
+  if (!blocking)
+    return 0;
+  return timers_.poll_timeout(actor_clock::clock_type::now());
+}
+
+bool multiplexer::handle_timeouts() {
+  if (timers_.empty())
+    return false;
+  CAF_ASSERT(expired_.empty());
+  if (timers_.advance(actor_clock::clock_type::now(), expired_) == 0)
+    return false;
+  for (auto& x : expired_) {
+    // Managers that left the pollset no longer receive any events.
+    if (index_of(x.mgr) != -1)
+      x.mgr->handle_timeout(std::move(x.type), x.id);
+  }
+  expired_.clear();
+  return true;
+}
+
 void multiplexer::set_thread_id() {
   tid_ = std::this_thread::get_id();
 }
 
 void multiplexer::run() {
   CAF_LOG_TRACE("");
-  while (!pollset_.empty())
+  while (!managers_.empty()) {
+    if (busy_poll_budget_.count() > 0 && busy_poll())
+      continue;
     poll_once(true);
+  }
+}
+
+bool multiplexer::busy_poll() {
+  using clock_type = std::chrono::steady_clock;
+  auto deadline = clock_type::now() + busy_poll_budget_;
+  do {
+    if (poll_once(false)) {
+      busy_poll_hits_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  } while (!managers_.empty() && clock_type::now() < deadline);
+  busy_poll_misses_.fetch_add(1, std::memory_order_relaxed);
+  return false;
 }
 
 void multiplexer::shutdown() {
   if (std::this_thread::get_id() == tid_) {
     shutting_down_ = true;
-    // First manager is the pollset_updater. Skip it and delete later.
-    for (size_t i = 1; i < managers_.size();) {
+    // Skip the pollset_updater and delete it later.
+    for (size_t i = 0; i < managers_.size();) {
       auto& mgr = managers_[i];
-      if (mgr->mask_del(operation::read)) {
-        auto& fd = pollset_[index_of(mgr)];
-        fd.events &= ~input_mask;
+      if (mgr.get() == updater_) {
+        ++i;
+        continue;
       }
+      if (mgr->mask_del(operation::read) && mgr->mask() != operation::none)
+        set_events(static_cast<ptrdiff_t>(i), to_bitmask(mgr->mask()));
       if (mgr->mask() == operation::none)
         del(i);
       else
@@ -243,7 +755,7 @@ void multiplexer::shutdown() {
     }
     close_pipe();
   } else {
-    write_to_pipe(4, nullptr);
+    push_command(opcode::shutdown, nullptr);
   }
 }
 
@@ -251,17 +763,22 @@ short multiplexer::handle(const socket_manager_ptr& mgr, short events,
                           short revents) {
   CAF_LOG_TRACE(CAF_ARG2("socket", mgr->handle()));
   CAF_ASSERT(mgr != nullptr);
+  // A POLLERR without hang-up may only signal pending messages in the error
+  // queue of the socket. Give the manager a chance to consume them first.
+  if ((revents & (POLLERR | POLLHUP | POLLNVAL)) == POLLERR
+      && mgr->handle_error_queue_event())
+    revents &= ~POLLERR;
   bool checkerror = true;
   if ((revents & input_mask) != 0) {
     checkerror = false;
-    if (!mgr->handle_read_event()) {
+    if (!call_read_handler(mgr)) {
       mgr->mask_del(operation::read);
       events &= ~input_mask;
     }
   }
   if ((revents & output_mask) != 0) {
     checkerror = false;
-    if (!mgr->handle_write_event()) {
+    if (!call_write_handler(mgr)) {
       mgr->mask_del(operation::write);
       events &= ~output_mask;
     }
@@ -279,39 +796,175 @@ short multiplexer::handle(const socket_manager_ptr& mgr, short events,
   return events;
 }
 
+bool multiplexer::call_read_handler(const socket_manager_ptr& mgr) {
+  if (!metrics_enabled())
+    return mgr->handle_read_event();
+  auto start = std::chrono::steady_clock::now();
+  auto result = mgr->handle_read_event();
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start)
+              .count();
+  metrics_.read_handler.record(static_cast<uint64_t>(ns));
+  auto& stats = mgr->stats();
+  stats.read_events.fetch_add(1, std::memory_order_relaxed);
+  stats.read_time.fetch_add(static_cast<uint64_t>(ns),
+                            std::memory_order_relaxed);
+  return result;
+}
+
+bool multiplexer::call_write_handler(const socket_manager_ptr& mgr) {
+  if (!metrics_enabled())
+    return mgr->handle_write_event();
+  auto start = std::chrono::steady_clock::now();
+  auto result = mgr->handle_write_event();
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start)
+              .count();
+  metrics_.write_handler.record(static_cast<uint64_t>(ns));
+  auto& stats = mgr->stats();
+  stats.write_events.fetch_add(1, std::memory_order_relaxed);
+  stats.write_time.fetch_add(static_cast<uint64_t>(ns),
+                             std::memory_order_relaxed);
+  return result;
+}
+
+void multiplexer::record_poll(std::chrono::steady_clock::time_point start,
+                              int presult) {
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start)
+              .count();
+  metrics_.poll_wait.record(static_cast<uint64_t>(ns));
+  if (presult >= 0)
+    metrics_.ready_events.record(static_cast<uint64_t>(presult));
+}
+
 void multiplexer::add(socket_manager_ptr mgr) {
   CAF_ASSERT(index_of(mgr) == -1);
+#ifdef CAF_LINUX
+  if (backend_ == backend_type::epoll) {
+    epoll_event new_entry;
+    new_entry.events = to_epoll_events(to_bitmask(mgr->mask()));
+    new_entry.data.ptr = mgr.get();
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, mgr->handle().id, &new_entry)
+        != 0) {
+      CAF_LOG_ERROR("epoll_ctl() failed to add socket"
+                    << CAF_ARG2("socket", mgr->handle().id) << ":"
+                    << last_socket_error_as_string());
+      mgr->mask_del(operation::read_write);
+      mgr->handle_error(sec::socket_operation_failed);
+      return;
+    }
+    indexes_.emplace(mgr.get(), managers_.size());
+    managers_.emplace_back(std::move(mgr));
+    return;
+  }
+  if (backend_ == backend_type::io_uring) {
+    auto index = static_cast<ptrdiff_t>(managers_.size());
+    indexes_.emplace(mgr.get(), managers_.size());
+    managers_.emplace_back(std::move(mgr));
+    uring_states_.emplace_back();
+    uring_mark_dirty(index);
+    return;
+  }
+#endif // CAF_LINUX
   pollfd new_entry{socket_cast<socket_id>(mgr->handle()),
                    to_bitmask(mgr->mask()), 0};
   pollset_.emplace_back(new_entry);
+  indexes_.emplace(mgr.get(), managers_.size());
   managers_.emplace_back(std::move(mgr));
 }
 
 void multiplexer::del(ptrdiff_t index) {
   CAF_ASSERT(index != -1);
-  pollset_.erase(pollset_.begin() + index);
-  managers_.erase(managers_.begin() + index);
-}
-
-void multiplexer::write_to_pipe(uint8_t opcode, const socket_manager_ptr& mgr) {
-  CAF_ASSERT(opcode == 0 || opcode == 1 || opcode == 4);
-  CAF_ASSERT(mgr != nullptr || opcode == 4);
-  pollset_updater::msg_buf buf;
-  if (opcode != 4)
-    mgr->ref();
-  buf[0] = static_cast<byte>(opcode);
-  auto value = reinterpret_cast<intptr_t>(mgr.get());
-  memcpy(buf.data() + 1, &value, sizeof(intptr_t));
-  variant<size_t, sec> res;
-  { // Lifetime scope of guard.
-    std::lock_guard<std::mutex> guard{write_lock_};
-    if (write_handle_ != invalid_socket)
-      res = write(write_handle_, buf);
-    else
-      res = sec::socket_invalid;
+#ifdef CAF_LINUX
+  if (backend_ == backend_type::epoll) {
+    // Kernels before 2.6.9 require a non-null event pointer for EPOLL_CTL_DEL.
+    epoll_event dummy;
+    auto fd = managers_[index]->handle().id;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, &dummy) != 0)
+      CAF_LOG_ERROR("epoll_ctl() failed to remove socket"
+                    << CAF_ARG2("socket", fd) << ":"
+                    << last_socket_error_as_string());
+  }
+  if (backend_ == backend_type::io_uring) {
+    // Pending operations keep their manager alive until they complete.
+    auto& st = uring_states_[index];
+    for (auto id : {st.poll_op, st.read_op, st.write_op})
+      if (id != 0)
+        ring_.cancel(uring_cancel_id, id);
+    if (index + 1 != static_cast<ptrdiff_t>(uring_states_.size()))
+      uring_states_[index] = uring_states_.back();
+    uring_states_.pop_back();
+  }
+#endif // CAF_LINUX
+  if (backend_ == backend_type::poll) {
+    if (index + 1 != static_cast<ptrdiff_t>(pollset_.size()))
+      pollset_[index] = pollset_.back();
+    pollset_.pop_back();
+  }
+  // Swap-remove the manager and fix up the index of the moved entry.
+  if (managers_[index].get() == updater_)
+    updater_ = nullptr;
+  indexes_.erase(managers_[index].get());
+  if (index + 1 != static_cast<ptrdiff_t>(managers_.size())) {
+    managers_[index] = std::move(managers_.back());
+    indexes_[managers_[index].get()] = static_cast<size_t>(index);
+  }
+  managers_.pop_back();
+}
+
+void multiplexer::set_events(ptrdiff_t index, short events) {
+  CAF_ASSERT(index != -1);
+#ifdef CAF_LINUX
+  if (backend_ == backend_type::epoll) {
+    auto& mgr = managers_[index];
+    epoll_event entry;
+    entry.events = to_epoll_events(events);
+    entry.data.ptr = mgr.get();
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, mgr->handle().id, &entry) != 0)
+      CAF_LOG_ERROR("epoll_ctl() failed to modify socket"
+                    << CAF_ARG2("socket", mgr->handle().id) << ":"
+                    << last_socket_error_as_string());
+    return;
+  }
+  if (backend_ == backend_type::io_uring) {
+    // Computes the operations from the mask of the manager when arming it.
+    uring_mark_dirty(index);
+    return;
+  }
+#endif // CAF_LINUX
+  pollset_[index].events = events;
+}
+
+void multiplexer::push_command(opcode op, const socket_manager_ptr& mgr) {
+  CAF_ASSERT(mgr != nullptr || op == opcode::close_pipe
+             || op == opcode::shutdown);
+  if (metrics_enabled()
+      && (op == opcode::register_reading || op == opcode::register_writing))
+    metrics_.cross_thread_registrations.fetch_add(1,
+                                                  std::memory_order_relaxed);
+  switch (commands_.emplace_front(op, mgr)) {
+    case intrusive::inbox_result::unblocked_reader:
+      wakeup();
+      break;
+    case intrusive::inbox_result::queue_closed:
+      CAF_LOG_DEBUG("multiplexer already closed its command queue");
+      break;
+    default:
+      // The pollset updater has yet to drain the queue and picks up this
+      // command without additional signaling.
+      break;
+  }
+}
+
+void multiplexer::wakeup() {
+  uint64_t value = 1;
+  std::lock_guard<std::mutex> guard{write_lock_};
+  if (write_handle_ != invalid_socket) {
+    auto res = write(write_handle_, as_bytes(make_span(&value, 1)));
+    if (auto err = get_if<sec>(&res))
+      CAF_LOG_ERROR("failed to wake up the multiplexer:" << *err);
   }
-  if (holds_alternative<sec>(res) && opcode != 4)
-    mgr->deref();
 }
 
 } // namespace caf::net
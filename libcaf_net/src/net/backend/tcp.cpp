@@ -38,7 +38,10 @@
 namespace caf::net::backend {
 
 tcp::tcp(middleman& mm)
-  : middleman_backend("tcp"), mm_(mm), proxies_(mm.system(), *this) {
+  : middleman_backend("tcp"),
+    mm_(mm),
+    proxies_(mm.system(), *this),
+    workers_(mm.system()) {
   // nop
 }
 
@@ -68,9 +71,11 @@ error tcp::init() {
   if (!doorman_uri)
     return doorman_uri.error();
   auto& mpx = mm_.mpx();
+  // Spread accepted connections over the multiplexer pool of the middleman.
   auto mgr = make_endpoint_manager(
     mpx, mm_.system(),
-    doorman{acc_guard.release(), basp::application_factory{proxies_}});
+    doorman{acc_guard.release(), basp::application_factory{proxies_, &workers_},
+            [this] { return mm_.next_mpx(); }});
   if (auto err = mgr->init()) {
     CAF_LOG_ERROR("mgr->init() failed: " << err);
     return err;
@@ -33,7 +33,10 @@
 namespace caf::net::backend {
 
 test::test(middleman& mm)
-  : middleman_backend("test"), mm_(mm), proxies_(mm.system(), *this) {
+  : middleman_backend("test"),
+    mm_(mm),
+    proxies_(mm.system(), *this),
+    workers_(mm.system()) {
   // nop
 }
 
@@ -91,8 +94,8 @@ test::peer_entry& test::emplace(const node_id& peer_id, stream_socket first,
   using transport_type = stream_transport<basp::application>;
   if (auto err = nonblocking(second, true))
     CAF_LOG_ERROR("nonblocking failed: " << err);
-  auto mpx = mm_.mpx();
-  basp::application app{proxies_};
+  auto mpx = mm_.next_mpx();
+  basp::application app{proxies_, &workers_};
   auto mgr = make_endpoint_manager(mpx, mm_.system(),
                                    transport_type{second, std::move(app)});
   if (auto err = mgr->init()) {
@@ -42,11 +42,6 @@ endpoint_manager_queue::event::event(node_id observing_peer,
   // nop
 }
 
-endpoint_manager_queue::event::event(std::string tag, uint64_t id)
-  : element(element_type::event), value(timeout{std::move(tag), id}) {
-  // nop
-}
-
 endpoint_manager_queue::event::~event() {
   // nop
 }
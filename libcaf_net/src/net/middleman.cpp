@@ -18,11 +18,15 @@
 
 #include "caf/net/middleman.hpp"
 
+#include <algorithm>
+
 #include "caf/actor_system_config.hpp"
 #include "caf/detail/set_thread_name.hpp"
 #include "caf/expected.hpp"
 #include "caf/init_global_meta_objects.hpp"
 #include "caf/net/basp/ec.hpp"
+#include "caf/net/buffer_pool.hpp"
+#include "caf/net/defaults.hpp"
 #include "caf/net/endpoint_manager.hpp"
 #include "caf/net/middleman_backend.hpp"
 #include "caf/net/multiplexer.hpp"
@@ -37,8 +41,8 @@ void middleman::init_global_meta_objects() {
   caf::init_global_meta_objects<id_block::net_module>();
 }
 
-middleman::middleman(actor_system& sys) : sys_(sys) {
-  mpx_ = std::make_shared<multiplexer>();
+middleman::middleman(actor_system& sys) : sys_(sys), next_mpx_(0) {
+  mpxs_.emplace_back(std::make_shared<multiplexer>());
 }
 
 middleman::~middleman() {
@@ -47,33 +51,87 @@ middleman::~middleman() {
 
 void middleman::start() {
   if (!get_or(config(), "middleman.manual-multiplexing", false)) {
-    auto mpx = mpx_;
     auto sys_ptr = &system();
-    mpx_thread_ = std::thread{[mpx, sys_ptr] {
-      CAF_SET_LOGGER_SYS(sys_ptr);
-      detail::set_thread_name("caf.multiplexer");
-      sys_ptr->thread_started();
-      mpx->set_thread_id();
-      mpx->run();
-      sys_ptr->thread_terminates();
-    }};
+    for (auto& mpx : mpxs_) {
+      mpx_threads_.emplace_back([mpx, sys_ptr] {
+        CAF_SET_LOGGER_SYS(sys_ptr);
+        detail::set_thread_name("caf.multiplexer");
+        sys_ptr->thread_started();
+        mpx->set_thread_id();
+        mpx->run();
+        sys_ptr->thread_terminates();
+      });
+    }
   }
 }
 
 void middleman::stop() {
   for (const auto& backend : backends_)
     backend->stop();
-  mpx_->shutdown();
-  if (mpx_thread_.joinable())
-    mpx_thread_.join();
-  else
-    mpx_->run();
+  for (auto& mpx : mpxs_)
+    mpx->shutdown();
+  if (!mpx_threads_.empty()) {
+    for (auto& thread : mpx_threads_)
+      thread.join();
+    mpx_threads_.clear();
+  } else {
+    for (auto& mpx : mpxs_)
+      mpx->run();
+  }
 }
 
 void middleman::init(actor_system_config& cfg) {
-  if (auto err = mpx_->init()) {
-    CAF_LOG_ERROR("mgr->init() failed: " << err);
-    CAF_RAISE_ERROR("mpx->init() failed");
+  auto backend_kind = mpx()->backend();
+  if (auto name = get_if<std::string>(&cfg, "middleman.multiplexer-backend")) {
+    if (*name == "poll") {
+      backend_kind = multiplexer::backend_type::poll;
+    } else if (*name == "epoll") {
+      backend_kind = multiplexer::backend_type::epoll;
+    } else if (*name == "io_uring") {
+      backend_kind = multiplexer::backend_type::io_uring;
+    } else {
+      CAF_LOG_ERROR("invalid multiplexer backend:" << *name);
+      CAF_RAISE_ERROR("invalid value for middleman.multiplexer-backend");
+    }
+  }
+  auto policy = overload_policy::notify;
+  if (auto name = get_if<std::string>(&cfg, "middleman.overload-policy")) {
+    if (*name == "none") {
+      policy = overload_policy::none;
+    } else if (*name == "drop") {
+      policy = overload_policy::drop;
+    } else if (*name == "error") {
+      policy = overload_policy::error;
+    } else if (*name == "notify") {
+      policy = overload_policy::notify;
+    } else {
+      CAF_LOG_ERROR("invalid overload policy:" << *name);
+      CAF_RAISE_ERROR("invalid value for middleman.overload-policy");
+    }
+  }
+  // Manual multiplexing only supports a single multiplexer, since the user
+  // drives the event loop via mpx().
+  auto num_mpxs = size_t{1};
+  if (!get_or(cfg, "middleman.manual-multiplexing", false))
+    num_mpxs = std::max(get_or(cfg, "middleman.multiplexer-threads",
+                               defaults::middleman::multiplexer_threads),
+                        size_t{1});
+  if (backend_kind != mpx()->backend())
+    mpxs_.front() = std::make_shared<multiplexer>(backend_kind);
+  while (mpxs_.size() < num_mpxs)
+    mpxs_.emplace_back(std::make_shared<multiplexer>(backend_kind));
+  auto budget = get_or(cfg, "middleman.busy-poll-budget", timespan{0});
+  auto enable_metrics = get_or(cfg, "middleman.enable-metrics", false);
+  buffer_pool::instance().limit(get_or(cfg, "middleman.buffer-pool-limit",
+                                       defaults::middleman::buffer_pool_limit));
+  for (auto& mpx : mpxs_) {
+    mpx->busy_poll_budget(budget);
+    mpx->metrics_enabled(enable_metrics);
+    mpx->default_overload_policy(policy);
+    if (auto err = mpx->init()) {
+      CAF_LOG_ERROR("mpx->init() failed: " << err);
+      CAF_RAISE_ERROR("mpx->init() failed");
+    }
   }
   if (auto node_uri = get_if<uri>(&cfg, "middleman.this-node")) {
     auto this_node = make_node_id(std::move(*node_uri));
@@ -111,6 +169,11 @@ void middleman::resolve(const uri& locator, const actor& listener) {
     anon_send(listener, error{basp::ec::invalid_scheme});
 }
 
+const multiplexer_ptr& middleman::next_mpx() noexcept {
+  auto index = next_mpx_.fetch_add(1, std::memory_order_relaxed);
+  return mpxs_[index % mpxs_.size()];
+}
+
 middleman_backend* middleman::backend(string_view scheme) const noexcept {
   auto predicate = [&](const middleman_backend_ptr& ptr) {
     return ptr->id() == scheme;
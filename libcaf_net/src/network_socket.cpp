@@ -122,6 +122,26 @@ error send_buffer_size(network_socket x, size_t capacity) {
   return none;
 }
 
+#ifdef CAF_LINUX
+
+error busy_poll(network_socket x, size_t usec) {
+  auto new_value = static_cast<int>(usec);
+  CAF_NET_SYSCALL("setsockopt", res, !=, 0,
+                  setsockopt(x.id, SOL_SOCKET, SO_BUSY_POLL,
+                             reinterpret_cast<setsockopt_ptr>(&new_value),
+                             static_cast<socket_size_type>(sizeof(int))));
+  return none;
+}
+
+#else // CAF_LINUX
+
+error busy_poll(network_socket, size_t) {
+  return make_error(sec::network_syscall_failed, "setsockopt",
+                    "SO_BUSY_POLL is only available on Linux");
+}
+
+#endif // CAF_LINUX
+
 expected<std::string> local_addr(network_socket x) {
   sockaddr_storage st;
   socket_size_type st_len = sizeof(st);
@@ -32,6 +32,12 @@
 #include "caf/span.hpp"
 #include "caf/variant.hpp"
 
+#ifdef CAF_LINUX
+#  include <fcntl.h>
+#  include <sys/eventfd.h>
+#  include <unistd.h>
+#endif // CAF_LINUX
+
 namespace caf::net {
 
 #ifdef CAF_WINDOWS
@@ -94,6 +100,33 @@ variant<size_t, sec> read(pipe_socket x, span<byte> buf) {
 
 #endif // CAF_WINDOWS
 
+#ifdef CAF_LINUX
+
+expected<std::pair<pipe_socket, pipe_socket>> make_wakeup_pipe() {
+  auto fd = eventfd(0, EFD_CLOEXEC);
+  if (fd == -1)
+    return make_error(sec::network_syscall_failed, "eventfd",
+                      last_socket_error_as_string());
+  // Give the write handle its own descriptor to allow users to close both
+  // handles independently.
+  auto dup_fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+  if (dup_fd == -1) {
+    auto err = make_error(sec::network_syscall_failed, "fcntl",
+                          last_socket_error_as_string());
+    ::close(fd);
+    return err;
+  }
+  return std::make_pair(pipe_socket{fd}, pipe_socket{dup_fd});
+}
+
+#else // CAF_LINUX
+
+expected<std::pair<pipe_socket, pipe_socket>> make_wakeup_pipe() {
+  return make_pipe();
+}
+
+#endif // CAF_LINUX
+
 variant<size_t, sec>
 check_pipe_socket_io_res(std::make_signed<size_t>::type res) {
   return check_stream_socket_io_res(res);
@@ -18,8 +18,6 @@
 
 #include "caf/net/pollset_updater.hpp"
 
-#include <cstring>
-
 #include "caf/logger.hpp"
 #include "caf/net/multiplexer.hpp"
 #include "caf/sec.hpp"
@@ -30,7 +28,7 @@ namespace caf::net {
 
 pollset_updater::pollset_updater(pipe_socket read_handle,
                                  const multiplexer_ptr& parent)
-  : super(read_handle, parent), buf_size_(0) {
+  : super(read_handle, parent) {
   mask_ = operation::read;
   if (auto err = nonblocking(read_handle, true))
     CAF_LOG_ERROR("nonblocking failed: " << err);
@@ -41,38 +39,19 @@ pollset_updater::~pollset_updater() {
 }
 
 bool pollset_updater::handle_read_event() {
+  // Reset the wakeup signal first. Any command that arrives after this point
+  // either ends up in the current batch or triggers a new signal.
   for (;;) {
-    auto res = read(handle(), make_span(buf_.data() + buf_size_,
-                                        buf_.size() - buf_size_));
-    if (auto num_bytes = get_if<size_t>(&res)) {
-      buf_size_ += *num_bytes;
-      if (buf_.size() == buf_size_) {
-        buf_size_ = 0;
-        auto opcode = static_cast<uint8_t>(buf_[0]);
-        intptr_t value;
-        memcpy(&value, buf_.data() + 1, sizeof(intptr_t));
-        socket_manager_ptr mgr{reinterpret_cast<socket_manager*>(value), false};
-        if (auto ptr = parent_.lock()) {
-          switch (opcode) {
-            case 0:
-              ptr->register_reading(mgr);
-              break;
-            case 1:
-              ptr->register_writing(mgr);
-              break;
-            case 4:
-              ptr->shutdown();
-              break;
-            default:
-              CAF_LOG_DEBUG("opcode not recognized: " << CAF_ARG(opcode));
-              break;
-          }
-        }
-      }
-    } else {
-      return get<sec>(res) == sec::unavailable_or_would_block;
+    auto res = read(handle(), make_span(buf_));
+    if (auto err = get_if<sec>(&res)) {
+      if (*err != sec::unavailable_or_would_block)
+        return false;
+      break;
     }
   }
+  if (auto ptr = parent_.lock())
+    return ptr->handle_commands();
+  return false;
 }
 
 bool pollset_updater::handle_write_event() {
@@ -67,4 +67,45 @@ void socket_manager::register_writing() {
     ptr->register_writing(this);
 }
 
+void socket_manager::handle_timeout(std::string, uint64_t) {
+  // nop
+}
+
+bool socket_manager::handle_error_queue_event() {
+  return false;
+}
+
+bool socket_manager::supports_completions() const noexcept {
+  return false;
+}
+
+span<byte> socket_manager::read_buffer() {
+  return {};
+}
+
+bool socket_manager::handle_read_completion(variant<size_t, sec>) {
+  return false;
+}
+
+span<const span<const byte>> socket_manager::write_buffers() {
+  return {};
+}
+
+bool socket_manager::handle_write_completion(variant<size_t, sec>) {
+  return false;
+}
+
+bool socket_manager::uses_datagrams() const noexcept {
+  return false;
+}
+
+bool socket_manager::handle_datagram_completion(
+  variant<received_datagram, sec>) {
+  return false;
+}
+
+ip_endpoint socket_manager::write_destination() {
+  return {};
+}
+
 } // namespace caf::net
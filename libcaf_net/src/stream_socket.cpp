@@ -30,9 +30,25 @@
 #include "caf/variant.hpp"
 
 #ifdef CAF_POSIX
+#  include <climits>
 #  include <sys/uio.h>
 #endif
 
+#ifndef IOV_MAX
+#  define IOV_MAX 1024
+#endif
+
+#ifdef CAF_LINUX
+#  include <cerrno>
+#  include <linux/errqueue.h>
+#  ifndef SO_ZEROCOPY
+#    define SO_ZEROCOPY 60
+#  endif
+#  ifndef MSG_ZEROCOPY
+#    define MSG_ZEROCOPY 0x4000000
+#  endif
+#endif
+
 namespace caf::net {
 
 #ifdef CAF_WINDOWS
@@ -205,6 +221,30 @@ variant<size_t, sec> write(stream_socket x,
   return static_cast<size_t>(bytes_sent);
 }
 
+const size_t max_write_buffers = IOV_MAX;
+
+variant<size_t, sec> write(stream_socket x,
+                           span<const span<const byte>> bufs) {
+  WSABUF buf_array[IOV_MAX];
+  auto n = std::min(bufs.size(), max_write_buffers);
+  for (size_t i = 0; i < n; ++i) {
+    auto data = const_cast<byte*>(bufs[i].data());
+    buf_array[i] = WSABUF{static_cast<ULONG>(bufs[i].size()),
+                          reinterpret_cast<CHAR*>(data)};
+  }
+  DWORD bytes_sent = 0;
+  auto res = WSASend(x.id, buf_array, static_cast<DWORD>(n), &bytes_sent, 0,
+                     nullptr, nullptr);
+  if (res != 0) {
+    auto code = last_socket_error();
+    if (code == std::errc::operation_would_block
+        || code == std::errc::resource_unavailable_try_again)
+      return sec::unavailable_or_would_block;
+    return sec::socket_operation_failed;
+  }
+  return static_cast<size_t>(bytes_sent);
+}
+
 #else // CAF_WINDOWS
 
 variant<size_t, sec> write(stream_socket x,
@@ -219,8 +259,104 @@ variant<size_t, sec> write(stream_socket x,
   return check_stream_socket_io_res(res);
 }
 
+const size_t max_write_buffers = IOV_MAX;
+
+variant<size_t, sec> write(stream_socket x,
+                           span<const span<const byte>> bufs) {
+  iovec buf_array[IOV_MAX];
+  auto n = std::min(bufs.size(), max_write_buffers);
+  for (size_t i = 0; i < n; ++i)
+    buf_array[i] = iovec{const_cast<byte*>(bufs[i].data()), bufs[i].size()};
+  // Use sendmsg instead of writev to pass no_sigpipe_io_flag.
+  msghdr msg;
+  memset(&msg, 0, sizeof(msghdr));
+  msg.msg_iov = buf_array;
+  msg.msg_iovlen = n;
+  auto res = ::sendmsg(x.id, &msg, no_sigpipe_io_flag);
+  return check_stream_socket_io_res(res);
+}
+
 #endif // CAF_WINDOWS
 
+#ifdef CAF_LINUX
+
+error zerocopy(stream_socket x, bool new_value) {
+  CAF_LOG_TRACE(CAF_ARG(x) << CAF_ARG(new_value));
+  int value = new_value ? 1 : 0;
+  CAF_NET_SYSCALL("setsockopt", res, !=, 0,
+                  setsockopt(x.id, SOL_SOCKET, SO_ZEROCOPY,
+                             reinterpret_cast<setsockopt_ptr>(&value),
+                             static_cast<socket_size_type>(sizeof(value))));
+  return none;
+}
+
+variant<size_t, sec> write_zerocopy(stream_socket x, span<const byte> buf) {
+  auto res = ::send(x.id, reinterpret_cast<socket_send_ptr>(buf.data()),
+                    buf.size(), MSG_ZEROCOPY | no_sigpipe_io_flag);
+  // The kernel refuses to pin more pages than the locked memory limit allows
+  // and reports ENOBUFS until enough writes have completed.
+  if (res < 0 && errno == ENOBUFS)
+    return sec::feature_disabled;
+  return check_stream_socket_io_res(res);
+}
+
+variant<size_t, sec> read_zerocopy_completions(stream_socket x,
+                                               uint32_t& last_completed,
+                                               bool& copied) {
+  size_t result = 0;
+  for (;;) {
+    char control[128];
+    msghdr msg;
+    memset(&msg, 0, sizeof(msghdr));
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    auto res = recvmsg(x.id, &msg, MSG_ERRQUEUE);
+    if (res < 0) {
+      auto code = last_socket_error();
+      if (code == std::errc::operation_would_block
+          || code == std::errc::resource_unavailable_try_again)
+        return result;
+      return sec::socket_operation_failed;
+    }
+    for (auto cm = CMSG_FIRSTHDR(&msg); cm != nullptr;
+         cm = CMSG_NXTHDR(&msg, cm)) {
+      if (!(cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR)
+          && !(cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR))
+        continue;
+      auto err = reinterpret_cast<sock_extended_err*>(CMSG_DATA(cm));
+      if (err->ee_errno != 0 || err->ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+        return sec::socket_operation_failed;
+      // Each notification covers the range [ee_info, ee_data].
+      last_completed = err->ee_data;
+      if ((err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0) {
+        CAF_LOG_DEBUG("kernel fell back to copying for zero-copy writes"
+                      << CAF_ARG2("first", err->ee_info)
+                      << CAF_ARG2("last", err->ee_data));
+        copied = true;
+      }
+      ++result;
+    }
+  }
+}
+
+#else // CAF_LINUX
+
+error zerocopy(stream_socket, bool) {
+  return make_error(sec::network_syscall_failed, "setsockopt",
+                    "SO_ZEROCOPY is only available on Linux");
+}
+
+variant<size_t, sec> write_zerocopy(stream_socket, span<const byte>) {
+  return sec::feature_disabled;
+}
+
+variant<size_t, sec> read_zerocopy_completions(stream_socket, uint32_t&,
+                                               bool&) {
+  return size_t{0};
+}
+
+#endif // CAF_LINUX
+
 variant<size_t, sec>
 check_stream_socket_io_res(std::make_signed<size_t>::type res) {
   if (res == 0)
@@ -0,0 +1,268 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/net/timer_wheel.hpp"
+
+#include <limits>
+
+#include "caf/config.hpp"
+#include "caf/net/socket_manager.hpp"
+
+namespace caf::net {
+
+namespace {
+
+constexpr uint64_t npos_tick = std::numeric_limits<uint64_t>::max();
+
+/// Number of ticks covered by the entire wheel.
+constexpr uint64_t max_delta = uint64_t{1}
+                               << (timer_wheel::slot_bits
+                                   * timer_wheel::num_levels);
+
+constexpr uint64_t slot_mask = timer_wheel::num_slots - 1;
+
+size_t count_trailing_zeros(uint64_t x) noexcept {
+  CAF_ASSERT(x != 0);
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<size_t>(__builtin_ctzll(x));
+#else
+  size_t result = 0;
+  while ((x & 1) == 0) {
+    x >>= 1;
+    ++result;
+  }
+  return result;
+#endif
+}
+
+/// Rotates `x` to the right by `n` bits.
+uint64_t rotate_right(uint64_t x, size_t n) noexcept {
+  n &= 63;
+  return n == 0 ? x : (x >> n) | (x << (64 - n));
+}
+
+} // namespace
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+timer_wheel::timer_wheel() : timer_wheel(clock_type::now()) {
+  // nop
+}
+
+timer_wheel::timer_wheel(time_point start)
+  : start_(start), now_(0), size_(0), free_list_(npos) {
+  for (auto& level : slots_)
+    level.fill(npos);
+  occupied_.fill(0);
+}
+
+timer_wheel::~timer_wheel() {
+  // nop
+}
+
+// -- properties ---------------------------------------------------------------
+
+int timer_wheel::poll_timeout(time_point now) const noexcept {
+  auto next = next_event_tick();
+  if (next == npos_tick)
+    return -1;
+  auto deadline = start_ + duration_type{next};
+  if (deadline <= now)
+    return 0;
+  // Round up to make sure the wheel has something to do after waking up.
+  auto diff = std::chrono::ceil<duration_type>(deadline - now).count();
+  if (diff > std::numeric_limits<int>::max())
+    return std::numeric_limits<int>::max();
+  return static_cast<int>(diff);
+}
+
+// -- modifiers ----------------------------------------------------------------
+
+uint64_t timer_wheel::add(time_point tp, socket_manager_ptr mgr,
+                          std::string type) {
+  uint32_t index;
+  if (free_list_ != npos) {
+    index = free_list_;
+    free_list_ = entries_[index].next;
+  } else {
+    index = static_cast<uint32_t>(entries_.size());
+    entries_.emplace_back();
+  }
+  auto& x = entries_[index];
+  // Timers in the past fire on the next tick.
+  x.deadline = std::max(to_tick(tp), now_ + 1);
+  x.mgr = std::move(mgr);
+  x.type = std::move(type);
+  place(index);
+  ++size_;
+  return make_id(x.generation, index);
+}
+
+bool timer_wheel::cancel(uint64_t id) noexcept {
+  auto index = static_cast<uint32_t>(id & 0xFFFFFFFF);
+  auto generation = static_cast<uint32_t>(id >> 32);
+  if (index >= entries_.size())
+    return false;
+  auto& x = entries_[index];
+  if (x.generation != generation || x.slot == npos)
+    return false;
+  unlink(index);
+  release(index);
+  --size_;
+  return true;
+}
+
+size_t timer_wheel::advance(time_point now, expired_list& out) {
+  // Round down, since we must not fire timers early.
+  uint64_t target = 0;
+  if (now > start_)
+    target = static_cast<uint64_t>(
+      std::chrono::duration_cast<duration_type>(now - start_).count());
+  size_t result = 0;
+  while (now_ < target) {
+    // Skip all ticks that neither fire nor cascade any timer.
+    auto next = next_event_tick();
+    if (next > target) {
+      now_ = target;
+      break;
+    }
+    now_ = next - 1;
+    result += tick(out);
+  }
+  return result;
+}
+
+// -- utility functions --------------------------------------------------------
+
+uint64_t timer_wheel::to_tick(time_point tp) const noexcept {
+  if (tp <= start_)
+    return 0;
+  return static_cast<uint64_t>(
+    std::chrono::ceil<duration_type>(tp - start_).count());
+}
+
+uint64_t timer_wheel::next_event_tick() const noexcept {
+  auto result = npos_tick;
+  for (size_t level = 0; level < num_levels; ++level) {
+    auto mask = occupied_[level];
+    if (mask == 0)
+      continue;
+    // Find the first occupied slot after the current one. For higher levels,
+    // the wheel visits a slot at the first tick of its range.
+    auto shift = level * slot_bits;
+    auto current = now_ >> shift;
+    auto offset = count_trailing_zeros(rotate_right(mask, current + 1)) + 1;
+    auto tick = (current + offset) << shift;
+    result = std::min(result, tick);
+  }
+  return result;
+}
+
+void timer_wheel::place(uint32_t index) noexcept {
+  auto& x = entries_[index];
+  CAF_ASSERT(x.deadline >= now_);
+  // Timers beyond the range of the wheel wait in the last slot of the top
+  // level and get re-distributed when the wheel reaches that slot.
+  auto deadline = std::min(x.deadline, now_ + max_delta - 1);
+  auto delta = deadline - now_;
+  size_t level = 0;
+  while (level + 1 < num_levels
+         && delta >= (uint64_t{1} << ((level + 1) * slot_bits)))
+    ++level;
+  auto slot = static_cast<uint32_t>((deadline >> (level * slot_bits))
+                                    & slot_mask);
+  auto& head = slots_[level][slot];
+  x.slot = static_cast<uint32_t>(level * num_slots + slot);
+  x.prev = npos;
+  x.next = head;
+  if (head != npos)
+    entries_[head].prev = index;
+  head = index;
+  occupied_[level] |= uint64_t{1} << slot;
+}
+
+void timer_wheel::unlink(uint32_t index) noexcept {
+  auto& x = entries_[index];
+  CAF_ASSERT(x.slot != npos);
+  auto level = x.slot / num_slots;
+  auto slot = x.slot % num_slots;
+  if (x.prev != npos)
+    entries_[x.prev].next = x.next;
+  else
+    slots_[level][slot] = x.next;
+  if (x.next != npos)
+    entries_[x.next].prev = x.prev;
+  if (slots_[level][slot] == npos)
+    occupied_[level] &= ~(uint64_t{1} << slot);
+  x.slot = npos;
+  x.prev = npos;
+  x.next = npos;
+}
+
+void timer_wheel::release(uint32_t index) noexcept {
+  auto& x = entries_[index];
+  x.mgr.reset();
+  x.type.clear();
+  // Invalidates all IDs that still refer to this entry.
+  ++x.generation;
+  x.next = free_list_;
+  free_list_ = index;
+}
+
+void timer_wheel::cascade(size_t level, size_t slot) noexcept {
+  auto index = slots_[level][slot];
+  slots_[level][slot] = npos;
+  occupied_[level] &= ~(uint64_t{1} << slot);
+  while (index != npos) {
+    auto next = entries_[index].next;
+    place(index);
+    index = next;
+  }
+}
+
+size_t timer_wheel::tick(expired_list& out) {
+  ++now_;
+  // Re-distribute higher levels first, since their timers may end up in the
+  // slots of lower levels that we cascade next.
+  for (auto level = num_levels - 1; level > 0; --level) {
+    auto shift = level * slot_bits;
+    if ((now_ & ((uint64_t{1} << shift) - 1)) == 0)
+      cascade(level, (now_ >> shift) & slot_mask);
+  }
+  auto slot = now_ & slot_mask;
+  auto index = slots_[0][slot];
+  slots_[0][slot] = npos;
+  occupied_[0] &= ~(uint64_t{1} << slot);
+  size_t result = 0;
+  while (index != npos) {
+    auto& x = entries_[index];
+    auto next = x.next;
+    CAF_ASSERT(x.deadline == now_);
+    x.slot = npos;
+    out.emplace_back(
+      expired_timeout{std::move(x.mgr), std::move(x.type),
+                      make_id(x.generation, index)});
+    release(index);
+    --size_;
+    ++result;
+    index = next;
+  }
+  return result;
+}
+
+} // namespace caf::net
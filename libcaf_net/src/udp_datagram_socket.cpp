@@ -18,6 +18,8 @@
 
 #include "caf/net/udp_datagram_socket.hpp"
 
+#include <algorithm>
+
 #include "caf/byte.hpp"
 #include "caf/byte_buffer.hpp"
 #include "caf/detail/convert_ip_endpoint.hpp"
@@ -30,6 +32,18 @@
 #include "caf/net/socket_guard.hpp"
 #include "caf/span.hpp"
 
+#ifdef CAF_LINUX
+#  include <cstring>
+#  include <limits>
+#  include <netinet/udp.h>
+#  ifndef UDP_SEGMENT
+#    define UDP_SEGMENT 103
+#  endif
+#  ifndef UDP_GRO
+#    define UDP_GRO 104
+#  endif
+#endif
+
 namespace caf::net {
 
 #ifdef CAF_WINDOWS
@@ -125,12 +139,18 @@ variant<size_t, sec> write(udp_datagram_socket x, span<const byte> buf,
     return get<sec>(ret);
 }
 
+const size_t max_datagram_buffers = 10;
+
 #ifdef CAF_WINDOWS
 
 variant<size_t, sec> write(udp_datagram_socket x, span<byte_buffer*> bufs,
                            ip_endpoint ep) {
-  CAF_ASSERT(bufs.size() < 10);
-  WSABUF buf_array[10];
+  if (bufs.size() > max_datagram_buffers) {
+    CAF_LOG_ERROR("too many buffers for a single datagram"
+                  << CAF_ARG2("buffers", bufs.size()));
+    return sec::invalid_argument;
+  }
+  WSABUF buf_array[max_datagram_buffers];
   auto convert = [](byte_buffer* buf) {
     return WSABUF{static_cast<ULONG>(buf->size()),
                   reinterpret_cast<CHAR*>(buf->data())};
@@ -158,13 +178,17 @@ variant<size_t, sec> write(udp_datagram_socket x, span<byte_buffer*> bufs,
 
 variant<size_t, sec> write(udp_datagram_socket x, span<byte_buffer*> bufs,
                            ip_endpoint ep) {
-  CAF_ASSERT(bufs.size() < 10);
+  if (bufs.size() > max_datagram_buffers) {
+    CAF_LOG_ERROR("too many buffers for a single datagram"
+                  << CAF_ARG2("buffers", bufs.size()));
+    return sec::invalid_argument;
+  }
   auto convert = [](byte_buffer* buf) {
     return iovec{buf->data(), buf->size()};
   };
   sockaddr_storage addr = {};
   detail::convert(ep, addr);
-  iovec buf_array[10];
+  iovec buf_array[max_datagram_buffers];
   std::transform(bufs.begin(), bufs.end(), std::begin(buf_array), convert);
   msghdr message = {};
   memset(&message, 0, sizeof(msghdr));
@@ -179,6 +203,200 @@ variant<size_t, sec> write(udp_datagram_socket x, span<byte_buffer*> bufs,
 
 #endif // CAF_WINDOWS
 
+const size_t max_datagram_batch_size = 64;
+
+const size_t max_datagram_segments = 64;
+
+const size_t max_segmented_write_size = 65507;
+
+#ifdef CAF_LINUX
+
+namespace {
+
+// Maximum number of buffers per segmented write.
+constexpr size_t max_segmented_write_buffers = 64 * max_datagram_buffers;
+
+// Size of the ancillary data for receiving the segment size with UDP_GRO.
+constexpr size_t gro_control_size = CMSG_SPACE(sizeof(int));
+
+} // namespace
+
+error gro(udp_datagram_socket x, bool new_value) {
+  CAF_LOG_TRACE(CAF_ARG(x) << CAF_ARG(new_value));
+  int value = new_value ? 1 : 0;
+  CAF_NET_SYSCALL("setsockopt", res, !=, 0,
+                  setsockopt(x.id, IPPROTO_UDP, UDP_GRO,
+                             reinterpret_cast<setsockopt_ptr>(&value),
+                             static_cast<socket_size_type>(sizeof(value))));
+  return none;
+}
+
+variant<size_t, sec> read(udp_datagram_socket x, span<span<byte>> bufs,
+                          span<received_datagram> infos) {
+  CAF_ASSERT(infos.size() >= bufs.size());
+  mmsghdr msgs[max_datagram_batch_size];
+  iovec iovs[max_datagram_batch_size];
+  sockaddr_storage addrs[max_datagram_batch_size];
+  alignas(cmsghdr) char controls[max_datagram_batch_size][gro_control_size];
+  auto n = std::min(bufs.size(), max_datagram_batch_size);
+  memset(msgs, 0, sizeof(mmsghdr) * n);
+  for (size_t i = 0; i < n; ++i) {
+    iovs[i] = iovec{bufs[i].data(), bufs[i].size()};
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_hdr.msg_control = controls[i];
+    msgs[i].msg_hdr.msg_controllen = gro_control_size;
+  }
+  // MSG_WAITFORONE prevents blocking sockets from waiting for a full batch.
+  auto res = recvmmsg(x.id, msgs, static_cast<unsigned>(n), MSG_WAITFORONE,
+                      nullptr);
+  auto ret = check_udp_datagram_socket_io_res(res);
+  auto num_msgs = get_if<size_t>(&ret);
+  if (num_msgs == nullptr)
+    return get<sec>(ret);
+  for (size_t i = 0; i < *num_msgs; ++i) {
+    auto& hdr = msgs[i].msg_hdr;
+    CAF_LOG_WARNING_IF((hdr.msg_flags & MSG_TRUNC) != 0,
+                       "recvmmsg cut off a message, only received "
+                         << CAF_ARG2("size", bufs[i].size()) << " bytes");
+    infos[i].size = std::min(static_cast<size_t>(msgs[i].msg_len),
+                             bufs[i].size());
+    infos[i].segment_size = 0;
+    for (auto cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+      if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO) {
+        int segment_size = 0;
+        memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(int));
+        infos[i].segment_size = static_cast<size_t>(segment_size);
+      }
+    }
+    if (auto err = detail::convert(addrs[i], infos[i].ep)) {
+      CAF_ASSERT(err.category() == type_id_v<sec>);
+      return static_cast<sec>(err.code());
+    }
+  }
+  return *num_msgs;
+}
+
+variant<size_t, sec> write(udp_datagram_socket x,
+                           span<const outgoing_datagram> datagrams) {
+  mmsghdr msgs[max_datagram_batch_size];
+  iovec iovs[max_datagram_batch_size][max_datagram_buffers];
+  sockaddr_storage addrs[max_datagram_batch_size];
+  auto n = std::min(datagrams.size(), max_datagram_batch_size);
+  memset(msgs, 0, sizeof(mmsghdr) * n);
+  for (size_t i = 0; i < n; ++i) {
+    auto& dg = datagrams[i];
+    if (dg.bufs.size() > max_datagram_buffers) {
+      CAF_LOG_ERROR("too many buffers for a single datagram"
+                    << CAF_ARG2("buffers", dg.bufs.size()));
+      return sec::invalid_argument;
+    }
+    for (size_t j = 0; j < dg.bufs.size(); ++j)
+      iovs[i][j] = iovec{dg.bufs[j]->data(), dg.bufs[j]->size()};
+    addrs[i] = sockaddr_storage{};
+    detail::convert(dg.ep, addrs[i]);
+    auto& hdr = msgs[i].msg_hdr;
+    hdr.msg_name = &addrs[i];
+    hdr.msg_namelen = dg.ep.address().embeds_v4() ? sizeof(sockaddr_in)
+                                                  : sizeof(sockaddr_in6);
+    hdr.msg_iov = iovs[i];
+    hdr.msg_iovlen = dg.bufs.size();
+  }
+  auto res = sendmmsg(x.id, msgs, static_cast<unsigned>(n), 0);
+  return check_udp_datagram_socket_io_res(res);
+}
+
+variant<size_t, sec> write_segmented(udp_datagram_socket x,
+                                     span<byte_buffer*> bufs,
+                                     size_t segment_size, ip_endpoint ep) {
+  if (bufs.size() > max_segmented_write_buffers) {
+    CAF_LOG_ERROR("too many buffers for a segmented write"
+                  << CAF_ARG2("buffers", bufs.size()));
+    return sec::invalid_argument;
+  }
+  CAF_ASSERT(segment_size > 0);
+  CAF_ASSERT(segment_size <= std::numeric_limits<uint16_t>::max());
+  iovec iovs[max_segmented_write_buffers];
+  auto convert = [](byte_buffer* buf) {
+    return iovec{buf->data(), buf->size()};
+  };
+  std::transform(bufs.begin(), bufs.end(), std::begin(iovs), convert);
+  sockaddr_storage addr = {};
+  detail::convert(ep, addr);
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint16_t))];
+  memset(control, 0, sizeof(control));
+  msghdr message;
+  memset(&message, 0, sizeof(msghdr));
+  message.msg_name = &addr;
+  message.msg_namelen = ep.address().embeds_v4() ? sizeof(sockaddr_in)
+                                                 : sizeof(sockaddr_in6);
+  message.msg_iov = iovs;
+  message.msg_iovlen = bufs.size();
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  auto cmsg = CMSG_FIRSTHDR(&message);
+  cmsg->cmsg_level = IPPROTO_UDP;
+  cmsg->cmsg_type = UDP_SEGMENT;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+  auto size = static_cast<uint16_t>(segment_size);
+  memcpy(CMSG_DATA(cmsg), &size, sizeof(uint16_t));
+  auto res = sendmsg(x.id, &message, 0);
+  return check_udp_datagram_socket_io_res(res);
+}
+
+#else // CAF_LINUX
+
+error gro(udp_datagram_socket, bool) {
+  return make_error(sec::network_syscall_failed, "setsockopt",
+                    "UDP_GRO is only available on Linux");
+}
+
+variant<size_t, sec> read(udp_datagram_socket x, span<span<byte>> bufs,
+                          span<received_datagram> infos) {
+  CAF_ASSERT(infos.size() >= bufs.size());
+  auto n = std::min(bufs.size(), max_datagram_batch_size);
+  size_t result = 0;
+  for (; result < n; ++result) {
+    auto ret = read(x, bufs[result]);
+    if (auto res = get_if<std::pair<size_t, ip_endpoint>>(&ret)) {
+      infos[result].size = std::min(res->first, bufs[result].size());
+      infos[result].ep = res->second;
+      infos[result].segment_size = 0;
+    } else if (result == 0) {
+      return get<sec>(ret);
+    } else {
+      break;
+    }
+  }
+  return result;
+}
+
+variant<size_t, sec> write(udp_datagram_socket x,
+                           span<const outgoing_datagram> datagrams) {
+  auto n = std::min(datagrams.size(), max_datagram_batch_size);
+  size_t result = 0;
+  for (; result < n; ++result) {
+    auto& dg = datagrams[result];
+    auto ret = write(x, dg.bufs, dg.ep);
+    if (holds_alternative<sec>(ret)) {
+      if (result == 0)
+        return get<sec>(ret);
+      break;
+    }
+  }
+  return result;
+}
+
+variant<size_t, sec> write_segmented(udp_datagram_socket, span<byte_buffer*>,
+                                     size_t, ip_endpoint) {
+  return sec::socket_operation_failed;
+}
+
+#endif // CAF_LINUX
+
 variant<size_t, sec>
 check_udp_datagram_socket_io_res(std::make_signed<size_t>::type res) {
   if (res < 0) {
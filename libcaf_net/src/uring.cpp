@@ -0,0 +1,436 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#include "caf/net/uring.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "caf/config.hpp"
+#include "caf/detail/convert_ip_endpoint.hpp"
+#include "caf/logger.hpp"
+#include "caf/net/socket.hpp"
+#include "caf/sec.hpp"
+
+#if defined(CAF_LINUX) && __has_include(<linux/io_uring.h>)
+#  define CAF_NET_HAS_URING
+#  include <linux/io_uring.h>
+#  include <netinet/in.h>
+#  include <netinet/udp.h>
+#  include <poll.h>
+#  include <sys/mman.h>
+#  include <sys/socket.h>
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#  include <unistd.h>
+#  ifndef UDP_GRO
+#    define UDP_GRO 104
+#  endif
+#endif
+
+namespace caf::net {
+
+#ifdef CAF_NET_HAS_URING
+
+struct uring::msg_args {
+  msghdr msg;
+  std::vector<iovec> iov;
+  sockaddr_storage addr;
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+};
+
+void uring::msg_args_deleter::operator()(msg_args* ptr) const noexcept {
+  delete ptr;
+}
+
+namespace {
+
+int sys_io_uring_setup(unsigned entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                       unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit,
+                                  min_complete, flags, nullptr, 0));
+}
+
+template <class T>
+T* offset_ptr(void* base, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+} // namespace
+
+uring::uring() noexcept {
+  reset();
+}
+
+uring::~uring() {
+  release();
+}
+
+error uring::init(unsigned entries) {
+  CAF_ASSERT(!valid());
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  auto fd = sys_io_uring_setup(entries, &params);
+  if (fd < 0)
+    return make_error(sec::network_syscall_failed, "io_uring_setup",
+                      last_socket_error_as_string());
+  fd_ = fd;
+  // Without internal polling, operations on non-blocking sockets would fail
+  // with EAGAIN instead of waiting for the socket to become ready.
+  if ((params.features & IORING_FEAT_FAST_POLL) == 0) {
+    release();
+    return make_error(sec::runtime_error,
+                      "io_uring lacks IORING_FEAT_FAST_POLL");
+  }
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes
+                  + params.cq_entries * sizeof(io_uring_cqe);
+  auto single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap)
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  auto map = [this](size_t size, off_t offset) -> void* {
+    auto ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd_, offset);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+  };
+  auto fail = [this](const char* what) {
+    auto err = make_error(sec::network_syscall_failed, what,
+                          last_socket_error_as_string());
+    release();
+    return err;
+  };
+  if (sq_ring_ = map(sq_ring_size_, IORING_OFF_SQ_RING); sq_ring_ == nullptr)
+    return fail("mmap");
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else if (cq_ring_ = map(cq_ring_size_, IORING_OFF_CQ_RING);
+             cq_ring_ == nullptr) {
+    return fail("mmap");
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  if (sqes_ = map(sqes_size_, IORING_OFF_SQES); sqes_ == nullptr)
+    return fail("mmap");
+  sq_khead_ = offset_ptr<unsigned>(sq_ring_, params.sq_off.head);
+  sq_ktail_ = offset_ptr<unsigned>(sq_ring_, params.sq_off.tail);
+  sq_array_ = offset_ptr<unsigned>(sq_ring_, params.sq_off.array);
+  sq_mask_ = *offset_ptr<unsigned>(sq_ring_, params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+  cq_khead_ = offset_ptr<unsigned>(cq_ring_, params.cq_off.head);
+  cq_ktail_ = offset_ptr<unsigned>(cq_ring_, params.cq_off.tail);
+  cq_mask_ = *offset_ptr<unsigned>(cq_ring_, params.cq_off.ring_mask);
+  cqes_ = offset_ptr<void>(cq_ring_, params.cq_off.cqes);
+  sqe_head_ = sqe_tail_ = *sq_ktail_;
+  return none;
+}
+
+bool uring::poll(uint64_t user_data, int fd, short events) {
+  auto sqe = static_cast<io_uring_sqe*>(next_sqe());
+  if (sqe == nullptr)
+    return false;
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+  sqe->poll_events = static_cast<uint16_t>(events);
+  sqe->user_data = user_data;
+  return true;
+}
+
+bool uring::recv(uint64_t user_data, int fd, span<byte> buf) {
+  auto sqe = static_cast<io_uring_sqe*>(next_sqe());
+  if (sqe == nullptr)
+    return false;
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(buf.data());
+  sqe->len = static_cast<uint32_t>(buf.size());
+  sqe->user_data = user_data;
+  return true;
+}
+
+uring::msg_args_ptr uring::sendmsg(uint64_t user_data, int fd,
+                                   span<const span<const byte>> bufs) {
+  auto sqe = static_cast<io_uring_sqe*>(next_sqe());
+  if (sqe == nullptr)
+    return nullptr;
+  msg_args_ptr args{new msg_args};
+  args->iov.reserve(bufs.size());
+  for (auto& buf : bufs)
+    args->iov.emplace_back(iovec{const_cast<byte*>(buf.data()), buf.size()});
+  memset(&args->msg, 0, sizeof(msghdr));
+  args->msg.msg_iov = args->iov.data();
+  args->msg.msg_iovlen = args->iov.size();
+  sqe->opcode = IORING_OP_SENDMSG;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(&args->msg);
+  sqe->len = 1;
+  sqe->msg_flags = MSG_NOSIGNAL;
+  sqe->user_data = user_data;
+  return args;
+}
+
+uring::msg_args_ptr uring::sendmsg(uint64_t user_data, int fd,
+                                   span<const span<const byte>> bufs,
+                                   const ip_endpoint& dest) {
+  auto args = sendmsg(user_data, fd, bufs);
+  if (args == nullptr)
+    return nullptr;
+  // The kernel reads the message header only when running the operation.
+  args->addr = sockaddr_storage{};
+  detail::convert(dest, args->addr);
+  args->msg.msg_name = &args->addr;
+  args->msg.msg_namelen = dest.address().embeds_v4() ? sizeof(sockaddr_in)
+                                                     : sizeof(sockaddr_in6);
+  return args;
+}
+
+uring::msg_args_ptr uring::recvmsg(uint64_t user_data, int fd,
+                                   span<byte> buf) {
+  auto sqe = static_cast<io_uring_sqe*>(next_sqe());
+  if (sqe == nullptr)
+    return nullptr;
+  msg_args_ptr args{new msg_args};
+  args->iov.emplace_back(iovec{buf.data(), buf.size()});
+  memset(&args->msg, 0, sizeof(msghdr));
+  args->msg.msg_name = &args->addr;
+  args->msg.msg_namelen = sizeof(sockaddr_storage);
+  args->msg.msg_iov = args->iov.data();
+  args->msg.msg_iovlen = 1;
+  args->msg.msg_control = args->control;
+  args->msg.msg_controllen = sizeof(args->control);
+  sqe->opcode = IORING_OP_RECVMSG;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(&args->msg);
+  sqe->len = 1;
+  sqe->user_data = user_data;
+  return args;
+}
+
+error uring::datagram_info(const msg_args& args, size_t num_bytes,
+                           received_datagram& info) {
+  auto& hdr = args.msg;
+  CAF_LOG_WARNING_IF((hdr.msg_flags & MSG_TRUNC) != 0,
+                     "recvmsg cut off a message, only received "
+                       << CAF_ARG2("size", args.iov[0].iov_len) << " bytes");
+  info.size = std::min(num_bytes, args.iov[0].iov_len);
+  info.segment_size = 0;
+  // CMSG_NXTHDR takes a non-const header.
+  auto mhdr = const_cast<msghdr*>(&hdr);
+  for (auto cmsg = CMSG_FIRSTHDR(mhdr); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(mhdr, cmsg)) {
+    if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO) {
+      int segment_size = 0;
+      memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(int));
+      info.segment_size = static_cast<size_t>(segment_size);
+    }
+  }
+  return detail::convert(args.addr, info.ep);
+}
+
+bool uring::timeout(uint64_t user_data, timespan rel_time) {
+  auto sqe = static_cast<io_uring_sqe*>(next_sqe());
+  if (sqe == nullptr)
+    return false;
+  auto ns = std::max(rel_time.count(), int64_t{0});
+  timeout_spec_[0] = ns / 1'000'000'000;
+  timeout_spec_[1] = ns % 1'000'000'000;
+  static_assert(sizeof(timeout_spec_) == sizeof(__kernel_timespec));
+  sqe->opcode = IORING_OP_TIMEOUT;
+  sqe->fd = -1;
+  sqe->addr = reinterpret_cast<uint64_t>(timeout_spec_);
+  sqe->len = 1;
+  // Also completes after one other completion.
+  sqe->off = 1;
+  sqe->user_data = user_data;
+  return true;
+}
+
+bool uring::cancel(uint64_t user_data, uint64_t target) {
+  auto sqe = static_cast<io_uring_sqe*>(next_sqe());
+  if (sqe == nullptr)
+    return false;
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = target;
+  sqe->user_data = user_data;
+  return true;
+}
+
+int uring::enter(unsigned min_complete) {
+  CAF_ASSERT(valid());
+  auto to_submit = sqe_tail_ - sqe_head_;
+  if (to_submit > 0) {
+    // Make the prepared entries visible to the kernel.
+    __atomic_store_n(sq_ktail_, sqe_tail_, __ATOMIC_RELEASE);
+    sqe_head_ = sqe_tail_;
+  }
+  // Always ask for events to run pending task work, which posts completions
+  // for finished operations.
+  auto res = sys_io_uring_enter(fd_, to_submit, min_complete,
+                                IORING_ENTER_GETEVENTS);
+  return res < 0 ? errno : 0;
+}
+
+size_t uring::drain(std::vector<completion>& out) {
+  CAF_ASSERT(valid());
+  auto head = *cq_khead_;
+  auto tail = __atomic_load_n(cq_ktail_, __ATOMIC_ACQUIRE);
+  auto cqes = static_cast<io_uring_cqe*>(cqes_);
+  size_t result = 0;
+  for (; head != tail; ++head, ++result) {
+    auto& cqe = cqes[head & cq_mask_];
+    out.emplace_back(completion{cqe.user_data, cqe.res});
+  }
+  __atomic_store_n(cq_khead_, head, __ATOMIC_RELEASE);
+  return result;
+}
+
+void* uring::next_sqe() {
+  auto head = __atomic_load_n(sq_khead_, __ATOMIC_ACQUIRE);
+  if (sqe_tail_ - head >= sq_entries_) {
+    // The kernel consumes all submitted entries right away.
+    if (auto err = enter(0); err != 0) {
+      CAF_LOG_ERROR("io_uring_enter failed:" << CAF_ARG(err));
+      return nullptr;
+    }
+    head = __atomic_load_n(sq_khead_, __ATOMIC_ACQUIRE);
+    if (sqe_tail_ - head >= sq_entries_)
+      return nullptr;
+  }
+  auto index = sqe_tail_ & sq_mask_;
+  sq_array_[index] = index;
+  ++sqe_tail_;
+  auto sqe = static_cast<io_uring_sqe*>(sqes_) + index;
+  memset(sqe, 0, sizeof(io_uring_sqe));
+  return sqe;
+}
+
+void uring::release() noexcept {
+  if (sqes_ != nullptr)
+    munmap(sqes_, sqes_size_);
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_)
+    munmap(cq_ring_, cq_ring_size_);
+  if (sq_ring_ != nullptr)
+    munmap(sq_ring_, sq_ring_size_);
+  if (fd_ != -1)
+    ::close(fd_);
+  reset();
+}
+
+#else // CAF_NET_HAS_URING
+
+struct uring::msg_args {};
+
+void uring::msg_args_deleter::operator()(msg_args* ptr) const noexcept {
+  delete ptr;
+}
+
+uring::uring() noexcept {
+  reset();
+}
+
+uring::~uring() {
+  // nop
+}
+
+void uring::release() noexcept {
+  // nop
+}
+
+error uring::init(unsigned) {
+  return make_error(sec::runtime_error,
+                    "io_uring is only available on Linux");
+}
+
+bool uring::poll(uint64_t, int, short) {
+  return false;
+}
+
+bool uring::recv(uint64_t, int, span<byte>) {
+  return false;
+}
+
+uring::msg_args_ptr uring::sendmsg(uint64_t, int,
+                                   span<const span<const byte>>) {
+  return nullptr;
+}
+
+uring::msg_args_ptr uring::sendmsg(uint64_t, int,
+                                   span<const span<const byte>>,
+                                   const ip_endpoint&) {
+  return nullptr;
+}
+
+uring::msg_args_ptr uring::recvmsg(uint64_t, int, span<byte>) {
+  return nullptr;
+}
+
+error uring::datagram_info(const msg_args&, size_t, received_datagram&) {
+  return sec::runtime_error;
+}
+
+bool uring::timeout(uint64_t, timespan) {
+  return false;
+}
+
+bool uring::cancel(uint64_t, uint64_t) {
+  return false;
+}
+
+int uring::enter(unsigned) {
+  return ENOSYS;
+}
+
+size_t uring::drain(std::vector<completion>&) {
+  return 0;
+}
+
+void* uring::next_sqe() {
+  return nullptr;
+}
+
+#endif // CAF_NET_HAS_URING
+
+void uring::reset() noexcept {
+  fd_ = -1;
+  sq_ring_ = nullptr;
+  sq_ring_size_ = 0;
+  cq_ring_ = nullptr;
+  cq_ring_size_ = 0;
+  sqes_ = nullptr;
+  sqes_size_ = 0;
+  sq_khead_ = nullptr;
+  sq_ktail_ = nullptr;
+  sq_array_ = nullptr;
+  sq_mask_ = 0;
+  sq_entries_ = 0;
+  cq_khead_ = nullptr;
+  cq_ktail_ = nullptr;
+  cq_mask_ = 0;
+  cqes_ = nullptr;
+  sqe_head_ = 0;
+  sqe_tail_ = 0;
+  timeout_spec_[0] = 0;
+  timeout_spec_[1] = 0;
+}
+
+} // namespace caf::net
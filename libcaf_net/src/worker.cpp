@@ -21,6 +21,8 @@
 #include "caf/actor_system.hpp"
 #include "caf/byte.hpp"
 #include "caf/net/basp/message_queue.hpp"
+#include "caf/net/basp/worker_pool.hpp"
+#include "caf/net/buffer_pool.hpp"
 #include "caf/proxy_registry.hpp"
 #include "caf/scheduler/abstract_coordinator.hpp"
 
@@ -28,8 +30,8 @@ namespace caf::net::basp {
 
 // -- constructors, destructors, and assignment operators ----------------------
 
-worker::worker(hub_type& hub, message_queue& queue, proxy_registry& proxies)
-  : hub_(&hub), queue_(&queue), proxies_(&proxies), system_(&proxies.system()) {
+worker::worker(worker_pool& pool, actor_system& sys)
+  : pool_(&pool), system_(&sys), proxies_(nullptr) {
   CAF_IGNORE_UNUSED(pad_);
 }
 
@@ -39,12 +41,29 @@ worker::~worker() {
 
 // -- management ---------------------------------------------------------------
 
-void worker::launch(const node_id& last_hop, const basp::header& hdr,
-                    span<const byte> payload) {
-  msg_id_ = queue_->new_id();
+void worker::launch(message_queue_ptr queue, proxy_registry& proxies,
+                    const node_id& last_hop, const basp::header& hdr,
+                    span<const byte> payload, strong_actor_ptr src,
+                    uint64_t ordering_key) {
+  auto buf = buffer_pool::instance().acquire(payload.size());
+  buf.assign(payload.begin(), payload.end());
+  launch(std::move(queue), proxies, last_hop, hdr, std::move(buf), 0,
+         std::move(src), ordering_key);
+}
+
+void worker::launch(message_queue_ptr queue, proxy_registry& proxies,
+                    const node_id& last_hop, const basp::header& hdr,
+                    byte_buffer&& buf, size_t offset, strong_actor_ptr src,
+                    uint64_t ordering_key) {
+  CAF_ASSERT(offset <= buf.size());
+  queue_ = std::move(queue);
+  proxies_ = &proxies;
+  msg_id_ = queue_->new_id(ordering_key);
   last_hop_ = last_hop;
   memcpy(&hdr_, &hdr, sizeof(basp::header));
-  payload_.assign(payload.begin(), payload.end());
+  buf_ = std::move(buf);
+  payload_ = make_span(buf_.data() + offset, buf_.size() - offset);
+  src_ = std::move(src);
   ref();
   system_->scheduler().enqueue(this);
 }
@@ -54,7 +73,14 @@ void worker::launch(const node_id& last_hop, const basp::header& hdr,
 resumable::resume_result worker::resume(execution_unit* ctx, size_t) {
   ctx->proxy_registry_ptr(proxies_);
   handle_remote_message(ctx);
-  hub_->push(this);
+  // Idle workers shouldn't hold on to their buffers or keep the queue of a
+  // closed connection alive.
+  buffer_pool::instance().release(std::move(buf_));
+  buf_ = byte_buffer{};
+  payload_ = span<const byte>{};
+  src_ = nullptr;
+  queue_ = nullptr;
+  pool_->push(this);
   return resumable::awaiting_message;
 }
 
@@ -0,0 +1,162 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#include "caf/net/basp/worker_pool.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#include "caf/actor_system.hpp"
+#include "caf/actor_system_config.hpp"
+#include "caf/logger.hpp"
+#include "caf/net/basp/worker.hpp"
+#include "caf/net/defaults.hpp"
+
+namespace caf::net::basp {
+
+// -- constructors, destructors, and assignment operators ----------------------
+
+worker_pool::worker_pool(actor_system& sys, size_t min_workers,
+                         size_t max_workers, timespan trim_interval)
+  : sys_(&sys),
+    min_workers_(std::min(min_workers, max_workers)),
+    max_workers_(max_workers),
+    trim_interval_(trim_interval) {
+  idle_.reserve(max_workers_);
+  for (size_t i = 0; i < min_workers_; ++i)
+    idle_.push_back(new worker(*this, sys));
+  size_ = min_workers_;
+  created_ = min_workers_;
+  min_idle_ = min_workers_;
+  next_trim_ = clock_type::now() + trim_interval_;
+}
+
+namespace {
+
+// The option `middleman.workers` predates the shared pool and configures a
+// pool with fixed size.
+
+size_t min_workers_from(const actor_system_config& cfg) {
+  if (auto num = get_if<size_t>(&cfg, "middleman.workers"))
+    return *num;
+  return get_or(cfg, "middleman.min-workers",
+                defaults::middleman::min_workers);
+}
+
+size_t max_workers_from(const actor_system_config& cfg) {
+  if (auto num = get_if<size_t>(&cfg, "middleman.workers"))
+    return *num;
+  auto fallback = std::max<size_t>(1, std::thread::hardware_concurrency());
+  return get_or(cfg, "middleman.max-workers", fallback);
+}
+
+} // namespace
+
+worker_pool::worker_pool(actor_system& sys)
+  : worker_pool(sys, min_workers_from(sys.config()),
+                max_workers_from(sys.config()),
+                get_or(sys.config(), "middleman.worker-trim-interval",
+                       defaults::middleman::worker_trim_interval)) {
+  // nop
+}
+
+worker_pool::~worker_pool() {
+  std::unique_lock<std::mutex> guard{mtx_};
+  idle_cv_.wait(guard, [this] { return idle_.size() == size_; });
+  for (auto ptr : idle_)
+    ptr->deref();
+}
+
+// -- properties ---------------------------------------------------------------
+
+worker_pool::stats worker_pool::statistics() const {
+  std::unique_lock<std::mutex> guard{mtx_};
+  stats result;
+  result.size = size_;
+  result.idle = idle_.size();
+  result.created = created_;
+  result.destroyed = destroyed_;
+  result.exhausted = exhausted_;
+  return result;
+}
+
+// -- mutators -----------------------------------------------------------------
+
+worker* worker_pool::pop() {
+  std::unique_lock<std::mutex> guard{mtx_};
+  trim_if_due();
+  if (!idle_.empty()) {
+    auto result = idle_.back();
+    idle_.pop_back();
+    min_idle_ = std::min(min_idle_, idle_.size());
+    return result;
+  }
+  min_idle_ = 0;
+  if (size_ < max_workers_) {
+    ++size_;
+    ++created_;
+    CAF_LOG_DEBUG("grow BASP worker pool" << CAF_ARG2("size", size_));
+    return new worker(*this, *sys_);
+  }
+  ++exhausted_;
+  return nullptr;
+}
+
+void worker_pool::push(worker* ptr) {
+  std::unique_lock<std::mutex> guard{mtx_};
+  idle_.push_back(ptr);
+  trim_if_due();
+  if (idle_.size() == size_)
+    idle_cv_.notify_all();
+}
+
+void worker_pool::trim(clock_type::time_point now) {
+  std::unique_lock<std::mutex> guard{mtx_};
+  trim_impl(now);
+}
+
+// -- utility functions --------------------------------------------------------
+
+void worker_pool::trim_if_due() {
+  if (trim_interval_.count() > 0) {
+    auto now = clock_type::now();
+    if (now >= next_trim_)
+      trim_impl(now);
+  }
+}
+
+void worker_pool::trim_impl(clock_type::time_point now) {
+  // Workers that stayed idle during the entire interval are surplus.
+  auto surplus = std::min(min_idle_, size_ - std::min(size_, min_workers_));
+  surplus = std::min(surplus, idle_.size());
+  if (surplus > 0) {
+    CAF_LOG_DEBUG("shrink BASP worker pool" << CAF_ARG2("size", size_)
+                                            << CAF_ARG(surplus));
+    // Destroy the workers at the bottom of the stack, i.e., the ones that
+    // were idle for the longest time.
+    for (size_t i = 0; i < surplus; ++i)
+      idle_[i]->deref();
+    idle_.erase(idle_.begin(), idle_.begin() + surplus);
+    size_ -= surplus;
+    destroyed_ += surplus;
+  }
+  min_idle_ = idle_.size();
+  next_trim_ = now + trim_interval_;
+}
+
+} // namespace caf::net::basp
@@ -20,16 +20,25 @@
 
 #include "caf/net/basp/application.hpp"
 
-#include "caf/test/dsl.hpp"
+#include "net-test.hpp"
 
+#include <chrono>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "caf/actor_clock.hpp"
 #include "caf/byte_buffer.hpp"
 #include "caf/forwarding_actor_proxy.hpp"
 #include "caf/net/basp/connection_state.hpp"
 #include "caf/net/basp/constants.hpp"
 #include "caf/net/basp/ec.hpp"
+#include "caf/net/compression.hpp"
+#include "caf/net/defaults.hpp"
+#include "caf/net/endpoint_manager_queue.hpp"
 #include "caf/net/packet_writer.hpp"
+#include "caf/net/stream_socket.hpp"
+#include "caf/net/test/host_fixture.hpp"
 #include "caf/none.hpp"
 #include "caf/uri.hpp"
 
@@ -42,7 +51,19 @@ using namespace caf::net;
 
 namespace {
 
-struct fixture : test_coordinator_fixture<>,
+struct config : actor_system_config {
+  static constexpr timespan heartbeat_interval = timespan{1'000'000'000};
+
+  config() {
+    // Large enough to keep the inline threshold at its maximum for regular
+    // messages in all tests.
+    put(content, "middleman.basp-inline-budget", timespan{10'000'000});
+    put(content, "middleman.heartbeat-interval", heartbeat_interval);
+  }
+};
+
+struct fixture : host_fixture,
+                 test_coordinator_fixture<config>,
                  proxy_registry::backend,
                  basp::application::test_tag,
                  public packet_writer {
@@ -66,10 +87,11 @@ struct fixture : test_coordinator_fixture<>,
     input = to_buf(xs...);
   }
 
-  void handle_handshake() {
+  void handle_handshake(uint64_t capabilities = 0) {
     CAF_CHECK_EQUAL(app.state(),
                     basp::connection_state::await_handshake_header);
-    auto payload = to_buf(mars, basp::application::default_app_ids());
+    auto payload = to_buf(mars, basp::application::default_app_ids(),
+                          capabilities);
     set_input(basp::header{basp::message_type::handshake,
                            static_cast<uint32_t>(payload.size()),
                            basp::version});
@@ -88,15 +110,48 @@ struct fixture : test_coordinator_fixture<>,
       CAF_FAIL("invalid handshake header");
     node_id nid;
     std::vector<std::string> app_ids;
+    uint64_t capabilities = 0;
     binary_deserializer source{sys, output};
     source.skip(basp::header_size);
-    if (auto err = source(nid, app_ids))
+    if (auto err = source(nid, app_ids, capabilities))
       CAF_FAIL("unable to deserialize payload: " << err);
+    CAF_CHECK_EQUAL(capabilities, basp::batch_capability
+                                    | basp::compression_capability
+                                    | basp::interning_capability
+                                    | basp::heartbeat_capability);
     if (source.remaining() > 0)
       CAF_FAIL("trailing bytes after reading payload");
     output.clear();
   }
 
+  error write_actor_message(strong_actor_ptr src, strong_actor_ptr dst,
+                            message content) {
+    auto elem = make_mailbox_element(std::move(src), make_message_id(), {},
+                                     std::move(content));
+    using message_type = endpoint_manager_queue::message;
+    return app.write_message(*this,
+                             std::make_unique<message_type>(std::move(elem),
+                                                            std::move(dst)));
+  }
+
+  // Returns the reference to the sender in the last interned actor message.
+  uint32_t sent_ref() {
+    binary_deserializer source{sys, output};
+    basp::header hdr;
+    uint32_t ref = 0;
+    if (auto err = source(hdr, ref))
+      CAF_FAIL("failed to receive data: " << err);
+    CAF_CHECK_EQUAL(hdr.type, basp::message_type::interned_actor_message);
+    output.clear();
+    return ref;
+  }
+
+  static uint64_t timestamp(actor_clock::time_point x) {
+    using std::chrono::duration_cast;
+    auto ns = duration_cast<timespan>(x.time_since_epoch()).count();
+    return static_cast<uint64_t>(ns);
+  }
+
   actor_system& system() {
     return sys;
   }
@@ -122,6 +177,15 @@ struct fixture : test_coordinator_fixture<>,
     // nop
   }
 
+  stream_socket handle() {
+    return sock;
+  }
+
+  uint64_t set_timeout(actor_clock::time_point tp, std::string tag) {
+    timeouts.emplace_back(tp, std::move(tag));
+    return timeouts.size();
+  }
+
   strong_actor_ptr make_proxy(node_id nid, actor_id aid) override {
     using impl_type = forwarding_actor_proxy;
     using hdl_type = strong_actor_ptr;
@@ -145,6 +209,10 @@ protected:
 
   node_id mars;
 
+  stream_socket sock{invalid_socket_id};
+
+  std::vector<std::pair<actor_clock::time_point, std::string>> timeouts;
+
   proxy_registry proxies;
 
   basp::application app;
@@ -247,6 +315,294 @@ CAF_TEST(actor message) {
   expect((std::string), from(_).to(self).with("hello world!"));
 }
 
+CAF_TEST(small actor messages skip the workers) {
+  handle_handshake();
+  consume_handshake();
+  sys.registry().put(self->id(), self);
+  MOCK(basp::message_type::actor_message, make_message_id().integer_value(),
+       mars, actor_id{42}, self->id(), std::vector<strong_actor_ptr>{},
+       make_message("hello world!"));
+  auto& stats = app.dispatch_statistics();
+  CAF_CHECK_EQUAL(stats.inline_messages, 1u);
+  CAF_CHECK_EQUAL(stats.offloaded_messages, 0u);
+  auto text = std::string(app.inline_threshold(), 'a');
+  MOCK(basp::message_type::actor_message, make_message_id().integer_value(),
+       mars, actor_id{42}, self->id(), std::vector<strong_actor_ptr>{},
+       make_message(text));
+  CAF_CHECK_EQUAL(stats.inline_messages, 1u);
+  CAF_CHECK_EQUAL(stats.offloaded_messages, 1u);
+  CAF_CHECK_GREATER(stats.offloaded_bytes, app.inline_threshold());
+  allow((monitor_atom, strong_actor_ptr),
+        from(_).to(self).with(monitor_atom_v, _));
+  expect((std::string), from(_).to(self).with("hello world!"));
+  expect((std::string), from(_).to(self).with(text));
+}
+
+CAF_TEST(applications share a worker pool) {
+  basp::worker_pool pool{sys, 0, 1, timespan{0}};
+  basp::application first{proxies, &pool};
+  basp::application second{proxies, &pool};
+  sys.registry().put(self->id(), self);
+  auto text = std::string(defaults::middleman::basp_inline_threshold, 'a');
+  auto handshake = to_buf(mars, basp::application::default_app_ids(),
+                          uint64_t{0});
+  auto payload = to_buf(mars, actor_id{42}, self->id(),
+                        std::vector<strong_actor_ptr>{}, make_message(text));
+  for (auto ptr : {&first, &second}) {
+    auto& x = *ptr;
+    REQUIRE_OK(x.init(*this));
+    set_input(basp::header{basp::message_type::handshake,
+                           static_cast<uint32_t>(handshake.size()),
+                           basp::version});
+    REQUIRE_OK(x.handle_data(*this, input));
+    REQUIRE_OK(x.handle_data(*this, handshake));
+    set_input(basp::header{basp::message_type::actor_message,
+                           static_cast<uint32_t>(payload.size()),
+                           make_message_id().integer_value()});
+    REQUIRE_OK(x.handle_data(*this, input));
+    REQUIRE_OK(x.handle_data(*this, payload));
+    CAF_CHECK_EQUAL(x.dispatch_statistics().offloaded_messages, 1u);
+    allow((monitor_atom, strong_actor_ptr),
+          from(_).to(self).with(monitor_atom_v, _));
+    expect((std::string), from(_).to(self).with(text));
+  }
+  CAF_MESSAGE("the second application reuses the worker of the first one");
+  auto stats = pool.statistics();
+  CAF_CHECK_EQUAL(stats.created, 1u);
+  CAF_CHECK_EQUAL(stats.exhausted, 0u);
+  CAF_CHECK_EQUAL(stats.idle, 1u);
+}
+
+CAF_TEST(the inline threshold follows the deserialization cost) {
+  using std::chrono::microseconds;
+  using std::chrono::milliseconds;
+  auto max_threshold = defaults::middleman::basp_inline_threshold;
+  CAF_REQUIRE_EQUAL(app.inline_threshold(), max_threshold);
+  CAF_MESSAGE("cheap messages keep the threshold at the configured maximum");
+  app.record_inline_dispatch(100, milliseconds{1});
+  CAF_CHECK_EQUAL(app.inline_threshold(), max_threshold);
+  CAF_MESSAGE("the threshold drops smoothly after an expensive message");
+  app.record_inline_dispatch(100, milliseconds{100});
+  CAF_CHECK_EQUAL(app.inline_threshold(), 74u);
+  CAF_MESSAGE("the threshold never drops below its minimum");
+  app.record_inline_dispatch(100, milliseconds{100});
+  CAF_CHECK_EQUAL(app.inline_threshold(),
+                  basp::application::min_inline_threshold);
+  CAF_MESSAGE("the threshold recovers after many cheap messages");
+  for (int i = 0; i < 100; ++i)
+    app.record_inline_dispatch(1000, microseconds{1});
+  CAF_CHECK_EQUAL(app.inline_threshold(), max_threshold);
+  CAF_CHECK_EQUAL(app.dispatch_statistics().inline_messages, 103u);
+}
+
+CAF_TEST(actor message with owned payload) {
+  handle_handshake();
+  consume_handshake();
+  sys.registry().put(self->id(), self);
+  auto text = std::string(app.inline_threshold(), 'a');
+  auto payload = to_buf(mars, actor_id{42}, self->id(),
+                        std::vector<strong_actor_ptr>{}, make_message(text));
+  set_input(basp::header{basp::message_type::actor_message,
+                         static_cast<uint32_t>(payload.size()),
+                         make_message_id().integer_value()});
+  REQUIRE_OK(app.handle_data(*this, input));
+  REQUIRE_OK(app.handle_owned_data(*this, payload));
+  CAF_CHECK(payload.empty());
+  CAF_CHECK_EQUAL(app.state(), basp::connection_state::await_header);
+  allow((monitor_atom, strong_actor_ptr),
+        from(_).to(self).with(monitor_atom_v, _));
+  expect((std::string), from(_).to(self).with(text));
+}
+
+CAF_TEST(handshakes without capabilities disable batching) {
+  handle_handshake();
+  consume_handshake();
+  CAF_CHECK_EQUAL(app.capabilities(), 0u);
+}
+
+CAF_TEST(handshakes with capabilities enable batching) {
+  auto payload = to_buf(mars, basp::application::default_app_ids(),
+                        basp::batch_capability);
+  set_input(basp::header{basp::message_type::handshake,
+                         static_cast<uint32_t>(payload.size()), basp::version});
+  REQUIRE_OK(app.handle_data(*this, input));
+  REQUIRE_OK(app.handle_data(*this, payload));
+  CAF_CHECK_EQUAL(app.state(), basp::connection_state::await_header);
+  CAF_CHECK_EQUAL(app.capabilities(), basp::batch_capability);
+}
+
+CAF_TEST(actor message batch) {
+  handle_handshake();
+  consume_handshake();
+  sys.registry().put(self->id(), self);
+  CAF_REQUIRE_EQUAL(self->mailbox().size(), 0u);
+  byte_buffer payload;
+  for (auto str : {"hello", "world"}) {
+    auto entry = to_buf(mars, actor_id{42}, self->id(),
+                        std::vector<strong_actor_ptr>{},
+                        make_message(std::string{str}));
+    auto entry_hdr = to_buf(static_cast<uint32_t>(entry.size()),
+                            make_message_id().integer_value());
+    CAF_CHECK_EQUAL(entry_hdr.size(), basp::batch_entry_header_size);
+    payload.insert(payload.end(), entry_hdr.begin(), entry_hdr.end());
+    payload.insert(payload.end(), entry.begin(), entry.end());
+  }
+  set_input(basp::header{basp::message_type::actor_message_batch,
+                         static_cast<uint32_t>(payload.size()), 2});
+  REQUIRE_OK(app.handle_data(*this, input));
+  REQUIRE_OK(app.handle_data(*this, payload));
+  CAF_CHECK_EQUAL(app.state(), basp::connection_state::await_header);
+  allow((monitor_atom, strong_actor_ptr),
+        from(_).to(self).with(monitor_atom_v, _));
+  expect((std::string), from(_).to(self).with("hello"));
+  expect((std::string), from(_).to(self).with("world"));
+}
+
+CAF_TEST(compressed actor message) {
+  handle_handshake();
+  consume_handshake();
+  sys.registry().put(self->id(), self);
+  auto payload = to_buf(mars, actor_id{42}, self->id(),
+                        std::vector<strong_actor_ptr>{},
+                        make_message(std::string(100, 'a')));
+  auto frame = to_buf(basp::header{basp::message_type::actor_message,
+                                   static_cast<uint32_t>(payload.size()),
+                                   make_message_id().integer_value()});
+  compress(payload, frame);
+  CAF_CHECK_LESS(frame.size(), basp::header_size + payload.size());
+  set_input(basp::header{basp::message_type::compressed_message,
+                         static_cast<uint32_t>(frame.size()), 0});
+  REQUIRE_OK(app.handle_data(*this, input));
+  REQUIRE_OK(app.handle_data(*this, frame));
+  CAF_CHECK_EQUAL(app.compression_statistics().decompressed_messages, 1u);
+  allow((monitor_atom, strong_actor_ptr),
+        from(_).to(self).with(monitor_atom_v, _));
+  expect((std::string), from(_).to(self).with(std::string(100, 'a')));
+}
+
+CAF_TEST(interned actor messages) {
+  handle_handshake();
+  consume_handshake();
+  sys.registry().put(self->id(), self);
+  CAF_REQUIRE_EQUAL(self->mailbox().size(), 0u);
+  MOCK(basp::message_type::interned_actor_message,
+       make_message_id().integer_value(), basp::interned_definition_flag | 1u,
+       mars, actor_id{42}, self->id(), std::vector<strong_actor_ptr>{},
+       make_message("hello"));
+  MOCK(basp::message_type::interned_actor_message,
+       make_message_id().integer_value(), uint32_t{1}, self->id(),
+       std::vector<strong_actor_ptr>{}, make_message("world"));
+  allow((monitor_atom, strong_actor_ptr),
+        from(_).to(self).with(monitor_atom_v, _));
+  expect((std::string), from(_).to(self).with("hello"));
+  expect((std::string), from(_).to(self).with("world"));
+  CAF_CHECK_EQUAL(proxies.count_proxies(mars), 1u);
+}
+
+CAF_TEST(interned actor message with unknown reference) {
+  handle_handshake();
+  consume_handshake();
+  auto payload = to_buf(uint32_t{1}, self->id(),
+                        std::vector<strong_actor_ptr>{}, make_message("hello"));
+  set_input(basp::header{basp::message_type::interned_actor_message,
+                         static_cast<uint32_t>(payload.size()),
+                         make_message_id().integer_value()});
+  REQUIRE_OK(app.handle_data(*this, input));
+  CAF_CHECK_EQUAL(app.handle_data(*this, payload), basp::ec::invalid_payload);
+}
+
+CAF_TEST(interned references to terminated actors yield anonymous messages) {
+  handle_handshake();
+  consume_handshake();
+  sys.registry().put(self->id(), self);
+  MOCK(basp::message_type::interned_actor_message,
+       make_message_id().integer_value(), basp::interned_definition_flag | 1u,
+       mars, actor_id{42}, self->id(), std::vector<strong_actor_ptr>{},
+       make_message("hello"));
+  allow((monitor_atom, strong_actor_ptr),
+        from(_).to(self).with(monitor_atom_v, _));
+  expect((std::string), from(_).to(self).with("hello"));
+  CAF_MESSAGE("the interning table must not keep the proxy alive");
+  proxies.erase(mars, actor_id{42});
+  MOCK(basp::message_type::interned_actor_message,
+       make_message_id().integer_value(), uint32_t{1}, self->id(),
+       std::vector<strong_actor_ptr>{}, make_message("world"));
+  self->receive([&](const std::string& str) {
+    CAF_CHECK_EQUAL(str, "world");
+    CAF_CHECK_EQUAL(self->current_sender(), nullptr);
+  });
+  CAF_CHECK_EQUAL(proxies.count_proxies(mars), 0u);
+}
+
+CAF_TEST(unserializable messages do not intern their sender) {
+  handle_handshake(basp::interning_capability);
+  consume_handshake();
+  auto src = actor_cast<strong_actor_ptr>(self);
+  auto dst = proxies.get_or_put(mars, actor_id{42});
+  CAF_CHECK_NOT_EQUAL(write_actor_message(src, dst,
+                                          make_message(unserializable{})),
+                      none);
+  CAF_CHECK(output.empty());
+  CAF_MESSAGE("the next message must define the sender");
+  REQUIRE_OK(write_actor_message(src, dst, make_message("hello")));
+  CAF_CHECK_EQUAL(sent_ref(), basp::interned_definition_flag | 1u);
+  REQUIRE_OK(write_actor_message(src, dst, make_message("world")));
+  CAF_CHECK_EQUAL(sent_ref(), 1u);
+}
+
+CAF_TEST(terminated actors free their interned references) {
+  handle_handshake(basp::interning_capability);
+  consume_handshake();
+  auto dst = proxies.get_or_put(mars, actor_id{42});
+  auto spawn_sender = [&] {
+    return sys.spawn([] {
+      return behavior{
+        [](int32_t) {
+          // nop
+        },
+      };
+    });
+  };
+  auto write_from = [&](const actor& src) {
+    REQUIRE_OK(write_actor_message(actor_cast<strong_actor_ptr>(src), dst,
+                                   make_message("hello")));
+    return sent_ref();
+  };
+  CAF_MESSAGE("fill the interning table");
+  std::vector<actor> senders;
+  for (uint32_t ref = 1; ref <= basp::max_interned_actors; ++ref) {
+    senders.emplace_back(spawn_sender());
+    if (write_from(senders.back()) != (basp::interned_definition_flag | ref))
+      CAF_FAIL("unexpected reference for sender " << ref);
+  }
+  CAF_MESSAGE("terminate the actor with reference 8");
+  anon_send_exit(senders[7], exit_reason::kill);
+  run();
+  senders[7] = nullptr;
+  CAF_MESSAGE("new actors reuse the freed reference");
+  senders.emplace_back(spawn_sender());
+  CAF_CHECK_EQUAL(write_from(senders.back()),
+                  basp::interned_definition_flag | 8u);
+  CAF_MESSAGE("new actors use inline definitions while the table is full");
+  senders.emplace_back(spawn_sender());
+  CAF_CHECK_EQUAL(write_from(senders.back()), basp::interned_definition_flag);
+  CAF_CHECK_EQUAL(write_from(senders.front()), 1u);
+  for (auto& hdl : senders)
+    if (hdl)
+      anon_send_exit(hdl, exit_reason::kill);
+  run();
+}
+
+CAF_TEST(actor message batch with trailing bytes) {
+  handle_handshake();
+  consume_handshake();
+  auto payload = to_buf(uint32_t{0}, uint64_t{0});
+  set_input(basp::header{basp::message_type::actor_message_batch,
+                         static_cast<uint32_t>(payload.size()), 0});
+  REQUIRE_OK(app.handle_data(*this, input));
+  CAF_CHECK_EQUAL(app.handle_data(*this, payload), basp::ec::invalid_payload);
+}
+
 CAF_TEST(resolve request without result) {
   handle_handshake();
   consume_handshake();
@@ -331,6 +687,140 @@ CAF_TEST(heartbeat message) {
   set_input(bytes);
   REQUIRE_OK(app.handle_data(*this, input));
   CAF_CHECK_EQUAL(app.state(), basp::connection_state::await_header);
+  CAF_CHECK(output.empty());
+}
+
+CAF_TEST(heartbeats carry a timestamp) {
+  handle_handshake();
+  consume_handshake();
+  auto now = actor_clock::clock_type::now();
+  REQUIRE_OK(app.heartbeat(*this, now));
+  CAF_REQUIRE_EQUAL(output.size(), basp::header_size);
+  auto hdr = basp::header::from_bytes(output);
+  CAF_CHECK_EQUAL(hdr.type, basp::message_type::heartbeat);
+  CAF_CHECK_EQUAL(hdr.operation_data, timestamp(now));
+  CAF_CHECK_EQUAL(app.heartbeat_statistics().sent_heartbeats, 1u);
+}
+
+CAF_TEST(heartbeats of the peer get an answer) {
+  handle_handshake();
+  consume_handshake();
+  set_input(basp::header{basp::message_type::heartbeat, 0, 42});
+  REQUIRE_OK(app.handle_data(*this, input));
+  CAF_REQUIRE_EQUAL(output.size(), basp::header_size);
+  auto hdr = basp::header::from_bytes(output);
+  CAF_CHECK_EQUAL(hdr.type, basp::message_type::heartbeat);
+  CAF_CHECK_EQUAL(hdr.operation_data, 42u | basp::heartbeat_reply_flag);
+}
+
+CAF_TEST(answers to heartbeats update the round-trip time) {
+  handle_handshake();
+  consume_handshake();
+  CAF_CHECK_EQUAL(app.smoothed_rtt(), timespan{0});
+  auto reply = [this](std::chrono::milliseconds age) {
+    auto sent = actor_clock::clock_type::now() - age;
+    set_input(basp::header{basp::message_type::heartbeat, 0,
+                           timestamp(sent) | basp::heartbeat_reply_flag});
+    REQUIRE_OK(app.handle_data(*this, input));
+  };
+  reply(std::chrono::milliseconds{80});
+  auto& st = app.heartbeat_statistics();
+  CAF_CHECK_EQUAL(st.received_replies, 1u);
+  CAF_CHECK_GREATER_OR_EQUAL(st.last_rtt, std::chrono::milliseconds{80});
+  CAF_CHECK_EQUAL(app.smoothed_rtt(), st.last_rtt);
+  CAF_CHECK_EQUAL(st.rtt_variance, st.last_rtt / 2);
+  reply(std::chrono::milliseconds{0});
+  CAF_CHECK_EQUAL(st.received_replies, 2u);
+  CAF_CHECK_LESS(st.last_rtt, std::chrono::milliseconds{80});
+  CAF_CHECK_LESS(app.smoothed_rtt(), std::chrono::milliseconds{80});
+  CAF_CHECK_GREATER(app.smoothed_rtt(), std::chrono::milliseconds{60});
+  CAF_CHECK(output.empty());
+}
+
+CAF_TEST(silent peers time out if they answer heartbeats) {
+  auto payload = to_buf(mars, basp::application::default_app_ids(),
+                        basp::heartbeat_capability);
+  set_input(basp::header{basp::message_type::handshake,
+                         static_cast<uint32_t>(payload.size()), basp::version});
+  REQUIRE_OK(app.handle_data(*this, input));
+  REQUIRE_OK(app.handle_data(*this, payload));
+  consume_handshake();
+  auto timeout = defaults::middleman::connection_timeout;
+  auto now = actor_clock::clock_type::now();
+  REQUIRE_OK(app.heartbeat(*this, now));
+  REQUIRE_OK(app.heartbeat(*this, now + timeout / 2));
+  CAF_CHECK_EQUAL(app.heartbeat(*this, now + timeout),
+                  basp::ec::connection_timeout);
+}
+
+CAF_TEST(the first heartbeat timeout follows the handshake) {
+  CAF_CHECK(timeouts.empty());
+  auto before = actor_clock::clock_type::now();
+  handle_handshake();
+  consume_handshake();
+  CAF_REQUIRE_EQUAL(timeouts.size(), 1u);
+  CAF_CHECK(timeouts[0].first >= before + config::heartbeat_interval);
+  CAF_CHECK_EQUAL(timeouts[0].second,
+                  basp::application::heartbeat_timeout_tag);
+  CAF_MESSAGE("further input does not schedule additional timeouts");
+  set_input(basp::header{basp::message_type::heartbeat, 0, 0});
+  REQUIRE_OK(app.handle_data(*this, input));
+  CAF_CHECK_EQUAL(timeouts.size(), 1u);
+}
+
+CAF_TEST(heartbeat timeouts send a heartbeat and reschedule) {
+  handle_handshake();
+  consume_handshake();
+  timeouts.clear();
+  auto before = actor_clock::clock_type::now();
+  app.timeout(*this, basp::application::heartbeat_timeout_tag, 1);
+  CAF_CHECK_EQUAL(app.heartbeat_statistics().sent_heartbeats, 1u);
+  CAF_REQUIRE_EQUAL(output.size(), basp::header_size);
+  CAF_CHECK_EQUAL(basp::header::from_bytes(output).type,
+                  basp::message_type::heartbeat);
+  output.clear();
+  CAF_REQUIRE_EQUAL(timeouts.size(), 1u);
+  CAF_CHECK(timeouts[0].first >= before + config::heartbeat_interval);
+  CAF_CHECK_EQUAL(timeouts[0].second,
+                  basp::application::heartbeat_timeout_tag);
+  CAF_MESSAGE("the application ignores other timeouts");
+  app.timeout(*this, "other", 2);
+  CAF_CHECK_EQUAL(timeouts.size(), 1u);
+  CAF_CHECK(output.empty());
+}
+
+CAF_TEST(heartbeat timeouts shut down silent peers) {
+  auto sockets = unbox(make_stream_socket_pair());
+  sock = sockets.first;
+  auto payload = to_buf(mars, basp::application::default_app_ids(),
+                        basp::heartbeat_capability);
+  set_input(basp::header{basp::message_type::handshake,
+                         static_cast<uint32_t>(payload.size()), basp::version});
+  REQUIRE_OK(app.handle_data(*this, input));
+  REQUIRE_OK(app.handle_data(*this, payload));
+  consume_handshake();
+  timeouts.clear();
+  CAF_MESSAGE("pretend that the peer went silent a long time ago");
+  auto timeout = defaults::middleman::connection_timeout;
+  auto past = actor_clock::clock_type::now() - timeout * 2;
+  REQUIRE_OK(app.heartbeat(*this, past));
+  output.clear();
+  app.timeout(*this, basp::application::heartbeat_timeout_tag, 1);
+  CAF_CHECK(timeouts.empty());
+  CAF_CHECK(output.empty());
+  byte_buffer rd_buf(1);
+  CAF_CHECK_EQUAL(read(sockets.second, rd_buf), sec::socket_disconnected);
+  close(sockets.first);
+  close(sockets.second);
+}
+
+CAF_TEST(silent peers without heartbeat capability never time out) {
+  handle_handshake();
+  consume_handshake();
+  auto timeout = defaults::middleman::connection_timeout;
+  auto now = actor_clock::clock_type::now();
+  REQUIRE_OK(app.heartbeat(*this, now));
+  REQUIRE_OK(app.heartbeat(*this, now + timeout * 2));
 }
 
 CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,115 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE buffer_pool
+
+#include "caf/net/buffer_pool.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace caf;
+using namespace caf::net;
+
+namespace {
+
+struct fixture {
+  fixture() : uut(buffer_pool::instance()), old_limit(uut.limit()) {
+    uut.clear();
+  }
+
+  ~fixture() {
+    uut.clear();
+    uut.limit(old_limit);
+  }
+
+  buffer_pool& uut;
+  size_t old_limit;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(buffer_pool_tests, fixture)
+
+CAF_TEST(size classes round up on acquire and down on release) {
+  CAF_CHECK_EQUAL(buffer_pool::class_for_acquire(0), 0u);
+  CAF_CHECK_EQUAL(buffer_pool::class_for_acquire(256), 0u);
+  CAF_CHECK_EQUAL(buffer_pool::class_for_acquire(257), 1u);
+  CAF_CHECK_EQUAL(buffer_pool::class_for_acquire(buffer_pool::max_class_size),
+                  buffer_pool::num_size_classes - 1);
+  CAF_CHECK_EQUAL(
+    buffer_pool::class_for_acquire(buffer_pool::max_class_size + 1),
+    buffer_pool::npos);
+  CAF_CHECK_EQUAL(buffer_pool::class_for_release(255), buffer_pool::npos);
+  CAF_CHECK_EQUAL(buffer_pool::class_for_release(256), 0u);
+  CAF_CHECK_EQUAL(buffer_pool::class_for_release(511), 0u);
+  CAF_CHECK_EQUAL(buffer_pool::class_for_release(512), 1u);
+  CAF_CHECK_EQUAL(
+    buffer_pool::class_for_release(buffer_pool::max_class_size + 1),
+    buffer_pool::npos);
+}
+
+CAF_TEST(released buffers satisfy later requests) {
+  auto before = uut.statistics();
+  auto buf = uut.acquire(1000);
+  CAF_CHECK(buf.empty());
+  CAF_CHECK_GREATER_OR_EQUAL(buf.capacity(), 1000u);
+  auto capacity = buf.capacity();
+  buf.resize(42);
+  uut.release(std::move(buf));
+  auto x = uut.statistics();
+  CAF_CHECK_EQUAL(x.released, before.released + 1);
+  CAF_CHECK_EQUAL(x.pooled_bytes, capacity);
+  buf = uut.acquire(1000);
+  CAF_CHECK(buf.empty());
+  CAF_CHECK_EQUAL(buf.capacity(), capacity);
+  x = uut.statistics();
+  CAF_CHECK_EQUAL(x.hits, before.hits + 1);
+  CAF_CHECK_EQUAL(x.pooled_bytes, 0u);
+}
+
+CAF_TEST(the pool frees buffers above its limit) {
+  uut.limit(1024);
+  auto before = uut.statistics();
+  auto buf = uut.acquire(2048);
+  uut.release(std::move(buf));
+  auto x = uut.statistics();
+  CAF_CHECK_EQUAL(x.discarded, before.discarded + 1);
+  CAF_CHECK_EQUAL(x.pooled_bytes, 0u);
+}
+
+CAF_TEST(threads share buffers via the shared free lists) {
+  std::vector<byte_buffer> bufs;
+  for (size_t i = 0; i < buffer_pool::thread_cache_size * 2; ++i)
+    bufs.emplace_back(uut.acquire(300));
+  std::thread producer{[&] {
+    for (auto& buf : bufs)
+      uut.release(std::move(buf));
+  }};
+  producer.join();
+  // The producer moved all but its local cache to the shared list and freed
+  // its local cache on exit.
+  auto before = uut.statistics();
+  CAF_CHECK_GREATER(before.pooled_bytes, 0u);
+  auto buf = uut.acquire(300);
+  CAF_CHECK_EQUAL(uut.statistics().hits, before.hits + 1);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
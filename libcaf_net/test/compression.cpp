@@ -0,0 +1,99 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE compression
+
+#include "caf/net/compression.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <random>
+
+using namespace caf;
+using namespace caf::net;
+
+namespace {
+
+struct fixture {
+  // Compresses and decompresses `input`, returning the compressed size.
+  size_t round_trip(const byte_buffer& input) {
+    byte_buffer compressed;
+    compress(input, compressed);
+    byte_buffer output;
+    if (auto err = decompress(compressed, input.size(), output))
+      CAF_FAIL("decompress failed: " << err);
+    CAF_CHECK_EQUAL(output, input);
+    return compressed.size();
+  }
+
+  std::minstd_rand rng{42};
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(compression_tests, fixture)
+
+CAF_TEST(empty and short inputs round trip) {
+  round_trip(byte_buffer{});
+  round_trip(byte_buffer{byte{1}});
+  round_trip(byte_buffer(11, byte{7}));
+  round_trip(byte_buffer(12, byte{7}));
+}
+
+CAF_TEST(repetitive inputs shrink) {
+  byte_buffer input;
+  for (int i = 0; i < 1000; ++i)
+    for (auto c : string_view{"hello actor "})
+      input.push_back(static_cast<byte>(c));
+  CAF_CHECK_LESS(round_trip(input), input.size() / 10);
+  CAF_CHECK_LESS(round_trip(byte_buffer(100000, byte{0})), 1000u);
+}
+
+CAF_TEST(random inputs round trip) {
+  for (size_t n : {13u, 100u, 5000u, 70000u}) {
+    byte_buffer input(n);
+    for (auto& x : input)
+      x = static_cast<byte>(rng() % 4);
+    round_trip(input);
+    for (auto& x : input)
+      x = static_cast<byte>(rng());
+    round_trip(input);
+  }
+}
+
+CAF_TEST(malformed inputs fail) {
+  byte_buffer input;
+  for (int i = 0; i < 100; ++i)
+    for (auto c : string_view{"abcdefgh"})
+      input.push_back(static_cast<byte>(c));
+  byte_buffer compressed;
+  compress(input, compressed);
+  byte_buffer output;
+  CAF_CHECK_NOT_EQUAL(decompress(compressed, input.size() + 1, output), none);
+  CAF_CHECK_NOT_EQUAL(decompress(compressed, input.size() - 1, output), none);
+  auto truncated = make_span(compressed.data(), compressed.size() - 1);
+  CAF_CHECK_NOT_EQUAL(decompress(truncated, input.size(), output), none);
+  CAF_CHECK_NOT_EQUAL(decompress(byte_buffer{}, 0, output), none);
+  // A match may not refer to data before the start of the output.
+  byte_buffer bad_offset{byte{0x10}, byte{'a'}, byte{0x02}, byte{0x00}};
+  CAF_CHECK_NOT_EQUAL(decompress(bad_offset, 5, output), none);
+  // Size hints beyond the maximum compression ratio fail early.
+  CAF_CHECK_NOT_EQUAL(decompress(compressed, size_t{1} << 40, output), none);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
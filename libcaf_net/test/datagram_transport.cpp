@@ -49,8 +49,9 @@ constexpr string_view hello_manager = "hello manager!";
 
 class dummy_application_factory;
 
-struct fixture : test_coordinator_fixture<>, host_fixture {
-  fixture() : shared_buf(std::make_shared<byte_buffer>(1024)) {
+template <class Config = actor_system_config>
+struct fixture_base : test_coordinator_fixture<Config>, host_fixture {
+  fixture_base() : shared_buf(std::make_shared<byte_buffer>(1024)) {
     mpx = std::make_shared<multiplexer>();
     if (auto err = mpx->init())
       CAF_FAIL("mpx->init failed: " << err);
@@ -69,7 +70,7 @@ struct fixture : test_coordinator_fixture<>, host_fixture {
       CAF_FAIL("nonblocking() returned an error: " << err);
   }
 
-  ~fixture() {
+  ~fixture_base() {
     close(send_socket);
     close(recv_socket);
   }
@@ -95,6 +96,20 @@ struct fixture : test_coordinator_fixture<>, host_fixture {
     return none;
   }
 
+  // Returns a proxy for the actor 42 on the node `test:/id/42` at `mgr`.
+  strong_actor_ptr resolve_proxy(endpoint_manager& mgr) {
+    mgr.resolve(unbox(make_uri("test:/id/42")), this->self);
+    this->run();
+    strong_actor_ptr result;
+    this->self->receive(
+      [&](resolve_atom, const std::string&, const strong_actor_ptr& p) {
+        result = p;
+      },
+      after(std::chrono::seconds(0)) >>
+        [&] { CAF_FAIL("manager did not respond with a proxy."); });
+    return result;
+  }
+
   multiplexer_ptr mpx;
   byte_buffer_ptr shared_buf;
   ip_endpoint ep;
@@ -102,6 +117,16 @@ struct fixture : test_coordinator_fixture<>, host_fixture {
   udp_datagram_socket recv_socket;
 };
 
+using fixture = fixture_base<>;
+
+struct gso_config : actor_system_config {
+  gso_config() {
+    put(content, "middleman.udp-gso", true);
+  }
+};
+
+using gso_fixture = fixture_base<gso_config>;
+
 class dummy_application {
 public:
   explicit dummy_application(byte_buffer_ptr rec_buf)
@@ -245,4 +270,125 @@ CAF_TEST(resolve and proxy communication) {
     CAF_ERROR("expected a string, got: " << to_string(msg));
 }
 
+CAF_TEST(a single write sends all queued messages) {
+  using transport_type = datagram_transport<dummy_application_factory>;
+  auto uri = unbox(make_uri("test:/id/42"));
+  auto mgr = make_endpoint_manager(
+    mpx, sys,
+    transport_type{send_socket, dummy_application_factory{shared_buf}});
+  CAF_CHECK_EQUAL(mgr->init(), none);
+  auto mgr_impl = mgr.downcast<endpoint_manager_impl<transport_type>>();
+  CAF_REQUIRE(mgr_impl != nullptr);
+  auto& transport = mgr_impl->transport();
+  CAF_CHECK_EQUAL(transport.add_new_worker(make_node_id(uri), ep), none);
+  auto proxy = resolve_proxy(*mgr);
+  CAF_MESSAGE("enqueue several messages before the manager gets to write");
+  constexpr size_t num_messages = 3;
+  auto writes = transport.write_stats().batched_writes;
+  for (size_t i = 0; i < num_messages; ++i)
+    self->send(actor_cast<actor>(proxy), "hello proxy!");
+  run();
+  CAF_CHECK_EQUAL(transport.write_stats().batched_writes, writes + 1);
+  byte_buffer recv_buf;
+  for (size_t i = 0; i < num_messages; ++i) {
+    recv_buf.resize(1024);
+    CAF_CHECK_EQUAL(read_from_socket(recv_socket, recv_buf), none);
+    message msg;
+    binary_deserializer source{sys, recv_buf};
+    CAF_CHECK_EQUAL(source(msg), none);
+    CAF_CHECK(msg.match_elements<std::string>());
+  }
+}
+
+CAF_TEST(the io_uring backend reads and writes datagrams) {
+#ifdef CAF_LINUX
+  mpx = std::make_shared<multiplexer>(multiplexer::backend_type::io_uring);
+  if (auto err = mpx->init())
+    CAF_FAIL("mpx->init failed: " << err);
+  mpx->set_thread_id();
+  if (mpx->backend() != multiplexer::backend_type::io_uring) {
+    CAF_MESSAGE("io_uring unavailable, skip test");
+    return;
+  }
+  using transport_type = datagram_transport<dummy_application_factory>;
+  auto mgr = make_endpoint_manager(
+    mpx, sys,
+    transport_type{recv_socket, dummy_application_factory{shared_buf}});
+  CAF_CHECK_EQUAL(mgr->init(), none);
+  CAF_CHECK(mgr->supports_completions());
+  CAF_CHECK(mgr->uses_datagrams());
+  CAF_MESSAGE("the multiplexer receives datagrams on behalf of the transport");
+  CAF_CHECK_EQUAL(write(send_socket, as_bytes(make_span(hello_manager)), ep),
+                  hello_manager.size());
+  run();
+  CAF_CHECK_EQUAL(string_view(reinterpret_cast<char*>(shared_buf->data()),
+                              shared_buf->size()),
+                  hello_manager);
+  CAF_MESSAGE("the multiplexer sends datagrams to the address of the worker");
+  auto uri = unbox(make_uri("test:/id/42"));
+  auto sender = make_endpoint_manager(
+    mpx, sys,
+    transport_type{send_socket, dummy_application_factory{shared_buf}});
+  CAF_CHECK_EQUAL(sender->init(), none);
+  auto sender_impl = sender.downcast<endpoint_manager_impl<transport_type>>();
+  CAF_REQUIRE(sender_impl != nullptr);
+  CAF_CHECK_EQUAL(sender_impl->transport().add_new_worker(make_node_id(uri),
+                                                          ep),
+                  none);
+  sender->resolve(uri, self);
+  run();
+  self->receive(
+    [&](resolve_atom, const std::string&, const strong_actor_ptr& p) {
+      self->send(actor_cast<actor>(p), "hello proxy!");
+    },
+    after(std::chrono::seconds(0)) >>
+      [&] { CAF_FAIL("manager did not respond with a proxy."); });
+  run();
+  message msg;
+  binary_deserializer source{sys, *shared_buf};
+  CAF_CHECK_EQUAL(source(msg), none);
+  if (msg.match_elements<std::string>())
+    CAF_CHECK_EQUAL(msg.get_as<std::string>(0), "hello proxy!");
+  else
+    CAF_ERROR("expected a string, got: " << to_string(msg));
+#endif // CAF_LINUX
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST_FIXTURE_SCOPE(gso_tests, gso_fixture)
+
+CAF_TEST(equally sized packets to one endpoint share a segmented write) {
+#ifdef CAF_LINUX
+  using transport_type = datagram_transport<dummy_application_factory>;
+  auto uri = unbox(make_uri("test:/id/42"));
+  auto mgr = make_endpoint_manager(
+    mpx, sys,
+    transport_type{send_socket, dummy_application_factory{shared_buf}});
+  CAF_CHECK_EQUAL(mgr->init(), none);
+  auto mgr_impl = mgr.downcast<endpoint_manager_impl<transport_type>>();
+  CAF_REQUIRE(mgr_impl != nullptr);
+  auto& transport = mgr_impl->transport();
+  CAF_CHECK_EQUAL(transport.add_new_worker(make_node_id(uri), ep), none);
+  auto proxy = resolve_proxy(*mgr);
+  CAF_MESSAGE("messages with the same content result in equally sized packets");
+  constexpr size_t num_messages = 3;
+  for (size_t i = 0; i < num_messages; ++i)
+    self->send(actor_cast<actor>(proxy), "hello proxy!");
+  run();
+  CAF_CHECK_EQUAL(transport.write_stats().segmented_writes, 1u);
+  CAF_CHECK_EQUAL(transport.write_stats().batched_writes, 0u);
+  CAF_MESSAGE("the receiver gets one datagram per segment");
+  byte_buffer recv_buf;
+  for (size_t i = 0; i < num_messages; ++i) {
+    recv_buf.resize(1024);
+    CAF_CHECK_EQUAL(read_from_socket(recv_socket, recv_buf), none);
+    message msg;
+    binary_deserializer source{sys, recv_buf};
+    CAF_CHECK_EQUAL(source(msg), none);
+    CAF_CHECK(msg.match_elements<std::string>());
+  }
+#endif // CAF_LINUX
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
@@ -150,4 +150,28 @@ CAF_TEST(doorman accept) {
   CAF_MESSAGE("connected");
 }
 
+CAF_TEST(doorman places connections on the selected multiplexer) {
+  auto other = std::make_shared<multiplexer>();
+  if (auto err = other->init())
+    CAF_FAIL("other->init failed: " << err);
+  other->set_thread_id();
+  auto acceptor = unbox(make_tcp_accept_socket(auth, false));
+  auto port = unbox(local_port(socket_cast<network_socket>(acceptor)));
+  auto acceptor_guard = make_socket_guard(acceptor);
+  auto mgr = make_endpoint_manager(
+    mpx, sys,
+    doorman<dummy_application_factory>{acceptor_guard.release(),
+                                       dummy_application_factory{},
+                                       [other] { return other; }});
+  CAF_CHECK_EQUAL(mgr->init(), none);
+  auto before = mpx->num_socket_managers();
+  uri::authority_type dst;
+  dst.port = port;
+  dst.host = "localhost"s;
+  auto conn = make_socket_guard(unbox(make_connected_tcp_stream_socket(dst)));
+  while (other->num_socket_managers() != 2u)
+    run();
+  CAF_CHECK_EQUAL(mpx->num_socket_managers(), before);
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
@@ -223,4 +223,93 @@ CAF_TEST(resolve and proxy communication) {
     CAF_ERROR("expected a string, got: " << to_string(msg));
 }
 
+CAF_TEST(overloaded managers drop messages if configured) {
+  byte_buffer read_buf(1024);
+  auto buf = std::make_shared<byte_buffer>();
+  auto sockets = unbox(make_stream_socket_pair());
+  CAF_CHECK_EQUAL(nonblocking(sockets.second, true), none);
+  auto guard = detail::make_scope_guard([&] { close(sockets.second); });
+  auto mgr = make_endpoint_manager(mpx, sys,
+                                   dummy_transport{sockets.first, buf});
+  CAF_CHECK_EQUAL(mgr->init(), none);
+  run();
+  CAF_CHECK_EQUAL(read(sockets.second, read_buf), hello_test.size());
+  mgr->resolve(unbox(make_uri("test:id/42")), self);
+  run();
+  strong_actor_ptr proxy;
+  self->receive(
+    [&](resolve_atom, const std::string&, const strong_actor_ptr& p) {
+      proxy = p;
+    },
+    after(std::chrono::seconds(0)) >>
+      [&] { CAF_FAIL("manager did not respond with a proxy."); });
+  CAF_MESSAGE("the manager drops messages while overloaded");
+  mgr->policy(endpoint_manager::overload_policy::drop);
+  mgr->overloaded(true);
+  self->send(actor_cast<actor>(proxy), "hello proxy!");
+  run();
+  CAF_CHECK_EQUAL(mgr->dropped_messages(), 1u);
+  CAF_CHECK_EQUAL(read(sockets.second, read_buf),
+                  sec::unavailable_or_would_block);
+  CAF_MESSAGE("the manager forwards messages again after the overload");
+  mgr->overloaded(false);
+  self->send(actor_cast<actor>(proxy), "hello proxy!");
+  run();
+  CAF_CHECK_EQUAL(mgr->dropped_messages(), 1u);
+  auto read_res = read(sockets.second, read_buf);
+  if (!holds_alternative<size_t>(read_res))
+    CAF_FAIL("read() returned an error: " << get<sec>(read_res));
+  read_buf.resize(get<size_t>(read_res));
+  message msg;
+  binary_deserializer source{sys, read_buf};
+  CAF_CHECK_EQUAL(source(msg), none);
+  if (msg.match_elements<std::string>())
+    CAF_CHECK_EQUAL(msg.get_as<std::string>(0), "hello proxy!");
+  else
+    CAF_ERROR("expected a string, got: " << to_string(msg));
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
+
+CAF_TEST(overloaded managers notify senders by default) {
+  byte_buffer read_buf(1024);
+  auto buf = std::make_shared<byte_buffer>();
+  auto sockets = unbox(make_stream_socket_pair());
+  CAF_CHECK_EQUAL(nonblocking(sockets.second, true), none);
+  auto guard = detail::make_scope_guard([&] { close(sockets.second); });
+  auto mgr = make_endpoint_manager(mpx, sys,
+                                   dummy_transport{sockets.first, buf});
+  CAF_CHECK_EQUAL(mgr->init(), none);
+  CAF_CHECK(mgr->policy() == endpoint_manager::overload_policy::notify);
+  run();
+  CAF_CHECK_EQUAL(read(sockets.second, read_buf), hello_test.size());
+  mgr->resolve(unbox(make_uri("test:id/42")), self);
+  run();
+  strong_actor_ptr proxy;
+  self->receive(
+    [&](resolve_atom, const std::string&, const strong_actor_ptr& p) {
+      proxy = p;
+    },
+    after(std::chrono::seconds(0)) >>
+      [&] { CAF_FAIL("manager did not respond with a proxy."); });
+  mgr->overloaded(true);
+  CAF_MESSAGE("asynchronous senders receive an error");
+  self->send(actor_cast<actor>(proxy), "hello proxy!");
+  run();
+  CAF_CHECK_EQUAL(mgr->dropped_messages(), 1u);
+  self->receive(
+    [](const error& err) {
+      CAF_CHECK_EQUAL(err, sec::unavailable_or_would_block);
+    },
+    after(std::chrono::seconds(0)) >>
+      [&] { CAF_FAIL("manager did not notify the sender."); });
+  CAF_MESSAGE("requests fail with an error");
+  self->request(actor_cast<actor>(proxy), infinite, "hello proxy!")
+    .receive([](const std::string&) { CAF_FAIL("expected an error"); },
+             [](const error& err) {
+               CAF_CHECK_EQUAL(err, sec::unavailable_or_would_block);
+             });
+  CAF_CHECK_EQUAL(mgr->dropped_messages(), 2u);
+  CAF_CHECK_EQUAL(read(sockets.second, read_buf),
+                  sec::unavailable_or_would_block);
+}
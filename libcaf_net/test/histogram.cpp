@@ -0,0 +1,63 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE histogram
+
+#include "caf/net/histogram.hpp"
+
+#include "caf/test/dsl.hpp"
+
+using namespace caf;
+using namespace caf::net;
+
+CAF_TEST(values map to exponentially growing buckets) {
+  CAF_CHECK_EQUAL(histogram::bucket_of(0), 0u);
+  CAF_CHECK_EQUAL(histogram::bucket_of(1), 1u);
+  CAF_CHECK_EQUAL(histogram::bucket_of(2), 2u);
+  CAF_CHECK_EQUAL(histogram::bucket_of(3), 2u);
+  CAF_CHECK_EQUAL(histogram::bucket_of(4), 3u);
+  CAF_CHECK_EQUAL(histogram::bucket_of(1023), 10u);
+  CAF_CHECK_EQUAL(histogram::bucket_of(1024), 11u);
+  CAF_CHECK_EQUAL(histogram::bucket_of(uint64_t{1} << 60),
+                  histogram::num_buckets - 1);
+  CAF_CHECK_EQUAL(histogram::upper_bound(0), 1u);
+  CAF_CHECK_EQUAL(histogram::upper_bound(10), 1024u);
+}
+
+CAF_TEST(snapshots reflect all recorded values) {
+  histogram uut;
+  auto empty = uut.read();
+  CAF_CHECK_EQUAL(empty.count, 0u);
+  CAF_CHECK_EQUAL(empty.mean(), 0.0);
+  CAF_CHECK_EQUAL(empty.quantile(0.5), 0u);
+  for (uint64_t i = 1; i <= 100; ++i)
+    uut.record(i);
+  auto x = uut.read();
+  CAF_CHECK_EQUAL(x.count, 100u);
+  CAF_CHECK_EQUAL(x.sum, 5050u);
+  CAF_CHECK_EQUAL(x.max, 100u);
+  CAF_CHECK_EQUAL(x.mean(), 50.5);
+  CAF_CHECK_EQUAL(x.buckets[histogram::bucket_of(1)], 1u);
+  CAF_CHECK_EQUAL(x.buckets[histogram::bucket_of(64)], 37u);
+  // The 50th value (50) falls into [32, 64).
+  CAF_CHECK_EQUAL(x.quantile(0.5), 64u);
+  // Quantile bounds never exceed the maximum.
+  CAF_CHECK_EQUAL(x.quantile(1.0), 100u);
+  uut.reset();
+  CAF_CHECK_EQUAL(uut.read().count, 0u);
+}
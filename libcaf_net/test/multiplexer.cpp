@@ -23,8 +23,11 @@
 #include "caf/net/test/host_fixture.hpp"
 #include "caf/test/dsl.hpp"
 
+#include <chrono>
 #include <new>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include "caf/byte.hpp"
 #include "caf/byte_buffer.hpp"
@@ -85,6 +88,10 @@ public:
     CAF_FAIL("handle_error called with code " << code);
   }
 
+  void handle_timeout(std::string type, uint64_t id) override {
+    timeouts.emplace_back(std::move(type), id);
+  }
+
   void send(string_view x) {
     auto x_bytes = as_bytes(make_span(x));
     wr_buf_.insert(wr_buf_.end(), x_bytes.begin(), x_bytes.end());
@@ -96,6 +103,8 @@ public:
     return result;
   }
 
+  std::vector<std::pair<std::string, uint64_t>> timeouts;
+
 private:
   byte* read_position_begin() {
     return rd_buf_.data() + rd_buf_pos_;
@@ -120,6 +129,17 @@ private:
 
 using dummy_manager_ptr = intrusive_ptr<dummy_manager>;
 
+const char* backend_name(multiplexer::backend_type x) {
+  switch (x) {
+    case multiplexer::backend_type::poll:
+      return "poll";
+    case multiplexer::backend_type::epoll:
+      return "epoll";
+    default:
+      return "io_uring";
+  }
+}
+
 struct fixture : host_fixture {
   fixture() : manager_count(0), mpx(std::make_shared<multiplexer>()) {
     mpx->set_thread_id();
@@ -135,6 +155,26 @@ struct fixture : host_fixture {
       ; // Repeat.
   }
 
+  /// Runs `f` once per available backend, each time with a fresh multiplexer.
+  template <class F>
+  void for_each_backend(F f) {
+    std::vector<multiplexer::backend_type> backends{
+      multiplexer::backend_type::poll};
+#ifdef CAF_LINUX
+    backends.emplace_back(multiplexer::backend_type::epoll);
+    backends.emplace_back(multiplexer::backend_type::io_uring);
+#endif // CAF_LINUX
+    for (auto backend : backends) {
+      CAF_MESSAGE("run with the " << backend_name(backend) << " backend");
+      mpx = std::make_shared<multiplexer>(backend);
+      mpx->set_thread_id();
+      CAF_CHECK(mpx->backend() == backend);
+      f();
+      mpx.reset();
+      CAF_REQUIRE_EQUAL(manager_count, 0u);
+    }
+  }
+
   size_t manager_count;
 
   multiplexer_ptr mpx;
@@ -145,59 +185,191 @@ struct fixture : host_fixture {
 CAF_TEST_FIXTURE_SCOPE(multiplexer_tests, fixture)
 
 CAF_TEST(default construction) {
+  CAF_CHECK(mpx->backend() == multiplexer::default_backend);
   CAF_CHECK_EQUAL(mpx->num_socket_managers(), 0u);
 }
 
 CAF_TEST(init) {
-  CAF_CHECK_EQUAL(mpx->num_socket_managers(), 0u);
-  CAF_REQUIRE_EQUAL(mpx->init(), none);
-  CAF_CHECK_EQUAL(mpx->num_socket_managers(), 1u);
-  mpx->close_pipe();
-  exhaust();
-  CAF_CHECK_EQUAL(mpx->num_socket_managers(), 0u);
-  // Calling run must have no effect now.
-  mpx->run();
+  for_each_backend([this] {
+    CAF_CHECK_EQUAL(mpx->num_socket_managers(), 0u);
+    CAF_REQUIRE_EQUAL(mpx->init(), none);
+    CAF_CHECK_EQUAL(mpx->num_socket_managers(), 1u);
+    mpx->close_pipe();
+    exhaust();
+    CAF_CHECK_EQUAL(mpx->num_socket_managers(), 0u);
+    // Calling run must have no effect now.
+    mpx->run();
+  });
 }
 
 CAF_TEST(send and receive) {
-  CAF_REQUIRE_EQUAL(mpx->init(), none);
-  auto sockets = unbox(make_stream_socket_pair());
-  auto alice = make_counted<dummy_manager>(manager_count, sockets.first, mpx);
-  auto bob = make_counted<dummy_manager>(manager_count, sockets.second, mpx);
-  alice->register_reading();
-  bob->register_reading();
-  CAF_CHECK_EQUAL(mpx->num_socket_managers(), 3u);
-  alice->send("hello bob");
-  alice->register_writing();
-  exhaust();
-  CAF_CHECK_EQUAL(bob->receive(), "hello bob");
+  for_each_backend([this] {
+    CAF_REQUIRE_EQUAL(mpx->init(), none);
+    auto sockets = unbox(make_stream_socket_pair());
+    auto alice = make_counted<dummy_manager>(manager_count, sockets.first,
+                                             mpx);
+    auto bob = make_counted<dummy_manager>(manager_count, sockets.second, mpx);
+    alice->register_reading();
+    bob->register_reading();
+    CAF_CHECK_EQUAL(mpx->num_socket_managers(), 3u);
+    alice->send("hello bob");
+    alice->register_writing();
+    exhaust();
+    CAF_CHECK_EQUAL(bob->receive(), "hello bob");
+  });
+}
+
+CAF_TEST(registering sockets from other threads) {
+  for_each_backend([this] {
+    CAF_REQUIRE_EQUAL(mpx->init(), none);
+    auto sockets = unbox(make_stream_socket_pair());
+    auto alice = make_counted<dummy_manager>(manager_count, sockets.first,
+                                             mpx);
+    auto bob = make_counted<dummy_manager>(manager_count, sockets.second, mpx);
+    std::thread registrar{[&] {
+      alice->register_reading();
+      bob->register_reading();
+      alice->send("hello bob");
+      alice->register_writing();
+    }};
+    registrar.join();
+    // The pending commands are still in the queue of the multiplexer.
+    CAF_CHECK_EQUAL(mpx->num_socket_managers(), 1u);
+    exhaust();
+    CAF_CHECK_EQUAL(mpx->num_socket_managers(), 3u);
+    CAF_CHECK_EQUAL(bob->receive(), "hello bob");
+  });
+}
+
+CAF_TEST(removing a manager keeps the remaining managers intact) {
+  for_each_backend([this] {
+    CAF_REQUIRE_EQUAL(mpx->init(), none);
+    auto first_pair = unbox(make_stream_socket_pair());
+    auto second_pair = unbox(make_stream_socket_pair());
+    auto alice = make_counted<dummy_manager>(manager_count, first_pair.first,
+                                             mpx);
+    auto bob = make_counted<dummy_manager>(manager_count, first_pair.second,
+                                           mpx);
+    auto carl = make_counted<dummy_manager>(manager_count, second_pair.first,
+                                            mpx);
+    auto dave = make_counted<dummy_manager>(manager_count, second_pair.second,
+                                            mpx);
+    for (auto& mgr : {alice, bob, carl, dave})
+      mgr->register_reading();
+    CAF_CHECK_EQUAL(mpx->num_socket_managers(), 5u);
+    // Shutting down Alice's socket removes Bob from the middle of the
+    // pollset.
+    shutdown_write(first_pair.first);
+    exhaust();
+    CAF_CHECK_EQUAL(mpx->num_socket_managers(), 4u);
+    CAF_CHECK_EQUAL(mpx->index_of(bob), -1);
+    CAF_CHECK_NOT_EQUAL(mpx->index_of(carl), -1);
+    CAF_CHECK_NOT_EQUAL(mpx->index_of(dave), -1);
+    carl->send("hello dave");
+    carl->register_writing();
+    exhaust();
+    CAF_CHECK_EQUAL(dave->receive(), "hello dave");
+  });
+}
+
+CAF_TEST(timeouts fire on the multiplexer thread) {
+  for_each_backend([this] {
+    CAF_REQUIRE_EQUAL(mpx->init(), none);
+    auto sockets = unbox(make_stream_socket_pair());
+    auto alice = make_counted<dummy_manager>(manager_count, sockets.first,
+                                             mpx);
+    auto bob = make_counted<dummy_manager>(manager_count, sockets.second, mpx);
+    alice->register_reading();
+    bob->register_reading();
+    auto now = actor_clock::clock_type::now();
+    auto id1 = mpx->set_timeout(now, alice, "foo");
+    auto id2 = mpx->set_timeout(now + std::chrono::milliseconds(1), alice,
+                                "bar");
+    auto id3 = mpx->set_timeout(now, bob, "baz");
+    CAF_CHECK_EQUAL(mpx->num_timeouts(), 3u);
+    CAF_CHECK(mpx->cancel_timeout(id3));
+    // The blocking poll returns as soon as the next timeout expires.
+    while (mpx->num_timeouts() > 0)
+      mpx->poll_once(true);
+    using timeout_list = std::vector<std::pair<std::string, uint64_t>>;
+    CAF_CHECK_EQUAL(alice->timeouts,
+                    timeout_list({{"foo", id1}, {"bar", id2}}));
+    CAF_CHECK(bob->timeouts.empty());
+  });
+}
+
+CAF_TEST(busy polling picks up events without blocking) {
+  for_each_backend([this] {
+    mpx->busy_poll_budget(std::chrono::milliseconds(100));
+    CAF_REQUIRE_EQUAL(mpx->init(), none);
+    mpx->close_pipe();
+    mpx->run();
+    CAF_CHECK_EQUAL(mpx->num_socket_managers(), 0u);
+    CAF_CHECK_GREATER_OR_EQUAL(mpx->busy_poll_hits(), 1u);
+    CAF_CHECK_EQUAL(mpx->busy_poll_misses(), 0u);
+  });
+}
+
+CAF_TEST(the multiplexer records metrics only when enabled) {
+  for_each_backend([this] {
+    CAF_REQUIRE_EQUAL(mpx->init(), none);
+    auto sockets = unbox(make_stream_socket_pair());
+    auto alice = make_counted<dummy_manager>(manager_count, sockets.first,
+                                             mpx);
+    auto bob = make_counted<dummy_manager>(manager_count, sockets.second, mpx);
+    alice->register_reading();
+    bob->register_reading();
+    alice->send("hello bob");
+    alice->register_writing();
+    exhaust();
+    CAF_CHECK_EQUAL(mpx->metrics().poll_wait.read().count, 0u);
+    CAF_CHECK_EQUAL(bob->stats().read_events.load(), 0u);
+    mpx->metrics_enabled(true);
+    alice->send("hello again");
+    std::thread registrar{[&] { alice->register_writing(); }};
+    registrar.join();
+    exhaust();
+    CAF_CHECK_EQUAL(bob->receive(), "hello bobhello again");
+    auto& metrics = mpx->metrics();
+    CAF_CHECK_GREATER(metrics.poll_wait.read().count, 0u);
+    CAF_CHECK_GREATER(metrics.ready_events.read().max, 0u);
+    CAF_CHECK_GREATER(metrics.read_handler.read().count, 0u);
+    CAF_CHECK_GREATER(metrics.write_handler.read().count, 0u);
+    CAF_CHECK_EQUAL(metrics.cross_thread_registrations.load(), 1u);
+    CAF_CHECK_GREATER(bob->stats().read_events.load(), 0u);
+    CAF_CHECK_EQUAL(bob->stats().write_events.load(), 0u);
+    CAF_CHECK_EQUAL(alice->stats().write_events.load(), 1u);
+  });
 }
 
 CAF_TEST(shutdown) {
-  std::mutex m;
-  std::condition_variable cv;
-  bool thread_id_set = false;
-  auto run_mpx = [&] {
+  for_each_backend([this] {
+    std::mutex m;
+    std::condition_variable cv;
+    bool thread_id_set = false;
+    auto run_mpx = [&] {
+      std::unique_lock<std::mutex> lk(m);
+      mpx->set_thread_id();
+      thread_id_set = true;
+      lk.unlock();
+      cv.notify_one();
+      mpx->run();
+    };
+    CAF_REQUIRE_EQUAL(mpx->init(), none);
+    auto sockets = unbox(make_stream_socket_pair());
+    auto alice = make_counted<dummy_manager>(manager_count, sockets.first,
+                                             mpx);
+    auto bob = make_counted<dummy_manager>(manager_count, sockets.second, mpx);
+    alice->register_reading();
+    bob->register_reading();
+    CAF_REQUIRE_EQUAL(mpx->num_socket_managers(), 3u);
+    std::thread mpx_thread{run_mpx};
     std::unique_lock<std::mutex> lk(m);
-    mpx->set_thread_id();
-    thread_id_set = true;
-    lk.unlock();
-    cv.notify_one();
-    mpx->run();
-  };
-  CAF_REQUIRE_EQUAL(mpx->init(), none);
-  auto sockets = unbox(make_stream_socket_pair());
-  auto alice = make_counted<dummy_manager>(manager_count, sockets.first, mpx);
-  auto bob = make_counted<dummy_manager>(manager_count, sockets.second, mpx);
-  alice->register_reading();
-  bob->register_reading();
-  CAF_REQUIRE_EQUAL(mpx->num_socket_managers(), 3u);
-  std::thread mpx_thread{run_mpx};
-  std::unique_lock<std::mutex> lk(m);
-  cv.wait(lk, [&] { return thread_id_set; });
-  mpx->shutdown();
-  mpx_thread.join();
-  CAF_REQUIRE_EQUAL(mpx->num_socket_managers(), 0u);
+    cv.wait(lk, [&] { return thread_id_set; });
+    mpx->shutdown();
+    mpx_thread.join();
+    CAF_REQUIRE_EQUAL(mpx->num_socket_managers(), 0u);
+  });
 }
 
 CAF_TEST_FIXTURE_SCOPE_END()
@@ -1,5 +1,7 @@
 #define CAF_TEST_NO_MAIN
 
+#include "net-test.hpp"
+
 #include "caf/test/unit_test_impl.hpp"
 
 #include "caf/init_global_meta_objects.hpp"
@@ -8,6 +10,7 @@
 int main(int argc, char** argv) {
   using namespace caf;
   net::middleman::init_global_meta_objects();
+  init_global_meta_objects<id_block::net_test>();
   core::init_global_meta_objects();
   return test::main(argc, argv);
 }
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "caf/meta/type_name.hpp"
+#include "caf/sec.hpp"
+#include "caf/test/dsl.hpp"
+#include "caf/type_id.hpp"
+
+/// A type that always fails to serialize for testing error handling.
+struct unserializable {
+  int32_t value = 0;
+};
+
+template <class Inspector>
+typename Inspector::result_type inspect(Inspector& f, unserializable& x) {
+  using result_type = typename Inspector::result_type;
+  if constexpr (Inspector::reads_state && !std::is_void<result_type>::value)
+    return result_type{caf::sec::unsupported_operation};
+  else
+    return f(caf::meta::type_name("unserializable"), x.value);
+}
+
+CAF_BEGIN_TYPE_ID_BLOCK(net_test, caf::first_custom_type_id)
+
+  CAF_ADD_TYPE_ID(net_test, (unserializable))
+
+CAF_END_TYPE_ID_BLOCK(net_test)
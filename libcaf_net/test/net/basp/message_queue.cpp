@@ -52,10 +52,14 @@ struct fixture : test_coordinator_fixture<> {
       queue.new_id();
   }
 
-  void push(int msg_id) {
-    queue.push(nullptr, static_cast<uint64_t>(msg_id), testee,
+  void push(uint64_t id, int value) {
+    queue.push(nullptr, id, testee,
                make_mailbox_element(self->ctrl(), make_message_id(), {},
-                                    ok_atom_v, msg_id));
+                                    ok_atom_v, value));
+  }
+
+  void push(int msg_id) {
+    push(static_cast<uint64_t>(msg_id), msg_id);
   }
 };
 
@@ -64,16 +68,41 @@ struct fixture : test_coordinator_fixture<> {
 CAF_TEST_FIXTURE_SCOPE(message_queue_tests, fixture)
 
 CAF_TEST(default construction) {
-  CAF_CHECK_EQUAL(queue.next_id, 0u);
-  CAF_CHECK_EQUAL(queue.next_undelivered, 0u);
-  CAF_CHECK_EQUAL(queue.pending.size(), 0u);
+  CAF_CHECK_EQUAL(queue.shards[0].next_id, 0u);
+  CAF_CHECK_EQUAL(queue.shards[0].next_undelivered, 0u);
+  CAF_CHECK_EQUAL(queue.shards[0].pending.size(), 0u);
 }
 
 CAF_TEST(ascending IDs) {
   CAF_CHECK_EQUAL(queue.new_id(), 0u);
   CAF_CHECK_EQUAL(queue.new_id(), 1u);
   CAF_CHECK_EQUAL(queue.new_id(), 2u);
-  CAF_CHECK_EQUAL(queue.next_undelivered, 0u);
+  CAF_CHECK_EQUAL(queue.shards[0].next_undelivered, 0u);
+}
+
+CAF_TEST(ordering keys select the shard) {
+  auto key = uint64_t{1} << net::basp::message_queue::shard_shift;
+  auto id = queue.new_id(key);
+  CAF_CHECK_EQUAL(net::basp::message_queue::shard_index(id), 1u);
+  CAF_CHECK_EQUAL(queue.new_id(key), id + 1);
+  CAF_CHECK_EQUAL(queue.shards[0].next_id, 0u);
+  auto k1 = net::basp::message_queue::ordering_key(1, 2);
+  auto k2 = net::basp::message_queue::ordering_key(1, 2);
+  CAF_CHECK_EQUAL(k1, k2);
+}
+
+CAF_TEST(shards deliver independently) {
+  auto key = uint64_t{1} << net::basp::message_queue::shard_shift;
+  auto id0 = queue.new_id();
+  auto id1 = queue.new_id(key);
+  auto id2 = queue.new_id(key);
+  push(id2, 2);
+  disallow((ok_atom, int), from(self).to(testee));
+  push(id1, 1);
+  expect((ok_atom, int), from(self).to(testee).with(_, 1));
+  expect((ok_atom, int), from(self).to(testee).with(_, 2));
+  push(id0, 0);
+  expect((ok_atom, int), from(self).to(testee).with(_, 0));
 }
 
 CAF_TEST(push order 0 - 1 - 2) {
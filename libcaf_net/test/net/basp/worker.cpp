@@ -29,6 +29,7 @@
 #include "caf/byte_buffer.hpp"
 #include "caf/make_actor.hpp"
 #include "caf/net/basp/message_queue.hpp"
+#include "caf/net/basp/worker_pool.hpp"
 #include "caf/proxy_registry.hpp"
 
 using namespace caf;
@@ -78,14 +79,18 @@ private:
 };
 
 struct fixture : test_coordinator_fixture<> {
-  detail::worker_hub<net::basp::worker> hub;
-  net::basp::message_queue queue;
   mock_proxy_registry_backend proxies_backend;
   proxy_registry proxies;
+  std::shared_ptr<net::basp::message_queue> queue;
+  net::basp::worker_pool pool;
   node_id last_hop;
   actor testee;
 
-  fixture() : proxies_backend(sys), proxies(sys, proxies_backend) {
+  fixture()
+    : proxies_backend(sys),
+      proxies(sys, proxies_backend),
+      queue(std::make_shared<net::basp::message_queue>()),
+      pool(sys, 0, 1, timespan{0}) {
     auto tmp = make_node_id(123, "0011223344556677889900112233445566778899");
     last_hop = unbox(std::move(tmp));
     testee = sys.spawn<lazy_init>(testee_impl);
@@ -103,10 +108,10 @@ CAF_TEST_FIXTURE_SCOPE(worker_tests, fixture)
 
 CAF_TEST(deliver serialized message) {
   CAF_MESSAGE("create the BASP worker");
-  CAF_REQUIRE_EQUAL(hub.peek(), nullptr);
-  hub.add_new_worker(queue, proxies);
-  CAF_REQUIRE_NOT_EQUAL(hub.peek(), nullptr);
-  auto w = hub.pop();
+  CAF_REQUIRE_EQUAL(pool.statistics().size, 0u);
+  auto w = pool.pop();
+  CAF_REQUIRE(w != nullptr);
+  CAF_REQUIRE_EQUAL(pool.statistics().size, 1u);
   CAF_MESSAGE("create a fake message + BASP header");
   byte_buffer payload;
   std::vector<strong_actor_ptr> stages;
@@ -118,7 +123,28 @@ CAF_TEST(deliver serialized message) {
                         static_cast<uint32_t>(payload.size()),
                         make_message_id().integer_value()};
   CAF_MESSAGE("launch worker");
-  w->launch(last_hop, hdr, payload);
+  w->launch(queue, proxies, last_hop, hdr, payload);
+  sched.run_once();
+  expect((ok_atom), from(_).to(testee));
+}
+
+CAF_TEST(deliver serialized message without copying) {
+  auto w = pool.pop();
+  CAF_REQUIRE(w != nullptr);
+  CAF_MESSAGE("create a fake message + BASP header behind a 4-byte prefix");
+  byte_buffer buf(4);
+  std::vector<strong_actor_ptr> stages;
+  binary_serializer sink{sys, buf};
+  sink.seek(4);
+  if (auto err = sink(node_id{}, self->id(), testee.id(), stages,
+                      make_message(ok_atom_v)))
+    CAF_FAIL("unable to serialize message: " << err);
+  net::basp::header hdr{net::basp::message_type::actor_message,
+                        static_cast<uint32_t>(buf.size() - 4),
+                        make_message_id().integer_value()};
+  CAF_MESSAGE("launch worker with ownership of the buffer");
+  w->launch(queue, proxies, last_hop, hdr, std::move(buf), 4);
+  CAF_CHECK(buf.empty());
   sched.run_once();
   expect((ok_atom), from(_).to(testee));
 }
@@ -0,0 +1,80 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE net.basp.worker_pool
+
+#include "caf/net/basp/worker_pool.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <vector>
+
+#include "caf/net/basp/worker.hpp"
+
+using namespace caf;
+using namespace caf::net;
+
+CAF_TEST_FIXTURE_SCOPE(worker_pool_tests, test_coordinator_fixture<>)
+
+CAF_TEST(the pool starts with its minimum size) {
+  basp::worker_pool pool{sys, 2, 4, timespan{0}};
+  auto stats = pool.statistics();
+  CAF_CHECK_EQUAL(stats.size, 2u);
+  CAF_CHECK_EQUAL(stats.idle, 2u);
+  CAF_CHECK_EQUAL(stats.created, 2u);
+}
+
+CAF_TEST(the pool grows on demand up to its maximum size) {
+  basp::worker_pool pool{sys, 0, 2, timespan{0}};
+  auto w1 = pool.pop();
+  auto w2 = pool.pop();
+  CAF_REQUIRE(w1 != nullptr);
+  CAF_REQUIRE(w2 != nullptr);
+  CAF_CHECK(w1 != w2);
+  CAF_CHECK(pool.pop() == nullptr);
+  auto stats = pool.statistics();
+  CAF_CHECK_EQUAL(stats.size, 2u);
+  CAF_CHECK_EQUAL(stats.idle, 0u);
+  CAF_CHECK_EQUAL(stats.created, 2u);
+  CAF_CHECK_EQUAL(stats.exhausted, 1u);
+  pool.push(w1);
+  CAF_CHECK(pool.pop() == w1);
+  pool.push(w1);
+  pool.push(w2);
+  CAF_CHECK_EQUAL(pool.statistics().idle, 2u);
+}
+
+CAF_TEST(the pool destroys workers that stay idle for an entire interval) {
+  basp::worker_pool pool{sys, 1, 4, timespan{0}};
+  std::vector<basp::worker*> workers;
+  for (int i = 0; i < 3; ++i)
+    workers.push_back(pool.pop());
+  for (auto ptr : workers)
+    pool.push(ptr);
+  CAF_MESSAGE("all workers were busy during the first interval");
+  pool.trim(basp::worker_pool::clock_type::now());
+  CAF_CHECK_EQUAL(pool.statistics().size, 3u);
+  CAF_MESSAGE("no worker was busy during the second interval");
+  pool.trim(basp::worker_pool::clock_type::now());
+  auto stats = pool.statistics();
+  CAF_CHECK_EQUAL(stats.size, 1u);
+  CAF_CHECK_EQUAL(stats.idle, 1u);
+  CAF_CHECK_EQUAL(stats.destroyed, 2u);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
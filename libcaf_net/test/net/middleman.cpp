@@ -0,0 +1,140 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#define CAF_SUITE net.middleman
+
+#include "caf/net/middleman.hpp"
+
+#include "caf/net/test/host_fixture.hpp"
+#include "caf/test/dsl.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "caf/actor_system.hpp"
+#include "caf/actor_system_config.hpp"
+#include "caf/net/backend/tcp.hpp"
+#include "caf/net/multiplexer.hpp"
+#include "caf/net/socket_guard.hpp"
+#include "caf/net/tcp_stream_socket.hpp"
+#include "caf/uri.hpp"
+
+using namespace caf;
+using namespace caf::net;
+using namespace std::literals::string_literals;
+
+namespace {
+
+struct config : actor_system_config {
+  explicit config(size_t num_threads, bool manual = false) {
+    put(content, "middleman.this-node", unbox(make_uri("tcp://earth")));
+    put(content, "middleman.tcp-port", uint16_t{0});
+    put(content, "middleman.multiplexer-threads", num_threads);
+    put(content, "middleman.manual-multiplexing", manual);
+    put(content, "middleman.enable-metrics", true);
+    load<middleman, backend::tcp>();
+  }
+};
+
+struct fixture : host_fixture {
+  // Waits up to five seconds for `pred` to become true.
+  template <class Predicate>
+  bool wait_for(Predicate pred) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!pred()) {
+      if (std::chrono::steady_clock::now() >= deadline)
+        return false;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+  }
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(middleman_tests, fixture)
+
+CAF_TEST(the middleman creates one multiplexer per configured thread) {
+  config cfg{3};
+  actor_system sys{cfg};
+  auto& mpxs = sys.network_manager().mpxs();
+  CAF_REQUIRE_EQUAL(mpxs.size(), 3u);
+  CAF_CHECK_EQUAL(sys.network_manager().mpx(), mpxs.front());
+  for (size_t i = 1; i < mpxs.size(); ++i)
+    CAF_CHECK_NOT_EQUAL(mpxs[i], mpxs[i - 1]);
+}
+
+CAF_TEST(manual multiplexing always uses a single multiplexer) {
+  config cfg{3, true};
+  actor_system sys{cfg};
+  CAF_CHECK_EQUAL(sys.network_manager().mpxs().size(), 1u);
+}
+
+CAF_TEST(next_mpx iterates the pool in round-robin order) {
+  config cfg{3};
+  actor_system sys{cfg};
+  auto& mm = sys.network_manager();
+  auto& mpxs = mm.mpxs();
+  for (size_t i = 0; i < 2 * mpxs.size(); ++i)
+    CAF_CHECK_EQUAL(mm.next_mpx(), mpxs[i % mpxs.size()]);
+}
+
+CAF_TEST(accepted connections spread over the multiplexer pool) {
+  config cfg{3};
+  actor_system sys{cfg};
+  auto& mm = sys.network_manager();
+  auto& mpxs = mm.mpxs();
+  // Each multiplexer other than the first only receives cross-thread
+  // registrations for connections that the doorman assigned to it.
+  auto registrations = [&](size_t index) {
+    return mpxs[index]->metrics().cross_thread_registrations.load();
+  };
+  CAF_REQUIRE_EQUAL(registrations(1), 0u);
+  CAF_REQUIRE_EQUAL(registrations(2), 0u);
+  uri::authority_type auth;
+  auth.host = "localhost"s;
+  auth.port = unbox(mm.port("tcp"));
+  // The doorman assigns the first connection to its own multiplexer and the
+  // next two connections to the other multiplexers.
+  std::vector<socket_guard<tcp_stream_socket>> conns;
+  for (int i = 0; i < 3; ++i)
+    conns.emplace_back(unbox(make_connected_tcp_stream_socket(auth)));
+  CAF_CHECK(wait_for([&] { return registrations(1) > 0; }));
+  CAF_CHECK(wait_for([&] { return registrations(2) > 0; }));
+}
+
+CAF_TEST(stopping the middleman joins all multiplexer threads) {
+  std::vector<multiplexer_ptr> mpxs;
+  {
+    config cfg{3};
+    actor_system sys{cfg};
+    mpxs = sys.network_manager().mpxs();
+    CAF_REQUIRE_EQUAL(mpxs.size(), 3u);
+  }
+  // Each thread only returns from run() after its multiplexer removed all
+  // socket managers.
+  for (auto& mpx : mpxs) {
+    CAF_CHECK_EQUAL(mpx->num_socket_managers(), 0u);
+    CAF_CHECK_EQUAL(mpx.use_count(), 1);
+  }
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
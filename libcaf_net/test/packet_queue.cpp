@@ -0,0 +1,122 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE packet_queue
+
+#include "caf/net/packet_queue.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <vector>
+
+using namespace caf;
+using namespace caf::net;
+
+namespace {
+
+struct fixture {
+  // Pushes a packet with a header of `id` bytes and a payload of 10 bytes.
+  void push(int id) {
+    byte_buffer hdr(static_cast<size_t>(id), byte{1});
+    byte_buffer payload(10, byte{2});
+    hdr_data.emplace_back(hdr.data());
+    byte_buffer* ptrs[] = {&hdr, &payload};
+    uut.push_back(id, make_span(ptrs));
+  }
+
+  packet_queue<int> uut;
+  std::vector<const byte*> hdr_data;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(packet_queue_tests, fixture)
+
+CAF_TEST(packets leave the queue in FIFO order) {
+  CAF_CHECK(uut.empty());
+  for (int i = 1; i <= 3; ++i)
+    push(i);
+  CAF_CHECK_EQUAL(uut.size(), 3u);
+  for (int i = 1; i <= 3; ++i) {
+    auto& pkt = uut.front();
+    CAF_CHECK_EQUAL(pkt.id(), i);
+    CAF_CHECK_EQUAL(pkt.size(), static_cast<size_t>(i) + 10);
+    CAF_REQUIRE_EQUAL(pkt.buffers().size(), 2u);
+    CAF_CHECK(pkt.buffer_ptrs()[0] == &pkt.buffers()[0]);
+    CAF_CHECK(pkt.buffer_ptrs()[1] == &pkt.buffers()[1]);
+    uut.pop_front();
+  }
+  CAF_CHECK(uut.empty());
+}
+
+CAF_TEST(the queue takes buffers without copying them) {
+  push(5);
+  CAF_CHECK(uut.front().buffers()[0].data() == hdr_data.front());
+}
+
+CAF_TEST(steady state traffic does not grow the queue) {
+  for (int i = 1; i <= 4; ++i)
+    push(i);
+  auto capacity = uut.capacity();
+  CAF_CHECK_EQUAL(capacity, packet_queue<int>::initial_capacity);
+  // Wrap around the ring a few times while keeping the queue half full.
+  for (int i = 5; i <= 100; ++i) {
+    CAF_CHECK_EQUAL(uut.front().id(), i - 4);
+    uut.pop_front();
+    push(i);
+  }
+  CAF_CHECK_EQUAL(uut.capacity(), capacity);
+  CAF_CHECK_EQUAL(uut.size(), 4u);
+  for (size_t i = 0; i < uut.size(); ++i)
+    CAF_CHECK_EQUAL(uut[i].id(), 97 + static_cast<int>(i));
+}
+
+CAF_TEST(growing preserves order and buffer pointers) {
+  // Shift the first element to force wrapping around before growing.
+  push(1);
+  uut.pop_front();
+  auto n = static_cast<int>(packet_queue<int>::initial_capacity) + 1;
+  for (int i = 1; i <= n; ++i)
+    push(i);
+  CAF_CHECK_EQUAL(uut.capacity(), 2 * packet_queue<int>::initial_capacity);
+  for (int i = 1; i <= n; ++i) {
+    auto& pkt = uut.front();
+    CAF_CHECK_EQUAL(pkt.id(), i);
+    CAF_CHECK(pkt.buffers()[0].data() == hdr_data[static_cast<size_t>(i)]);
+    CAF_CHECK(pkt.buffer_ptrs()[0] == &pkt.buffers()[0]);
+    uut.pop_front();
+  }
+}
+
+CAF_TEST(packets with too many buffers leave the queue unchanged) {
+  std::vector<byte_buffer> bufs(packet_queue<int>::max_buffers + 1,
+                                byte_buffer(1, byte{1}));
+  std::vector<byte_buffer*> ptrs;
+  for (auto& buf : bufs)
+    ptrs.emplace_back(&buf);
+  CAF_CHECK(!uut.push_back(1, make_span(ptrs)));
+  CAF_CHECK(uut.empty());
+  CAF_CHECK_EQUAL(bufs.back().size(), 1u);
+  ptrs.pop_back();
+  CAF_CHECK(uut.push_back(2, make_span(ptrs)));
+  CAF_REQUIRE_EQUAL(uut.size(), 1u);
+  CAF_CHECK_EQUAL(uut.front().buffers().size(), packet_queue<int>::max_buffers);
+  CAF_CHECK_EQUAL(uut.front().size(), packet_queue<int>::max_buffers);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
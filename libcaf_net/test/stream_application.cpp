@@ -23,6 +23,7 @@
 #include "caf/net/test/host_fixture.hpp"
 #include "caf/test/dsl.hpp"
 
+#include <random>
 #include <vector>
 
 #include "caf/byte_buffer.hpp"
@@ -30,6 +31,7 @@
 #include "caf/net/basp/connection_state.hpp"
 #include "caf/net/basp/constants.hpp"
 #include "caf/net/basp/ec.hpp"
+#include "caf/net/compression.hpp"
 #include "caf/net/make_endpoint_manager.hpp"
 #include "caf/net/middleman.hpp"
 #include "caf/net/multiplexer.hpp"
@@ -57,6 +59,9 @@ size_t fetch_size(variant<size_t, sec> x) {
 struct config : actor_system_config {
   config() {
     put(content, "middleman.this-node", unbox(make_uri("test:earth")));
+    // Stop adding messages to a batch after the first two.
+    put(content, "middleman.basp-max-batch-size", size_t{1});
+    put(content, "middleman.basp-compression-threshold", size_t{1000});
     load<middleman, backend::test>();
   }
 };
@@ -93,10 +98,11 @@ struct fixture : host_fixture, test_coordinator_fixture<config> {
     run();
   }
 
-  void handle_handshake() {
+  void handle_handshake(uint64_t capabilities = 0) {
     CAF_CHECK_EQUAL(app->state(),
                     basp::connection_state::await_handshake_header);
-    auto payload = to_buf(mars, basp::application::default_app_ids());
+    auto payload = to_buf(mars, basp::application::default_app_ids(),
+                          capabilities);
     mock(basp::header{basp::message_type::handshake,
                       static_cast<uint32_t>(payload.size()), basp::version});
     CAF_CHECK_EQUAL(app->state(),
@@ -118,13 +124,50 @@ struct fixture : host_fixture, test_coordinator_fixture<config> {
       CAF_FAIL("unable to read " << hdr.payload_len << " bytes");
     node_id nid;
     std::vector<std::string> app_ids;
+    uint64_t capabilities = 0;
     binary_deserializer source{sys, buf};
-    if (auto err = source(nid, app_ids))
+    if (auto err = source(nid, app_ids, capabilities))
       CAF_FAIL("unable to deserialize payload: " << err);
+    CAF_CHECK_EQUAL(capabilities, basp::batch_capability
+                                    | basp::compression_capability
+                                    | basp::interning_capability
+                                    | basp::heartbeat_capability);
     if (source.remaining() > 0)
       CAF_FAIL("trailing bytes after reading payload");
   }
 
+  /// Reads the next frame from the socket.
+  basp::header read_frame(byte_buffer& payload) {
+    payload.resize(basp::header_size);
+    if (fetch_size(read(sock, payload)) != basp::header_size)
+      CAF_FAIL("unable to read " << basp::header_size << " bytes");
+    auto hdr = basp::header::from_bytes(payload);
+    payload.resize(hdr.payload_len);
+    if (hdr.payload_len > 0
+        && fetch_size(read(sock, payload)) != size_t{hdr.payload_len})
+      CAF_FAIL("unable to read " << hdr.payload_len << " bytes");
+    return hdr;
+  }
+
+  /// Checks that `payload` contains an actor message from `self` with the
+  /// content `str`.
+  void check_actor_message(const byte_buffer& payload, const std::string& str) {
+    binary_deserializer source{sys, payload};
+    node_id src_node;
+    actor_id src_id = 0;
+    actor_id dst_id = 0;
+    std::vector<strong_actor_ptr> stages;
+    message content;
+    if (auto err = source(src_node, src_id, dst_id, stages, content))
+      CAF_FAIL("unable to read an actor message: " << err);
+    CAF_CHECK_EQUAL(source.remaining(), 0u);
+    CAF_CHECK_EQUAL(src_id, self->id());
+    if (content.match_elements<std::string>())
+      CAF_CHECK(content.get_as<std::string>(0) == str);
+    else
+      CAF_ERROR("expected a string, got: " << to_string(content));
+  }
+
   actor_system& system() {
     return sys;
   }
@@ -230,4 +273,118 @@ CAF_TEST(resolve request on id with result) {
   CAF_CHECK(ifs.empty());
 }
 
+CAF_TEST(peers with batch capability receive batch frames) {
+  handle_handshake(basp::batch_capability);
+  consume_handshake();
+  CAF_CHECK_EQUAL(app->capabilities(), basp::batch_capability);
+  auto& mm = sys.network_manager();
+  auto mgr = mm.backend("test")->peer(mars);
+  auto proxy = mm.backend("test")->make_proxy(mars, actor_id{42});
+  CAF_MESSAGE("queue four messages, one of them without receiver");
+  auto enqueue = [&](std::string str, strong_actor_ptr receiver) {
+    mgr->enqueue(make_mailbox_element(actor_cast<strong_actor_ptr>(self),
+                                      make_message_id(), {}, std::move(str)),
+                 std::move(receiver));
+  };
+  enqueue("a", proxy);
+  enqueue("lost", nullptr);
+  enqueue("b", proxy);
+  enqueue("c", proxy);
+  run();
+  // Creating the proxy makes the application monitor the remote actor.
+  RECEIVE(basp::message_type::monitor_message, 42u, no_payload);
+  auto receive_batch = [&](std::vector<std::string> expected) {
+    byte_buffer buf(basp::header_size);
+    if (fetch_size(read(sock, buf)) != basp::header_size)
+      CAF_FAIL("unable to read " << basp::header_size << " bytes");
+    auto hdr = basp::header::from_bytes(buf);
+    CAF_CHECK_EQUAL(hdr.type, basp::message_type::actor_message_batch);
+    CAF_CHECK_EQUAL(hdr.operation_data, expected.size());
+    buf.resize(hdr.payload_len);
+    if (fetch_size(read(sock, buf)) != size_t{hdr.payload_len})
+      CAF_FAIL("unable to read " << hdr.payload_len << " bytes");
+    binary_deserializer source{sys, buf};
+    for (auto& str : expected) {
+      uint32_t size = 0;
+      uint64_t mid = 0;
+      if (auto err = source(size, mid))
+        CAF_FAIL("unable to read an entry header: " << err);
+      CAF_CHECK_EQUAL(mid, make_message_id().integer_value());
+      auto remaining = source.remaining();
+      node_id src_node;
+      actor_id src_id = 0;
+      actor_id dst_id = 0;
+      std::vector<strong_actor_ptr> stages;
+      message content;
+      if (auto err = source(src_node, src_id, dst_id, stages, content))
+        CAF_FAIL("unable to read an entry: " << err);
+      CAF_CHECK_EQUAL(remaining - source.remaining(), size);
+      CAF_CHECK_EQUAL(src_node, sys.node());
+      CAF_CHECK_EQUAL(src_id, self->id());
+      CAF_CHECK_EQUAL(dst_id, 42u);
+      if (content.match_elements<std::string>())
+        CAF_CHECK_EQUAL(content.get_as<std::string>(0), str);
+      else
+        CAF_ERROR("expected a string, got: " << to_string(content));
+    }
+    CAF_CHECK_EQUAL(source.remaining(), 0u);
+  };
+  CAF_MESSAGE("the first batch skips the message without receiver");
+  receive_batch({"a"});
+  CAF_MESSAGE("basp-max-batch-size limits the size of each batch");
+  receive_batch({"b", "c"});
+}
+
+CAF_TEST(peers with compression capability receive compressed frames) {
+  handle_handshake(basp::compression_capability);
+  consume_handshake();
+  CAF_CHECK_EQUAL(app->capabilities(), basp::compression_capability);
+  auto proxy = sys.network_manager().backend("test")->make_proxy(mars,
+                                                                 actor_id{42});
+  run();
+  RECEIVE(basp::message_type::monitor_message, 42u, no_payload);
+  auto& stats = app->compression_statistics();
+  byte_buffer payload;
+  CAF_MESSAGE("messages below the threshold remain uncompressed");
+  self->send(actor_cast<actor>(proxy), std::string(100, 'a'));
+  run();
+  auto hdr = read_frame(payload);
+  CAF_CHECK_EQUAL(hdr.type, basp::message_type::actor_message);
+  check_actor_message(payload, std::string(100, 'a'));
+  CAF_CHECK_EQUAL(stats.compressed_messages, 0u);
+  CAF_MESSAGE("compressible messages above the threshold get compressed");
+  self->send(actor_cast<actor>(proxy), std::string(2000, 'a'));
+  run();
+  hdr = read_frame(payload);
+  CAF_CHECK_EQUAL(hdr.type, basp::message_type::compressed_message);
+  CAF_REQUIRE_GREATER_OR_EQUAL(payload.size(), basp::header_size);
+  auto inner_hdr = basp::header::from_bytes(payload);
+  CAF_CHECK_EQUAL(inner_hdr.type, basp::message_type::actor_message);
+  CAF_CHECK_EQUAL(inner_hdr.operation_data, make_message_id().integer_value());
+  byte_buffer decompressed;
+  auto compressed = make_span(payload.data() + basp::header_size,
+                              payload.size() - basp::header_size);
+  CAF_REQUIRE_EQUAL(decompress(compressed, inner_hdr.payload_len,
+                               decompressed),
+                    none);
+  check_actor_message(decompressed, std::string(2000, 'a'));
+  CAF_CHECK_EQUAL(stats.compressed_messages, 1u);
+  CAF_CHECK_EQUAL(stats.uncompressed_bytes, decompressed.size());
+  CAF_CHECK_EQUAL(stats.compressed_bytes, compressed.size());
+  CAF_CHECK_LESS(stats.compressed_bytes, stats.uncompressed_bytes);
+  CAF_MESSAGE("messages that do not shrink go out uncompressed");
+  std::minstd_rand rng{42};
+  std::uniform_int_distribution<int> dist{0, 255};
+  std::string noise;
+  for (size_t i = 0; i < 2000; ++i)
+    noise += static_cast<char>(dist(rng));
+  self->send(actor_cast<actor>(proxy), noise);
+  run();
+  hdr = read_frame(payload);
+  CAF_CHECK_EQUAL(hdr.type, basp::message_type::actor_message);
+  check_actor_message(payload, noise);
+  CAF_CHECK_EQUAL(stats.compressed_messages, 1u);
+  CAF_CHECK_EQUAL(stats.uncompressed_bytes, decompressed.size());
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
@@ -23,6 +23,8 @@
 #include "caf/net/test/host_fixture.hpp"
 #include "caf/test/dsl.hpp"
 
+#include <vector>
+
 #include "caf/byte.hpp"
 #include "caf/byte_buffer.hpp"
 #include "caf/span.hpp"
@@ -113,4 +115,21 @@ CAF_TEST(transfer data using multiple buffers) {
   CAF_CHECK(std::equal(full_buf.begin(), full_buf.end(), rd_buf.begin()));
 }
 
+CAF_TEST(transfer data using a gather write with many buffers) {
+  std::vector<byte_buffer> bufs;
+  std::vector<span<const byte>> spans;
+  byte_buffer full_buf;
+  for (size_t i = 0; i < 20; ++i) {
+    bufs.emplace_back(3, static_cast<byte>(i));
+    full_buf.insert(full_buf.end(), bufs.back().begin(), bufs.back().end());
+  }
+  for (auto& buf : bufs)
+    spans.emplace_back(buf);
+  CAF_REQUIRE(spans.size() <= max_write_buffers);
+  CAF_CHECK_EQUAL(write(second, span<const span<const byte>>{spans}),
+                  full_buf.size());
+  CAF_CHECK_EQUAL(read(first, rd_buf), full_buf.size());
+  CAF_CHECK(std::equal(full_buf.begin(), full_buf.end(), rd_buf.begin()));
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
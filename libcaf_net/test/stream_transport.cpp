@@ -23,6 +23,11 @@
 #include "caf/net/test/host_fixture.hpp"
 #include "caf/test/dsl.hpp"
 
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "caf/binary_deserializer.hpp"
 #include "caf/binary_serializer.hpp"
 #include "caf/byte.hpp"
@@ -30,13 +35,17 @@
 #include "caf/detail/scope_guard.hpp"
 #include "caf/make_actor.hpp"
 #include "caf/net/actor_proxy_impl.hpp"
+#include "caf/net/buffer_pool.hpp"
 #include "caf/net/endpoint_manager.hpp"
 #include "caf/net/endpoint_manager_impl.hpp"
 #include "caf/net/make_endpoint_manager.hpp"
 #include "caf/net/multiplexer.hpp"
 #include "caf/net/socket_guard.hpp"
 #include "caf/net/stream_socket.hpp"
+#include "caf/net/tcp_accept_socket.hpp"
+#include "caf/net/tcp_stream_socket.hpp"
 #include "caf/span.hpp"
+#include "caf/uri.hpp"
 
 using namespace caf;
 using namespace caf::net;
@@ -64,6 +73,32 @@ struct fixture : test_coordinator_fixture<>, host_fixture {
     return mpx->poll_once(false);
   }
 
+  /// Runs `f` once with the default backend and once with io_uring, each
+  /// time with a fresh multiplexer and a fresh pair of sockets.
+  template <class F>
+  void for_each_backend(F f) {
+    std::vector<multiplexer::backend_type> backends{
+      multiplexer::default_backend};
+#ifdef CAF_LINUX
+    backends.emplace_back(multiplexer::backend_type::io_uring);
+#endif // CAF_LINUX
+    for (auto backend : backends) {
+      mpx = std::make_shared<multiplexer>(backend);
+      if (auto err = mpx->init())
+        CAF_FAIL("mpx->init failed: " << err);
+      mpx->set_thread_id();
+      CAF_MESSAGE("run with backend " << static_cast<int>(mpx->backend()));
+      auto sockets = unbox(make_stream_socket_pair());
+      send_socket_guard.reset(sockets.first);
+      recv_socket_guard.reset(sockets.second);
+      if (auto err = nonblocking(recv_socket_guard.socket(), true))
+        CAF_FAIL("nonblocking returned an error: " << err);
+      shared_buf->clear();
+      f();
+      run();
+    }
+  }
+
   multiplexer_ptr mpx;
   byte_buffer recv_buf;
   socket_guard<stream_socket> send_socket_guard;
@@ -137,10 +172,40 @@ public:
     // nop
   }
 
-private:
+protected:
   byte_buffer_ptr rec_buf_;
 };
 
+class appending_application : public dummy_application {
+public:
+  using dummy_application::dummy_application;
+
+  template <class Parent>
+  error handle_data(Parent&, span<const byte> data) {
+    rec_buf_->insert(rec_buf_->end(), data.begin(), data.end());
+    return none;
+  }
+};
+
+class handoff_application : public dummy_application {
+  using byte_buffer_ptr = std::shared_ptr<byte_buffer>;
+
+public:
+  handoff_application(byte_buffer_ptr rec_buf, byte_buffer_ptr owned_buf)
+    : dummy_application(std::move(rec_buf)), owned_buf_(std::move(owned_buf)) {
+    // nop
+  }
+
+  template <class Parent>
+  error handle_owned_data(Parent&, byte_buffer& data) {
+    *owned_buf_ = std::move(data);
+    return none;
+  }
+
+private:
+  byte_buffer_ptr owned_buf_;
+};
+
 } // namespace
 
 CAF_TEST_FIXTURE_SCOPE(endpoint_manager_tests, fixture)
@@ -166,6 +231,74 @@ CAF_TEST(receive) {
                   hello_manager);
 }
 
+CAF_TEST(receive multiple messages with a single read) {
+  using transport_type = stream_transport<appending_application>;
+  auto mgr = make_endpoint_manager(
+    mpx, sys,
+    transport_type{recv_socket_guard.release(),
+                   appending_application{shared_buf}});
+  CAF_CHECK_EQUAL(mgr->init(), none);
+  auto mgr_impl = mgr.downcast<endpoint_manager_impl<transport_type>>();
+  CAF_CHECK(mgr_impl != nullptr);
+  auto& transport = mgr_impl->transport();
+  transport.configure_read(receive_policy::exactly(hello_manager.size()));
+  std::string expected;
+  for (int i = 0; i < 3; ++i)
+    expected.insert(expected.end(), hello_manager.begin(), hello_manager.end());
+  CAF_CHECK_EQUAL(write(send_socket_guard.socket(),
+                        as_bytes(make_span(expected))),
+                  expected.size());
+  run();
+  CAF_CHECK_EQUAL(string_view(reinterpret_cast<char*>(shared_buf->data()),
+                              shared_buf->size()),
+                  expected);
+}
+
+CAF_TEST(the receive buffer grows for bursts of messages) {
+  using transport_type = stream_transport<appending_application>;
+  auto mgr = make_endpoint_manager(
+    mpx, sys,
+    transport_type{recv_socket_guard.release(),
+                   appending_application{shared_buf}});
+  CAF_CHECK_EQUAL(mgr->init(), none);
+  auto mgr_impl = mgr.downcast<endpoint_manager_impl<transport_type>>();
+  auto& transport = mgr_impl->transport();
+  transport.configure_read(receive_policy::exactly(hello_manager.size()));
+  // Exceeds the initial size of the receive buffer several times.
+  std::string expected;
+  for (int i = 0; i < 1000; ++i)
+    expected.insert(expected.end(), hello_manager.begin(), hello_manager.end());
+  CAF_CHECK_EQUAL(write(send_socket_guard.socket(),
+                        as_bytes(make_span(expected))),
+                  expected.size());
+  run();
+  CAF_CHECK_EQUAL(string_view(reinterpret_cast<char*>(shared_buf->data()),
+                              shared_buf->size()),
+                  expected);
+}
+
+CAF_TEST(receive large messages into a separate buffer) {
+  using transport_type = stream_transport<handoff_application>;
+  auto owned_buf = std::make_shared<byte_buffer>();
+  auto mgr = make_endpoint_manager(
+    mpx, sys,
+    transport_type{recv_socket_guard.release(),
+                   handoff_application{shared_buf, owned_buf}});
+  CAF_CHECK_EQUAL(mgr->init(), none);
+  auto mgr_impl = mgr.downcast<endpoint_manager_impl<transport_type>>();
+  CAF_CHECK(mgr_impl != nullptr);
+  auto& transport = mgr_impl->transport();
+  byte_buffer data(defaults::middleman::stream_handoff_threshold);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<byte>(i);
+  transport.configure_read(receive_policy::exactly(data.size()));
+  CAF_CHECK_EQUAL(write(send_socket_guard.socket(), make_span(data)),
+                  data.size());
+  run();
+  CAF_CHECK_EQUAL(shared_buf->size(), 0u);
+  CAF_CHECK(*owned_buf == data);
+}
+
 CAF_TEST(resolve and proxy communication) {
   using transport_type = stream_transport<dummy_application>;
   auto mgr = make_endpoint_manager(
@@ -197,4 +330,303 @@ CAF_TEST(resolve and proxy communication) {
     CAF_ERROR("expected a string, got: " << to_string(msg));
 }
 
+CAF_TEST(short reads only deliver complete messages) {
+  using transport_type = stream_transport<dummy_application>;
+  for_each_backend([this] {
+    auto mgr = make_endpoint_manager(
+      mpx, sys,
+      transport_type{recv_socket_guard.release(),
+                     dummy_application{shared_buf}});
+    CAF_CHECK_EQUAL(mgr->init(), none);
+    auto mgr_impl = mgr.downcast<endpoint_manager_impl<transport_type>>();
+    auto& transport = mgr_impl->transport();
+    transport.configure_read(receive_policy::exactly(hello_manager.size()));
+    auto bytes = as_bytes(make_span(hello_manager));
+    auto half = bytes.size() / 2;
+    CAF_CHECK_EQUAL(write(send_socket_guard.socket(),
+                          make_span(bytes.data(), half)),
+                    half);
+    run();
+    CAF_CHECK_EQUAL(shared_buf->size(), 0u);
+    CAF_CHECK_EQUAL(write(send_socket_guard.socket(),
+                          make_span(bytes.data() + half, bytes.size() - half)),
+                    bytes.size() - half);
+    run();
+    CAF_CHECK_EQUAL(string_view(reinterpret_cast<char*>(shared_buf->data()),
+                                shared_buf->size()),
+                    hello_manager);
+  });
+}
+
+CAF_TEST(short writes keep the remaining bytes queued) {
+  using transport_type = stream_transport<dummy_application>;
+  for_each_backend([this] {
+    auto sock = send_socket_guard.release();
+    CAF_REQUIRE_EQUAL(nonblocking(sock, true), none);
+    CAF_REQUIRE_EQUAL(send_buffer_size(sock, 4096), none);
+    auto mgr = make_endpoint_manager(
+      mpx, sys, transport_type{sock, dummy_application{shared_buf}});
+    CAF_CHECK_EQUAL(mgr->init(), none);
+    auto mgr_impl = mgr.downcast<endpoint_manager_impl<transport_type>>();
+    auto& transport = mgr_impl->transport();
+    byte_buffer header(16, byte{0xFF});
+    byte_buffer payload(1024 * 1024);
+    for (size_t i = 0; i < payload.size(); ++i)
+      payload[i] = static_cast<byte>(i % 251);
+    byte_buffer expected = header;
+    expected.insert(expected.end(), payload.begin(), payload.end());
+    byte_buffer* bufs[] = {&header, &payload};
+    transport.write_packet(unit, make_span(bufs));
+    CAF_CHECK_EQUAL(transport.queued_bytes(), expected.size());
+    run();
+    // The socket can't take the entire packet at once.
+    CAF_CHECK_GREATER(transport.queued_bytes(), 0u);
+    CAF_CHECK_LESS(transport.queued_bytes(), expected.size());
+    byte_buffer received;
+    while (received.size() < expected.size()) {
+      auto res = read(recv_socket_guard.socket(), recv_buf);
+      if (auto num_bytes = get_if<size_t>(&res))
+        received.insert(received.end(), recv_buf.begin(),
+                        recv_buf.begin() + *num_bytes);
+      else
+        CAF_REQUIRE_EQUAL(get<sec>(res), sec::unavailable_or_would_block);
+      run();
+    }
+    CAF_CHECK_EQUAL(transport.queued_bytes(), 0u);
+    CAF_CHECK(received == expected);
+  });
+}
+
+CAF_TEST(partial writes carry the offset across queued buffers) {
+  using transport_type = stream_transport<dummy_application>;
+  for_each_backend([this] {
+    auto sock = send_socket_guard.release();
+    CAF_REQUIRE_EQUAL(nonblocking(sock, true), none);
+    CAF_REQUIRE_EQUAL(send_buffer_size(sock, 4096), none);
+    auto mgr = make_endpoint_manager(
+      mpx, sys, transport_type{sock, dummy_application{shared_buf}});
+    CAF_CHECK_EQUAL(mgr->init(), none);
+    auto mgr_impl = mgr.downcast<endpoint_manager_impl<transport_type>>();
+    auto& transport = mgr_impl->transport();
+    // A small first buffer makes partial writes end inside the second and
+    // later inside the third buffer.
+    constexpr size_t large_size = 4 * 1024 * 1024;
+    byte_buffer header(10, byte{0xFF});
+    byte_buffer first(large_size);
+    byte_buffer second(large_size);
+    for (size_t i = 0; i < large_size; ++i) {
+      first[i] = static_cast<byte>(i % 251);
+      second[i] = static_cast<byte>(i % 241);
+    }
+    byte_buffer expected = header;
+    expected.insert(expected.end(), first.begin(), first.end());
+    expected.insert(expected.end(), second.begin(), second.end());
+    byte_buffer* bufs[] = {&header, &first, &second};
+    transport.write_packet(unit, make_span(bufs));
+    run();
+    CAF_CHECK_GREATER(transport.queued_bytes(), large_size);
+    CAF_CHECK_LESS(transport.queued_bytes(), expected.size() - header.size());
+    byte_buffer received;
+    byte_buffer rd_buf(64 * 1024);
+    auto ended_in_third = false;
+    while (received.size() < expected.size()) {
+      auto res = read(recv_socket_guard.socket(), rd_buf);
+      if (auto num_bytes = get_if<size_t>(&res))
+        received.insert(received.end(), rd_buf.begin(),
+                        rd_buf.begin() + *num_bytes);
+      else
+        CAF_REQUIRE_EQUAL(get<sec>(res), sec::unavailable_or_would_block);
+      run();
+      auto queued = transport.queued_bytes();
+      if (queued > 0 && queued < large_size)
+        ended_in_third = true;
+    }
+    CAF_CHECK(ended_in_third);
+    CAF_CHECK_EQUAL(transport.queued_bytes(), 0u);
+    CAF_CHECK(received == expected);
+  });
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+namespace {
+
+struct watermark_config : actor_system_config {
+  watermark_config() {
+    put(content, "middleman.write-queue-high-watermark", size_t{1000});
+    put(content, "middleman.write-queue-low-watermark", size_t{400});
+  }
+};
+
+struct watermark_fixture : test_coordinator_fixture<watermark_config>,
+                           host_fixture {
+  watermark_fixture() : shared_buf(std::make_shared<byte_buffer>()) {
+    mpx = std::make_shared<multiplexer>();
+    if (auto err = mpx->init())
+      CAF_FAIL("mpx->init failed: " << err);
+    mpx->set_thread_id();
+    auto sockets = unbox(make_stream_socket_pair());
+    send_socket_guard.reset(sockets.first);
+    recv_socket_guard.reset(sockets.second);
+  }
+
+  bool handle_io_event() override {
+    return mpx->poll_once(false);
+  }
+
+  multiplexer_ptr mpx;
+  socket_guard<stream_socket> send_socket_guard;
+  socket_guard<stream_socket> recv_socket_guard;
+  std::shared_ptr<byte_buffer> shared_buf;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(watermark_tests, watermark_fixture)
+
+CAF_TEST(the overload signal has a hysteresis between the watermarks) {
+  using transport_type = stream_transport<dummy_application>;
+  auto mgr = make_endpoint_manager(
+    mpx, sys,
+    transport_type{send_socket_guard.release(), dummy_application{shared_buf}});
+  CAF_CHECK_EQUAL(mgr->init(), none);
+  auto mgr_impl = mgr.downcast<endpoint_manager_impl<transport_type>>();
+  auto& transport = mgr_impl->transport();
+  auto enqueue = [&](size_t header_size, std::vector<size_t> payload_sizes) {
+    std::vector<byte_buffer> storage;
+    storage.emplace_back(header_size, byte{1});
+    for (auto payload_size : payload_sizes)
+      storage.emplace_back(payload_size, byte{2});
+    std::vector<byte_buffer*> bufs;
+    for (auto& buf : storage)
+      bufs.emplace_back(&buf);
+    transport.write_packet(unit, make_span(bufs));
+  };
+  // Reporting completed writes directly to the transport makes the number of
+  // queued bytes independent of the capacity of the socket.
+  auto complete = [&](size_t num_bytes) {
+    transport.handle_write_completion(*mgr_impl, num_bytes);
+  };
+  CAF_MESSAGE("reaching the high watermark sets the overload signal");
+  enqueue(100, {500, 400});
+  complete(0);
+  CAF_CHECK_EQUAL(transport.queued_bytes(), 1000u);
+  CAF_CHECK(mgr->overloaded());
+  CAF_MESSAGE("the signal remains set above the low watermark");
+  complete(100);
+  CAF_CHECK_EQUAL(transport.queued_bytes(), 900u);
+  CAF_CHECK(mgr->overloaded());
+  CAF_MESSAGE("reaching the low watermark clears the signal");
+  complete(500);
+  CAF_CHECK_EQUAL(transport.queued_bytes(), 400u);
+  CAF_CHECK(!mgr->overloaded());
+  CAF_MESSAGE("the signal remains cleared below the high watermark");
+  enqueue(100, {400});
+  complete(0);
+  CAF_CHECK_EQUAL(transport.queued_bytes(), 900u);
+  CAF_CHECK(!mgr->overloaded());
+  complete(900);
+  CAF_CHECK_EQUAL(transport.queued_bytes(), 0u);
+  CAF_CHECK(!mgr->overloaded());
+}
+
 CAF_TEST_FIXTURE_SCOPE_END()
+
+#ifdef CAF_LINUX
+
+namespace {
+
+struct zerocopy_config : actor_system_config {
+  zerocopy_config() {
+    put(content, "middleman.zerocopy-threshold", size_t{1024});
+  }
+};
+
+struct zerocopy_fixture : test_coordinator_fixture<zerocopy_config>,
+                          host_fixture {
+  zerocopy_fixture() : shared_buf(std::make_shared<byte_buffer>()) {
+    mpx = std::make_shared<multiplexer>();
+    if (auto err = mpx->init())
+      CAF_FAIL("mpx->init failed: " << err);
+    mpx->set_thread_id();
+    uri::authority_type auth;
+    auth.host = std::string{"localhost"};
+    auth.port = 0;
+    auto acceptor = unbox(make_tcp_accept_socket(auth, false));
+    auto acceptor_guard = make_socket_guard(acceptor);
+    auth.port = unbox(local_port(acceptor));
+    send_socket_guard.reset(unbox(make_connected_tcp_stream_socket(auth)));
+    recv_socket_guard.reset(unbox(accept(acceptor)));
+  }
+
+  bool handle_io_event() override {
+    return mpx->poll_once(false);
+  }
+
+  static size_t recycled_buffers() {
+    auto stats = buffer_pool::instance().statistics();
+    return stats.released + stats.discarded;
+  }
+
+  multiplexer_ptr mpx;
+  socket_guard<tcp_stream_socket> send_socket_guard;
+  socket_guard<tcp_stream_socket> recv_socket_guard;
+  std::shared_ptr<byte_buffer> shared_buf;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(zerocopy_tests, zerocopy_fixture)
+
+CAF_TEST(zero-copy buffers return to the pool only after completion) {
+  using transport_type = stream_transport<dummy_application>;
+  if (auto err = zerocopy(send_socket_guard.socket(), true)) {
+    CAF_MESSAGE("kernel does not support zero-copy writes: " << err);
+    return;
+  }
+  auto sock = send_socket_guard.release();
+  CAF_REQUIRE_EQUAL(nonblocking(sock, true), none);
+  CAF_REQUIRE_EQUAL(send_buffer_size(sock, 1024 * 1024), none);
+  auto mgr = make_endpoint_manager(
+    mpx, sys, transport_type{sock, dummy_application{shared_buf}});
+  CAF_CHECK_EQUAL(mgr->init(), none);
+  auto mgr_impl = mgr.downcast<endpoint_manager_impl<transport_type>>();
+  auto& transport = mgr_impl->transport();
+  CAF_REQUIRE(transport.zerocopy_enabled());
+  byte_buffer header(16, byte{0xFF});
+  byte_buffer payload(8192, byte{42});
+  byte_buffer* bufs[] = {&header, &payload};
+  transport.write_packet(unit, make_span(bufs));
+  auto before = recycled_buffers();
+  CAF_CHECK(transport.handle_write_event(*mgr_impl));
+  // The transport copied the header, but the kernel may still read from the
+  // payload.
+  CAF_CHECK_EQUAL(transport.queued_bytes(), 0u);
+  CAF_CHECK_EQUAL(transport.zerocopy_pending(), 1u);
+  CAF_CHECK_EQUAL(recycled_buffers(), before + 1);
+  byte_buffer rd_buf(header.size() + payload.size());
+  size_t received = 0;
+  while (received < rd_buf.size()) {
+    auto res = read(recv_socket_guard.socket(),
+                    make_span(rd_buf.data() + received,
+                              rd_buf.size() - received));
+    if (auto num_bytes = get_if<size_t>(&res))
+      received += *num_bytes;
+    else
+      CAF_FAIL("read failed: " << get<sec>(res));
+  }
+  for (int i = 0; i < 100 && transport.zerocopy_pending() > 0; ++i) {
+    run();
+    if (transport.zerocopy_pending() > 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  CAF_CHECK_EQUAL(transport.zerocopy_pending(), 0u);
+  CAF_CHECK_EQUAL(recycled_buffers(), before + 2);
+  // The kernel always copies data that it sends over the loopback device,
+  // which makes zero-copy writes pointless.
+  CAF_CHECK(!transport.zerocopy_enabled());
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
+
+#endif // CAF_LINUX
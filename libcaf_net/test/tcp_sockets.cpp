@@ -24,7 +24,12 @@
 #include "caf/net/test/host_fixture.hpp"
 #include "caf/test/dsl.hpp"
 
+#include <chrono>
+#include <thread>
+
+#include "caf/byte_buffer.hpp"
 #include "caf/net/socket_guard.hpp"
+#include "caf/span.hpp"
 
 using namespace caf;
 using namespace caf::net;
@@ -76,4 +81,53 @@ CAF_TEST(tcp connect) {
   CAF_MESSAGE("connected");
 }
 
+#ifdef CAF_LINUX
+
+CAF_TEST(zero-copy writes report their completion) {
+  auto acceptor = unbox(make_tcp_accept_socket(auth, false));
+  auto acceptor_guard = make_socket_guard(acceptor);
+  uri::authority_type dst;
+  dst.port = unbox(local_port(acceptor));
+  dst.host = "localhost"_s;
+  auto conn = unbox(make_connected_tcp_stream_socket(dst));
+  auto conn_guard = make_socket_guard(conn);
+  auto accepted = unbox(accept(acceptor));
+  auto accepted_guard = make_socket_guard(accepted);
+  if (auto err = zerocopy(conn, true)) {
+    CAF_MESSAGE("kernel does not support zero-copy writes: " << err);
+    return;
+  }
+  byte_buffer wr_buf(4096, byte{42});
+  CAF_CHECK_EQUAL(write_zerocopy(conn, wr_buf), wr_buf.size());
+  byte_buffer rd_buf(4096);
+  size_t received = 0;
+  while (received < wr_buf.size()) {
+    auto res = read(accepted, make_span(rd_buf.data() + received,
+                                        rd_buf.size() - received));
+    if (auto num_bytes = get_if<size_t>(&res))
+      received += *num_bytes;
+    else
+      CAF_FAIL("read failed: " << get<sec>(res));
+  }
+  CAF_CHECK(rd_buf == wr_buf);
+  uint32_t last_completed = 42;
+  bool copied = false;
+  size_t notifications = 0;
+  for (int i = 0; i < 100 && notifications == 0; ++i) {
+    auto res = read_zerocopy_completions(conn, last_completed, copied);
+    if (auto num_notifications = get_if<size_t>(&res))
+      notifications = *num_notifications;
+    else
+      CAF_FAIL("reading the error queue failed: " << get<sec>(res));
+    if (notifications == 0)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  CAF_CHECK_EQUAL(notifications, 1u);
+  CAF_CHECK_EQUAL(last_completed, 0u);
+  // The kernel always copies data that it sends over the loopback device.
+  CAF_CHECK(copied);
+}
+
+#endif // CAF_LINUX
+
 CAF_TEST_FIXTURE_SCOPE_END()
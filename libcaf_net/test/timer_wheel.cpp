@@ -0,0 +1,138 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2020 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+#define CAF_SUITE timer_wheel
+
+#include "caf/net/timer_wheel.hpp"
+
+#include "caf/test/dsl.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "caf/net/socket_manager.hpp"
+
+using namespace caf;
+using namespace caf::net;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct fixture {
+  fixture() : start(actor_clock::clock_type::now()), uut(start) {
+    // nop
+  }
+
+  std::vector<uint64_t> advance_to(timer_wheel::duration_type offset) {
+    std::vector<uint64_t> result;
+    expired.clear();
+    uut.advance(start + offset, expired);
+    for (auto& x : expired)
+      result.emplace_back(x.id);
+    return result;
+  }
+
+  actor_clock::time_point start;
+  timer_wheel uut;
+  timer_wheel::expired_list expired;
+};
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(timer_wheel_tests, fixture)
+
+CAF_TEST(an empty wheel has no poll timeout) {
+  CAF_CHECK(uut.empty());
+  CAF_CHECK_EQUAL(uut.poll_timeout(start), -1);
+  CAF_CHECK(advance_to(10s).empty());
+}
+
+CAF_TEST(timers fire once their deadline has passed) {
+  auto id = uut.add(start + 5ms, nullptr, "foo");
+  CAF_CHECK_NOT_EQUAL(id, 0u);
+  CAF_CHECK_EQUAL(uut.size(), 1u);
+  CAF_CHECK_EQUAL(uut.poll_timeout(start), 5);
+  CAF_CHECK(advance_to(4ms).empty());
+  CAF_CHECK_EQUAL(uut.poll_timeout(start + 4ms), 1);
+  CAF_CHECK_EQUAL(advance_to(5ms), std::vector<uint64_t>{id});
+  CAF_REQUIRE_EQUAL(expired.size(), 1u);
+  CAF_CHECK_EQUAL(expired.front().type, "foo");
+  CAF_CHECK(uut.empty());
+}
+
+CAF_TEST(timers in the past fire on the next tick) {
+  advance_to(10ms);
+  auto id = uut.add(start, nullptr, "foo");
+  CAF_CHECK_EQUAL(uut.poll_timeout(start + 10ms), 1);
+  CAF_CHECK(advance_to(10ms).empty());
+  CAF_CHECK_EQUAL(advance_to(11ms), std::vector<uint64_t>{id});
+}
+
+CAF_TEST(timers on higher levels cascade down) {
+  auto a = uut.add(start + 100ms, nullptr, "a");
+  auto b = uut.add(start + 5000ms, nullptr, "b");
+  auto c = uut.add(start + 300000ms, nullptr, "c");
+  auto d = uut.add(start + 20000000ms, nullptr, "d");
+  CAF_CHECK_EQUAL(uut.size(), 4u);
+  CAF_CHECK(advance_to(99ms).empty());
+  CAF_CHECK_EQUAL(advance_to(100ms), std::vector<uint64_t>{a});
+  CAF_CHECK(advance_to(4999ms).empty());
+  CAF_CHECK_EQUAL(advance_to(5000ms), std::vector<uint64_t>{b});
+  CAF_CHECK(advance_to(299999ms).empty());
+  CAF_CHECK_EQUAL(advance_to(300000ms), std::vector<uint64_t>{c});
+  CAF_CHECK(advance_to(19999999ms).empty());
+  CAF_CHECK_EQUAL(advance_to(20000000ms), std::vector<uint64_t>{d});
+  CAF_CHECK(uut.empty());
+}
+
+CAF_TEST(the poll timeout never exceeds the next deadline) {
+  uut.add(start + 4321ms, nullptr, "foo");
+  auto now = start;
+  for (;;) {
+    auto timeout = uut.poll_timeout(now);
+    CAF_REQUIRE_GREATER_OR_EQUAL(timeout, 0);
+    now += timer_wheel::duration_type{timeout};
+    CAF_REQUIRE(now <= start + 4321ms);
+    expired.clear();
+    if (uut.advance(now, expired) > 0)
+      break;
+  }
+  CAF_CHECK(now == start + 4321ms);
+}
+
+CAF_TEST(cancelled timers never fire) {
+  auto a = uut.add(start + 10ms, nullptr, "a");
+  auto b = uut.add(start + 10ms, nullptr, "b");
+  CAF_CHECK(uut.cancel(a));
+  CAF_CHECK(!uut.cancel(a));
+  CAF_CHECK_EQUAL(uut.size(), 1u);
+  CAF_CHECK_EQUAL(advance_to(10ms), std::vector<uint64_t>{b});
+  CAF_CHECK(!uut.cancel(b));
+}
+
+CAF_TEST(timer IDs remain unique when re-using storage) {
+  auto a = uut.add(start + 10ms, nullptr, "a");
+  CAF_CHECK(uut.cancel(a));
+  auto b = uut.add(start + 10ms, nullptr, "b");
+  CAF_CHECK_NOT_EQUAL(a, b);
+  CAF_CHECK(!uut.cancel(a));
+  CAF_CHECK_EQUAL(uut.size(), 1u);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()
@@ -23,6 +23,13 @@
 #include "caf/net/test/host_fixture.hpp"
 #include "caf/test/dsl.hpp"
 
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "caf/actor_clock.hpp"
 #include "caf/byte_buffer.hpp"
 #include "caf/ip_endpoint.hpp"
 #include "caf/make_actor.hpp"
@@ -117,6 +124,22 @@ private:
   uint8_t application_cnt_;
 };
 
+struct dummy_manager {
+  uint64_t set_timeout(actor_clock::time_point, std::string type) {
+    timeouts.emplace(++last_timeout_id, std::move(type));
+    return last_timeout_id;
+  }
+
+  void cancel_timeout(uint64_t id) {
+    timeouts.erase(id);
+    cancelled_timeouts.emplace_back(id);
+  }
+
+  uint64_t last_timeout_id = 0;
+  std::map<uint64_t, std::string> timeouts;
+  std::vector<uint64_t> cancelled_timeouts;
+};
+
 struct dummy_transport {
   using transport_type = dummy_transport;
 
@@ -143,6 +166,10 @@ struct dummy_transport {
     return *this;
   }
 
+  dummy_manager& manager() {
+    return mgr_;
+  }
+
   byte_buffer next_header_buffer() {
     return {};
   }
@@ -154,6 +181,7 @@ struct dummy_transport {
 private:
   actor_system& sys_;
   byte_buffer_ptr buf_;
+  dummy_manager mgr_;
 };
 
 struct testdata {
@@ -305,6 +333,112 @@ CAF_TEST(timeout) {
   CHECK_TIMEOUT(test_data.at(3));
 }
 
+CAF_TEST(the dispatcher finds workers after growing its table) {
+  CAF_CHECK_EQUAL(dispatcher.live_workers(), 4u);
+  auto addr = test_data.at(0).ep.address();
+  for (uint16_t port = 100; port < 200; ++port)
+    CAF_CHECK_EQUAL(dispatcher.handle_data(dummy, span<const byte>{},
+                                           ip_endpoint{addr, port}),
+                    none);
+  CAF_CHECK_EQUAL(dispatcher.live_workers(), 104u);
+  buf->clear();
+  for (uint16_t port = 100; port < 200; ++port)
+    CAF_CHECK_EQUAL(dispatcher.handle_data(dummy, span<const byte>{},
+                                           ip_endpoint{addr, port}),
+                    none);
+  CAF_CHECK_EQUAL(dispatcher.live_workers(), 104u);
+  CAF_CHECK_EQUAL(buf->size(), 100u);
+  buf->clear();
+  CHECK_HANDLE_DATA(test_data.at(3));
+}
+
+CAF_TEST(the dispatcher evicts idle workers) {
+  using clock_type = dispatcher_type::clock_type;
+  CAF_CHECK_GREATER(dispatcher.idle_timeout().count(), 0);
+  dispatcher.evict_idle_workers(dummy, clock_type::now());
+  CAF_CHECK_EQUAL(dispatcher.live_workers(), 4u);
+  CAF_CHECK_EQUAL(dispatcher.evicted_workers(), 0u);
+  dispatcher.evict_idle_workers(dummy, clock_type::now()
+                                         + dispatcher.idle_timeout()
+                                         + std::chrono::seconds{1});
+  CAF_CHECK_EQUAL(dispatcher.live_workers(), 0u);
+  CAF_CHECK_EQUAL(dispatcher.evicted_workers(), 4u);
+  // The next datagram from an evicted endpoint creates a new worker.
+  CAF_CHECK_EQUAL(
+    dispatcher.handle_data(dummy, span<const byte>{}, test_data.at(0).ep),
+    none);
+  CAF_CHECK_EQUAL(dispatcher.live_workers(), 1u);
+  CAF_CHECK_EQUAL(*buf, byte_buffer({byte{4}, byte{4}}));
+}
+
+CAF_TEST(evicting workers cancels their timeouts) {
+  using clock_type = dispatcher_type::clock_type;
+  auto& mgr = dummy.manager();
+  auto id = mgr.set_timeout(actor_clock::time_point{}, "dummy");
+  dispatcher.set_timeout(id, test_data.at(0).ep);
+  dispatcher.evict_idle_workers(dummy, clock_type::now()
+                                         + dispatcher.idle_timeout()
+                                         + std::chrono::seconds{1});
+  CAF_CHECK_EQUAL(mgr.cancelled_timeouts, std::vector<uint64_t>{id});
+  CAF_CHECK(mgr.timeouts.empty());
+  dispatcher.timeout(dummy, "dummy", id);
+  CAF_CHECK(buf->empty());
+}
+
+CAF_TEST(a periodic timeout drives the sweep for idle workers) {
+  auto& mgr = dummy.manager();
+  CAF_CHECK(mgr.timeouts.empty());
+  CAF_MESSAGE("the first datagram starts the periodic sweep");
+  CHECK_HANDLE_DATA(test_data.at(0));
+  CHECK_HANDLE_DATA(test_data.at(1));
+  CAF_REQUIRE_EQUAL(mgr.timeouts.size(), 1u);
+  auto sweep_id = mgr.timeouts.begin()->first;
+  CAF_CHECK_EQUAL(mgr.timeouts.begin()->second,
+                  dispatcher_type::sweep_timeout_tag);
+  CAF_MESSAGE("the timeout evicts idle workers and schedules the next sweep");
+  dispatcher.idle_timeout(std::chrono::microseconds{1});
+  std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  mgr.timeouts.erase(sweep_id);
+  dispatcher.timeout(dummy, dispatcher_type::sweep_timeout_tag, sweep_id);
+  CAF_CHECK_EQUAL(dispatcher.live_workers(), 0u);
+  CAF_CHECK_EQUAL(dispatcher.evicted_workers(), 4u);
+  CAF_REQUIRE_EQUAL(mgr.timeouts.size(), 1u);
+  CAF_CHECK_NOT_EQUAL(mgr.timeouts.begin()->first, sweep_id);
+  CAF_CHECK(buf->empty());
+}
+
+CAF_TEST(the dispatcher rejects workers with duplicate IDs) {
+  auto nid = make_node_id("http:other"_u);
+  CAF_CHECK(!dispatcher.add_new_worker(dummy, nid, test_data.at(0).ep));
+  CAF_CHECK_EQUAL(dispatcher.live_workers(), 4u);
+  CAF_CHECK(buf->empty());
+}
+
+CAF_TEST(only the first unknown node gets a worker without an address) {
+  testdata first{4, make_node_id("http:unknown"_u), ip_endpoint{}};
+  CHECK_WRITE_MESSAGE(first);
+  CAF_CHECK_EQUAL(dispatcher.live_workers(), 5u);
+  CAF_MESSAGE("the dispatcher drops messages to further unknown nodes");
+  testdata second{5, make_node_id("http:other"_u), ip_endpoint{}};
+  test_write_message(second);
+  CAF_CHECK_EQUAL(dispatcher.live_workers(), 5u);
+  CAF_CHECK(buf->empty());
+  CAF_MESSAGE("the dispatcher still reaches the first unknown node");
+  CHECK_WRITE_MESSAGE(first);
+}
+
+CAF_TEST(writing messages keeps workers alive) {
+  using clock_type = dispatcher_type::clock_type;
+  dispatcher.idle_timeout(std::chrono::milliseconds{200});
+  std::this_thread::sleep_for(std::chrono::milliseconds{120});
+  CHECK_WRITE_MESSAGE(test_data.at(0));
+  std::this_thread::sleep_for(std::chrono::milliseconds{120});
+  dispatcher.evict_idle_workers(dummy, clock_type::now());
+  CAF_CHECK_EQUAL(dispatcher.live_workers(), 1u);
+  CAF_CHECK_EQUAL(dispatcher.evicted_workers(), 3u);
+  CHECK_WRITE_MESSAGE(test_data.at(0));
+}
+
 CAF_TEST(handle_error) {
   dispatcher.handle_error(sec::unavailable_or_would_block);
   CAF_CHECK_EQUAL(buf->size(), 4u);
@@ -23,6 +23,8 @@
 #include "caf/net/test/host_fixture.hpp"
 #include "caf/test/dsl.hpp"
 
+#include <algorithm>
+
 #include "caf/binary_serializer.hpp"
 #include "caf/byte_buffer.hpp"
 #include "caf/detail/net_syscall.hpp"
@@ -152,4 +154,119 @@ CAF_TEST(read / write using span<byte_buffer*>) {
   CAF_CHECK_EQUAL(received, hello_test);
 }
 
+CAF_TEST(writes reject datagrams with too many buffers) {
+  std::vector<byte_buffer> storage(max_datagram_buffers + 1,
+                                   byte_buffer(1, static_cast<byte>('a')));
+  std::vector<byte_buffer*> ptrs;
+  for (auto& buf : storage)
+    ptrs.emplace_back(&buf);
+  CAF_MESSAGE("up to max_datagram_buffers buffers form a single datagram");
+  auto bufs = make_span(ptrs.data(), max_datagram_buffers);
+  CAF_CHECK_EQUAL(write(send_socket, bufs, ep), max_datagram_buffers);
+  buf.resize(1024);
+  CAF_CHECK_EQUAL(read_from_socket(receive_socket, buf), none);
+  CAF_CHECK_EQUAL(buf.size(), max_datagram_buffers);
+  CAF_MESSAGE("one more buffer results in an error");
+  CAF_CHECK_EQUAL(write(send_socket, make_span(ptrs), ep),
+                  sec::invalid_argument);
+  outgoing_datagram dg{make_span(ptrs), ep};
+  CAF_CHECK_EQUAL(write(send_socket, span<const outgoing_datagram>{&dg, 1}),
+                  sec::invalid_argument);
+}
+
+CAF_TEST(batched read / write) {
+  if (auto err = nonblocking(socket_cast<net::socket>(receive_socket), true))
+    CAF_FAIL("setting socket to nonblocking failed: " << err);
+  std::vector<byte_buffer> payloads;
+  for (char c : {'a', 'b', 'c'})
+    payloads.emplace_back(static_cast<size_t>(c), static_cast<byte>(c));
+  std::vector<byte_buffer*> ptrs;
+  for (auto& payload : payloads)
+    ptrs.emplace_back(&payload);
+  std::vector<outgoing_datagram> datagrams;
+  for (auto& ptr : ptrs)
+    datagrams.emplace_back(outgoing_datagram{make_span(&ptr, 1), ep});
+  CAF_CHECK_EQUAL(write(send_socket,
+                        span<const outgoing_datagram>{datagrams}),
+                  datagrams.size());
+  std::vector<byte_buffer> bufs(4, byte_buffer(1024));
+  std::vector<span<byte>> spans;
+  for (auto& buf : bufs)
+    spans.emplace_back(buf);
+  std::vector<received_datagram> infos(bufs.size());
+  std::vector<byte_buffer> received;
+  for (size_t attempts = 0; received.size() < payloads.size(); ++attempts) {
+    if (attempts > 100)
+      CAF_FAIL("too many unavailable_or_would_blocks");
+    auto ret = read(receive_socket, make_span(spans), make_span(infos));
+    if (auto num_datagrams = get_if<size_t>(&ret)) {
+      for (size_t i = 0; i < *num_datagrams; ++i)
+        received.emplace_back(bufs[i].begin(),
+                              bufs[i].begin() + infos[i].size);
+    } else if (get<sec>(ret) != sec::unavailable_or_would_block) {
+      CAF_FAIL("read failed: " << get<sec>(ret));
+    }
+  }
+  CAF_CHECK_EQUAL(received, payloads);
+}
+
+#ifdef CAF_LINUX
+
+CAF_TEST(segmented writes and coalesced reads) {
+  if (auto err = nonblocking(socket_cast<net::socket>(receive_socket), true))
+    CAF_FAIL("setting socket to nonblocking failed: " << err);
+  if (auto err = gro(receive_socket, true)) {
+    CAF_MESSAGE("skip test: UDP_GRO unavailable: " << err);
+    return;
+  }
+  // Send three datagrams of 100 bytes and one of 50 bytes, scattered across
+  // buffers that do not align with datagram boundaries.
+  byte_buffer first(120);
+  byte_buffer second(230);
+  for (size_t i = 0; i < first.size(); ++i)
+    first[i] = static_cast<byte>(i / 100);
+  for (size_t i = 0; i < second.size(); ++i)
+    second[i] = static_cast<byte>((i + first.size()) / 100);
+  std::vector<byte_buffer*> ptrs{&first, &second};
+  auto ret = write_segmented(send_socket, ptrs, 100, ep);
+  if (holds_alternative<sec>(ret)) {
+    CAF_MESSAGE("skip test: UDP_SEGMENT unavailable: " << get<sec>(ret));
+    return;
+  }
+  CAF_CHECK_EQUAL(get<size_t>(ret), 350u);
+  // Split what we receive the same way the datagram transport does.
+  std::vector<byte_buffer> bufs(4, byte_buffer(65535));
+  std::vector<span<byte>> spans;
+  for (auto& buf : bufs)
+    spans.emplace_back(buf);
+  std::vector<received_datagram> infos(bufs.size());
+  std::vector<byte_buffer> received;
+  for (size_t attempts = 0; received.size() < 4; ++attempts) {
+    if (attempts > 100)
+      CAF_FAIL("too many unavailable_or_would_blocks");
+    auto res = read(receive_socket, make_span(spans), make_span(infos));
+    if (auto num_datagrams = get_if<size_t>(&res)) {
+      for (size_t i = 0; i < *num_datagrams; ++i) {
+        auto segment_size = infos[i].segment_size > 0 ? infos[i].segment_size
+                                                      : infos[i].size;
+        for (size_t pos = 0; pos < infos[i].size; pos += segment_size) {
+          auto n = std::min(segment_size, infos[i].size - pos);
+          received.emplace_back(bufs[i].begin() + pos,
+                                bufs[i].begin() + pos + n);
+        }
+      }
+    } else if (get<sec>(res) != sec::unavailable_or_would_block) {
+      CAF_FAIL("read failed: " << get<sec>(res));
+    }
+  }
+  CAF_REQUIRE_EQUAL(received.size(), 4u);
+  for (size_t i = 0; i < received.size(); ++i) {
+    CAF_CHECK_EQUAL(received[i].size(), i < 3 ? 100u : 50u);
+    CAF_CHECK(std::all_of(received[i].begin(), received[i].end(),
+                          [i](byte x) { return x == static_cast<byte>(i); }));
+  }
+}
+
+#endif // CAF_LINUX
+
 CAF_TEST_FIXTURE_SCOPE_END()
@@ -0,0 +1,180 @@
+/******************************************************************************
+ *                       ____    _    _____                                   *
+ *                      / ___|  / \  |  ___|    C++                           *
+ *                     | |     / _ \ | |_       Actor                         *
+ *                     | |___ / ___ \|  _|      Framework                     *
+ *                      \____/_/   \_|_|                                      *
+ *                                                                            *
+ * Copyright 2011-2019 Dominik Charousset                                     *
+ *                                                                            *
+ * Distributed under the terms and conditions of the BSD 3-Clause License or  *
+ * (at your option) under the terms and conditions of the Boost Software      *
+ * License 1.0. See accompanying files LICENSE and LICENSE_ALTERNATIVE.       *
+ *                                                                            *
+ * If you did not receive a copy of the license files, see                    *
+ * http://opensource.org/licenses/BSD-3-Clause and                            *
+ * http://www.boost.org/LICENSE_1_0.txt.                                      *
+ ******************************************************************************/
+
+
+#define CAF_SUITE uring
+
+#include "caf/net/uring.hpp"
+
+#include "caf/net/test/host_fixture.hpp"
+#include "caf/test/dsl.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include "caf/byte.hpp"
+#include "caf/byte_buffer.hpp"
+#include "caf/ip_endpoint.hpp"
+#include "caf/net/ip.hpp"
+#include "caf/net/stream_socket.hpp"
+#include "caf/net/udp_datagram_socket.hpp"
+#include "caf/span.hpp"
+
+#ifndef CAF_WINDOWS
+#  include <poll.h>
+#endif // CAF_WINDOWS
+
+using namespace caf;
+using namespace caf::net;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct fixture : host_fixture {
+  fixture() : rd_buf(64) {
+    std::tie(first, second) = unbox(make_stream_socket_pair());
+    CAF_REQUIRE_EQUAL(nonblocking(first, true), caf::none);
+    CAF_REQUIRE_EQUAL(nonblocking(second, true), caf::none);
+    if (auto err = uut.init())
+      CAF_MESSAGE("io_uring unavailable, skip test: " << err);
+  }
+
+  ~fixture() {
+    close(first);
+    close(second);
+  }
+
+  // Waits until the ring produced at least `n` completions.
+  void wait_for(size_t n) {
+    while (completions.size() < n) {
+      CAF_REQUIRE_EQUAL(uut.enter(1), 0);
+      uut.drain(completions);
+    }
+  }
+
+  uring uut;
+  stream_socket first;
+  stream_socket second;
+  byte_buffer rd_buf;
+  std::vector<uring::completion> completions;
+};
+
+span<const byte> as_span(const char* str) {
+  return make_span(reinterpret_cast<const byte*>(str), strlen(str));
+}
+
+} // namespace
+
+CAF_TEST_FIXTURE_SCOPE(uring_tests, fixture)
+
+CAF_TEST(reads complete once data arrives) {
+  if (!uut.valid())
+    return;
+  CAF_REQUIRE(uut.recv(1, second.id, rd_buf));
+  CAF_CHECK_EQUAL(uut.enter(0), 0);
+  CAF_CHECK_EQUAL(uut.drain(completions), 0u);
+  std::vector<span<const byte>> bufs{as_span("hello "), as_span("world")};
+  auto args = uut.sendmsg(2, first.id, span<const span<const byte>>{bufs});
+  CAF_REQUIRE(args != nullptr);
+  wait_for(2);
+  CAF_REQUIRE_EQUAL(completions.size(), 2u);
+  for (auto& cqe : completions) {
+    CAF_CHECK(cqe.user_data == 1 || cqe.user_data == 2);
+    CAF_CHECK_EQUAL(cqe.res, 11);
+  }
+  CAF_CHECK_EQUAL(memcmp(rd_buf.data(), "hello world", 11), 0);
+  CAF_CHECK_EQUAL(uut.pending(), 0u);
+}
+
+CAF_TEST(datagram reads report the sender) {
+  if (!uut.valid())
+    return;
+  auto addrs = ip::local_addresses("localhost");
+  CAF_REQUIRE(!addrs.empty());
+  ip_endpoint ep{addrs.front(), 0};
+  auto [a, a_port] = unbox(make_udp_datagram_socket(ep));
+  auto [b, b_port] = unbox(make_udp_datagram_socket(ep));
+  CAF_REQUIRE_EQUAL(nonblocking(b, true), caf::none);
+  auto rd_args = uut.recvmsg(1, b.id, rd_buf);
+  CAF_REQUIRE(rd_args != nullptr);
+  std::vector<span<const byte>> bufs{as_span("hello "), as_span("world")};
+  auto wr_args = uut.sendmsg(2, a.id, span<const span<const byte>>{bufs},
+                             ip_endpoint{addrs.front(), b_port});
+  CAF_REQUIRE(wr_args != nullptr);
+  wait_for(2);
+  for (auto& cqe : completions)
+    CAF_CHECK_EQUAL(cqe.res, 11);
+  received_datagram info;
+  CAF_CHECK_EQUAL(uring::datagram_info(*rd_args, 11, info), none);
+  CAF_CHECK_EQUAL(info.size, 11u);
+  CAF_CHECK_EQUAL(info.ep.port(), a_port);
+  CAF_CHECK_EQUAL(memcmp(rd_buf.data(), "hello world", 11), 0);
+  close(a);
+  close(b);
+}
+
+CAF_TEST(polls report readiness) {
+  if (!uut.valid())
+    return;
+  CAF_REQUIRE(uut.poll(1, first.id, POLLOUT));
+  wait_for(1);
+  CAF_CHECK_EQUAL(completions[0].user_data, 1u);
+  CAF_CHECK((completions[0].res & POLLOUT) != 0);
+}
+
+CAF_TEST(cancelling an operation completes it with ECANCELED) {
+  if (!uut.valid())
+    return;
+  CAF_REQUIRE(uut.recv(1, second.id, rd_buf));
+  CAF_REQUIRE(uut.cancel(2, 1));
+  wait_for(2);
+  for (auto& cqe : completions) {
+    if (cqe.user_data == 1)
+      CAF_CHECK_EQUAL(cqe.res, -ECANCELED);
+    else
+      CAF_CHECK_EQUAL(cqe.res, 0);
+  }
+}
+
+CAF_TEST(timeouts complete after the relative time or another completion) {
+  if (!uut.valid())
+    return;
+  auto start = std::chrono::steady_clock::now();
+  CAF_REQUIRE(uut.timeout(0, 10ms));
+  wait_for(1);
+  CAF_CHECK_EQUAL(completions[0].res, -ETIME);
+  CAF_CHECK(std::chrono::steady_clock::now() - start >= 10ms);
+  completions.clear();
+  CAF_REQUIRE(uut.timeout(0, 10s));
+  CAF_REQUIRE(uut.poll(1, first.id, POLLOUT));
+  wait_for(2);
+  CAF_CHECK(std::chrono::steady_clock::now() - start < 10s);
+}
+
+CAF_TEST(submitting more operations than the ring holds flushes the queue) {
+  if (!uut.valid())
+    return;
+  auto n = size_t{uring::default_entries} * 2;
+  for (size_t i = 0; i < n; ++i)
+    CAF_REQUIRE(uut.poll(i + 1, first.id, POLLOUT));
+  wait_for(n);
+  CAF_CHECK_EQUAL(completions.size(), n);
+}
+
+CAF_TEST_FIXTURE_SCOPE_END()